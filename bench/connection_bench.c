@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include "net_connection.h"
+#include "connection_mock.h"
+
+#define BENCH_ITERATIONS_DEFAULT 10000
+#define BENCH_HANDLES_MAX 256
+
+typedef int (*bench_fn)(void *data);
+
+struct bench_s {
+	FILE *output;
+	int iterations;
+	int latency;
+	int count;
+	int failures;
+};
+
+static struct bench_s bench = {NULL, BENCH_ITERATIONS_DEFAULT, 0, 0, 0};
+static volatile int fanout_count = 0;
+
+
+static guint64 __bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (guint64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int __bench_compare(const void *a, const void *b)
+{
+	guint64 x = *(const guint64 *)a;
+	guint64 y = *(const guint64 *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void __bench_run(const char *name, int iterations, bench_fn fn, void *data)
+{
+	guint64 *samples;
+	guint64 total = 0;
+	int failures = 0;
+	int i;
+
+	if (iterations < 1)
+		iterations = 1;
+
+	samples = g_new0(guint64, iterations);
+
+	/* Warm up caches and lazily created state outside the measurement */
+	fn(data);
+
+	for (i = 0; i < iterations; i++) {
+		guint64 start = __bench_now();
+
+		if (fn(data) != CONNECTION_ERROR_NONE)
+			failures++;
+
+		samples[i] = __bench_now() - start;
+		total += samples[i];
+	}
+
+	qsort(samples, iterations, sizeof(guint64), __bench_compare);
+
+	fprintf(bench.output, "%s\n    {\"name\": \"%s\", \"iterations\": %d, \"failures\": %d, "
+			"\"ops_per_sec\": %.1f, \"mean_ns\": %llu, \"p50_ns\": %llu, \"p90_ns\": %llu, "
+			"\"p99_ns\": %llu, \"max_ns\": %llu}",
+			bench.count > 0 ? "," : "", name, iterations, failures,
+			total > 0 ? iterations * 1e9 / total : 0.0,
+			(unsigned long long)(total / iterations),
+			(unsigned long long)samples[iterations * 50 / 100],
+			(unsigned long long)samples[iterations * 90 / 100],
+			(unsigned long long)samples[iterations * 99 / 100],
+			(unsigned long long)samples[iterations - 1]);
+
+	bench.count++;
+	if (failures)
+		bench.failures++;
+
+	g_free(samples);
+}
+
+static void __bench_setup(int wifi_count)
+{
+	char command[256];
+	int i;
+
+	connection_mock_reset();
+	connection_mock_set_latency(bench.latency);
+
+	connection_mock_run_command("profile wifi /wifi/home wlan0 online HomeAP 192.168.0.10 80");
+	connection_mock_run_command("profile cellular /context/internet pdp0 ready internet.apn internet 10.1.2.3");
+	connection_mock_run_command("profile ethernet /ethernet/eth0 eth0 idle");
+
+	for (i = 1; i < wifi_count; i++) {
+		snprintf(command, sizeof(command), "profile wifi /wifi/ap%d wlan0 idle AP%d", i, i);
+		connection_mock_run_command(command);
+	}
+
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_STATUS " 1");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_WIFI_STATE " 2");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_CELLULAR_STATE " 0");
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_IP " 192.168.0.10");
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_PROXY " proxy.example.com:8080");
+
+	connection_mock_dispatch_events();
+}
+
+/* Handle life cycle and state getters ***********************************************************/
+
+static int __bench_create_destroy(void *data)
+{
+	connection_h connection = NULL;
+	int rv;
+
+	rv = connection_create(&connection);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	return connection_destroy(connection);
+}
+
+static int __bench_get_type(void *connection)
+{
+	connection_type_e type;
+	return connection_get_type(connection, &type);
+}
+
+static int __bench_get_ip_address(void *connection)
+{
+	char *ip_address = NULL;
+	int rv = connection_get_ip_address(connection, CONNECTION_ADDRESS_FAMILY_IPV4, &ip_address);
+
+	free(ip_address);
+	return rv;
+}
+
+static int __bench_get_proxy(void *connection)
+{
+	char *proxy = NULL;
+	int rv = connection_get_proxy(connection, CONNECTION_ADDRESS_FAMILY_IPV4, &proxy);
+
+	free(proxy);
+	return rv;
+}
+
+static int __bench_get_cellular_state(void *connection)
+{
+	connection_cellular_state_e state;
+	return connection_get_cellular_state(connection, &state);
+}
+
+static int __bench_get_wifi_state(void *connection)
+{
+	connection_wifi_state_e state;
+	return connection_get_wifi_state(connection, &state);
+}
+
+static int __bench_get_ethernet_state(void *connection)
+{
+	connection_ethernet_state_e state;
+	return connection_get_ethernet_state(connection, &state);
+}
+
+static int __bench_get_current_profile(void *connection)
+{
+	connection_profile_h profile = NULL;
+	int rv = connection_get_current_profile(connection, &profile);
+
+	if (rv == CONNECTION_ERROR_NONE)
+		connection_profile_destroy(profile);
+
+	return rv;
+}
+
+static int __bench_iterate_profiles(void *connection)
+{
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile;
+	int rv;
+
+	rv = connection_get_profile_iterator(connection, CONNECTION_ITERATOR_TYPE_REGISTERED, &iterator);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	while (connection_profile_iterator_has_next(iterator))
+		if (connection_profile_iterator_next(iterator, &profile) != CONNECTION_ERROR_NONE)
+			break;
+
+	return connection_destroy_profile_iterator(iterator);
+}
+
+/* Profile accessors *****************************************************************************/
+
+#define BENCH_GETTER(getter, type, ...) \
+static int __bench_profile_##getter(void *profile) \
+{ \
+	type value; \
+	return connection_profile_##getter(profile, __VA_ARGS__ &value); \
+}
+
+#define BENCH_STRING_GETTER(getter, ...) \
+static int __bench_profile_##getter(void *profile) \
+{ \
+	char *value = NULL; \
+	int rv = connection_profile_##getter(profile, __VA_ARGS__ &value); \
+	free(value); \
+	return rv; \
+}
+
+BENCH_STRING_GETTER(get_name)
+BENCH_GETTER(get_type, connection_profile_type_e)
+BENCH_STRING_GETTER(get_network_interface_name)
+BENCH_GETTER(get_state, connection_profile_state_e)
+BENCH_GETTER(get_ip_config_type, connection_ip_config_type_e, CONNECTION_ADDRESS_FAMILY_IPV4,)
+BENCH_STRING_GETTER(get_ip_address, CONNECTION_ADDRESS_FAMILY_IPV4,)
+BENCH_STRING_GETTER(get_subnet_mask, CONNECTION_ADDRESS_FAMILY_IPV4,)
+BENCH_STRING_GETTER(get_gateway_address, CONNECTION_ADDRESS_FAMILY_IPV4,)
+BENCH_STRING_GETTER(get_dns_address, 1, CONNECTION_ADDRESS_FAMILY_IPV4,)
+BENCH_GETTER(get_proxy_type, connection_proxy_type_e)
+BENCH_STRING_GETTER(get_proxy_address, CONNECTION_ADDRESS_FAMILY_IPV4,)
+BENCH_STRING_GETTER(get_wifi_essid)
+BENCH_STRING_GETTER(get_wifi_bssid)
+BENCH_GETTER(get_wifi_rssi, int)
+BENCH_GETTER(get_wifi_frequency, int)
+BENCH_GETTER(get_wifi_max_speed, int)
+BENCH_GETTER(get_wifi_security_type, connection_wifi_security_type_e)
+BENCH_GETTER(get_wifi_encryption_type, connection_wifi_encryption_type_e)
+BENCH_GETTER(is_wifi_passphrase_required, bool)
+BENCH_GETTER(is_wifi_wps_supported, bool)
+BENCH_GETTER(get_cellular_network_type, connection_cellular_network_type_e)
+BENCH_GETTER(get_cellular_service_type, connection_cellular_service_type_e)
+BENCH_STRING_GETTER(get_cellular_apn)
+BENCH_STRING_GETTER(get_cellular_home_url)
+BENCH_GETTER(is_cellular_roaming, bool)
+
+static int __bench_profile_get_cellular_auth_info(void *profile)
+{
+	connection_cellular_auth_type_e type;
+	char *user_name = NULL;
+	char *password = NULL;
+	int rv = connection_profile_get_cellular_auth_info(profile, &type, &user_name, &password);
+
+	free(user_name);
+	free(password);
+	return rv;
+}
+
+struct bench_accessor_s {
+	const char *name;
+	bench_fn fn;
+};
+
+#define BENCH_ACCESSOR(getter) {"connection_profile_" #getter, __bench_profile_##getter}
+
+static const struct bench_accessor_s common_accessors[] = {
+	BENCH_ACCESSOR(get_name),
+	BENCH_ACCESSOR(get_type),
+	BENCH_ACCESSOR(get_network_interface_name),
+	BENCH_ACCESSOR(get_state),
+	BENCH_ACCESSOR(get_ip_config_type),
+	BENCH_ACCESSOR(get_ip_address),
+	BENCH_ACCESSOR(get_subnet_mask),
+	BENCH_ACCESSOR(get_gateway_address),
+	BENCH_ACCESSOR(get_dns_address),
+	BENCH_ACCESSOR(get_proxy_type),
+	BENCH_ACCESSOR(get_proxy_address),
+	{NULL, NULL},
+};
+
+static const struct bench_accessor_s wifi_accessors[] = {
+	BENCH_ACCESSOR(get_wifi_essid),
+	BENCH_ACCESSOR(get_wifi_bssid),
+	BENCH_ACCESSOR(get_wifi_rssi),
+	BENCH_ACCESSOR(get_wifi_frequency),
+	BENCH_ACCESSOR(get_wifi_max_speed),
+	BENCH_ACCESSOR(get_wifi_security_type),
+	BENCH_ACCESSOR(get_wifi_encryption_type),
+	BENCH_ACCESSOR(is_wifi_passphrase_required),
+	BENCH_ACCESSOR(is_wifi_wps_supported),
+	{NULL, NULL},
+};
+
+static const struct bench_accessor_s cellular_accessors[] = {
+	BENCH_ACCESSOR(get_cellular_network_type),
+	BENCH_ACCESSOR(get_cellular_service_type),
+	BENCH_ACCESSOR(get_cellular_apn),
+	BENCH_ACCESSOR(get_cellular_auth_info),
+	BENCH_ACCESSOR(get_cellular_home_url),
+	BENCH_ACCESSOR(is_cellular_roaming),
+	{NULL, NULL},
+};
+
+static void __bench_run_accessors(const struct bench_accessor_s *accessors, connection_profile_h profile)
+{
+	int i;
+
+	for (i = 0; accessors[i].name; i++)
+		__bench_run(accessors[i].name, bench.iterations, accessors[i].fn, profile);
+}
+
+static connection_profile_h __bench_find_profile(connection_h connection, connection_profile_type_e type)
+{
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile;
+	connection_profile_h found = NULL;
+	connection_profile_type_e profile_type;
+
+	if (connection_get_profile_iterator(connection, CONNECTION_ITERATOR_TYPE_REGISTERED,
+			&iterator) != CONNECTION_ERROR_NONE)
+		return NULL;
+
+	while (found == NULL && connection_profile_iterator_has_next(iterator)) {
+		if (connection_profile_iterator_next(iterator, &profile) != CONNECTION_ERROR_NONE)
+			break;
+
+		if (connection_profile_get_type(profile, &profile_type) == CONNECTION_ERROR_NONE &&
+		    profile_type == type)
+			connection_profile_clone(&found, profile);
+	}
+
+	connection_destroy_profile_iterator(iterator);
+
+	return found;
+}
+
+/* Callback fan-out ******************************************************************************/
+
+static void __bench_type_changed_cb(connection_type_e type, void *user_data)
+{
+	fanout_count++;
+}
+
+static int __bench_fanout(void *data)
+{
+	int handles = GPOINTER_TO_INT(data);
+	static int status = 1;
+
+	fanout_count = 0;
+	status = (status == 1) ? 2 : 1;
+
+	vconf_set_int(VCONFKEY_NETWORK_STATUS, status);
+	connection_mock_dispatch_events();
+
+	return fanout_count == handles ? CONNECTION_ERROR_NONE : CONNECTION_ERROR_OPERATION_FAILED;
+}
+
+static void __bench_run_fanout(int handles)
+{
+	connection_h connections[BENCH_HANDLES_MAX];
+	char name[64];
+	int i;
+
+	for (i = 0; i < handles; i++) {
+		connections[i] = NULL;
+		connection_create(&connections[i]);
+		connection_set_type_changed_cb(connections[i], __bench_type_changed_cb, NULL);
+	}
+
+	snprintf(name, sizeof(name), "type_changed_fanout_%d_handles", handles);
+	__bench_run(name, bench.iterations / 10, __bench_fanout, GINT_TO_POINTER(handles));
+
+	for (i = 0; i < handles; i++) {
+		connection_unset_type_changed_cb(connections[i]);
+		connection_destroy(connections[i]);
+	}
+}
+
+/* Main ******************************************************************************************/
+
+static void __bench_usage(const char *program)
+{
+	printf("Usage: %s [--iterations N] [--latency USEC] [--output FILE]\n", program);
+	printf("  --iterations N   Operations per benchmark (default %d)\n", BENCH_ITERATIONS_DEFAULT);
+	printf("  --latency USEC   Simulated latency of each network daemon call (default 0)\n");
+	printf("  --output FILE    Write the JSON results to FILE instead of stdout\n");
+}
+
+int main(int argc, char **argv)
+{
+	const int profile_counts[] = {1, 10, 100, 1000};
+	const int handle_counts[] = {1, 16, BENCH_HANDLES_MAX};
+	connection_h connection = NULL;
+	connection_profile_h profile;
+	const char *output = NULL;
+	char name[64];
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+			bench.iterations = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+			bench.latency = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else {
+			__bench_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (bench.iterations < 10) {
+		__bench_usage(argv[0]);
+		return 1;
+	}
+
+	bench.output = output ? fopen(output, "w") : stdout;
+	if (bench.output == NULL) {
+		fprintf(stderr, "Cannot open %s\n", output);
+		return 1;
+	}
+
+	fprintf(bench.output, "{\n  \"suite\": \"capi-network-connection\",\n  \"backend\": \"mock\",\n"
+			"  \"latency_us\": %d,\n  \"results\": [", bench.latency);
+
+	__bench_setup(1);
+
+	__bench_run("connection_create_destroy", bench.iterations, __bench_create_destroy, NULL);
+
+	connection_create(&connection);
+
+	__bench_run("connection_get_type", bench.iterations, __bench_get_type, connection);
+	__bench_run("connection_get_ip_address", bench.iterations, __bench_get_ip_address, connection);
+	__bench_run("connection_get_proxy", bench.iterations, __bench_get_proxy, connection);
+	__bench_run("connection_get_cellular_state", bench.iterations, __bench_get_cellular_state, connection);
+	__bench_run("connection_get_wifi_state", bench.iterations, __bench_get_wifi_state, connection);
+	__bench_run("connection_get_ethernet_state", bench.iterations, __bench_get_ethernet_state, connection);
+	__bench_run("connection_get_current_profile", bench.iterations, __bench_get_current_profile, connection);
+
+	profile = __bench_find_profile(connection, CONNECTION_PROFILE_TYPE_WIFI);
+	if (profile) {
+		__bench_run_accessors(common_accessors, profile);
+		__bench_run_accessors(wifi_accessors, profile);
+		connection_profile_destroy(profile);
+	}
+
+	profile = __bench_find_profile(connection, CONNECTION_PROFILE_TYPE_CELLULAR);
+	if (profile) {
+		__bench_run_accessors(cellular_accessors, profile);
+		connection_profile_destroy(profile);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS(profile_counts); i++) {
+		__bench_setup(profile_counts[i]);
+
+		/* Keep the number of profiles copied per benchmark roughly constant */
+		snprintf(name, sizeof(name), "profile_iteration_%d_profiles", profile_counts[i]);
+		__bench_run(name, MAX(bench.iterations / profile_counts[i], 10),
+				__bench_iterate_profiles, connection);
+	}
+
+	connection_destroy(connection);
+
+	__bench_setup(1);
+	for (i = 0; i < G_N_ELEMENTS(handle_counts); i++)
+		__bench_run_fanout(handle_counts[i]);
+
+	fprintf(bench.output, "\n  ]\n}\n");
+
+	if (output)
+		fclose(bench.output);
+
+	if (bench.failures) {
+		fprintf(stderr, "%d benchmark(s) had failing operations\n", bench.failures);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include "net_connection_private.h"
+#include "connection_mock.h"
+
+struct replay_event_s {
+	unsigned long long timestamp;
+	net_event_info_t event_info;
+};
+
+static struct {
+	double speed;
+	int repeat;
+	GArray *events;
+	GArray *dispatch_times;
+	GArray *callback_latencies;
+	gint64 delivery_start;
+	long long lag_max;
+} replay = {1.0, 1, NULL, NULL, NULL, 0, 0};
+
+
+static gint64 __replay_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (gint64)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int __replay_compare(const void *a, const void *b)
+{
+	gint64 x = *(const gint64 *)a;
+	gint64 y = *(const gint64 *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void __replay_print_percentiles(FILE *output, const char *name, GArray *samples)
+{
+	gint64 *values = (gint64 *)samples->data;
+	int count = samples->len;
+
+	if (count == 0) {
+		fprintf(output, "  \"%s\": null,\n", name);
+		return;
+	}
+
+	qsort(values, count, sizeof(gint64), __replay_compare);
+
+	fprintf(output, "  \"%s\": {\"p50_ns\": %lld, \"p90_ns\": %lld, \"p99_ns\": %lld, \"max_ns\": %lld},\n",
+			name, (long long)values[count * 50 / 100], (long long)values[count * 90 / 100],
+			(long long)values[count * 99 / 100], (long long)values[count - 1]);
+}
+
+static void __replay_state_changed_cb(connection_profile_h profile, bool is_requested, void *user_data)
+{
+	gint64 latency = __replay_now() - replay.delivery_start;
+
+	g_array_append_val(replay.callback_latencies, latency);
+}
+
+static int __replay_load(const char *path)
+{
+	struct replay_event_s event;
+	FILE *fp;
+	int rv;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Cannot open %s\n", path);
+		return -1;
+	}
+
+	if (_connection_capture_read_header(fp) != CONNECTION_ERROR_NONE) {
+		fprintf(stderr, "%s is not an event capture file\n", path);
+		fclose(fp);
+		return -1;
+	}
+
+	while ((rv = _connection_capture_read_event(fp, &event.timestamp, &event.event_info)) ==
+			CONNECTION_ERROR_NONE)
+		g_array_append_val(replay.events, event);
+
+	fclose(fp);
+
+	if (rv != CONNECTION_ERROR_ITERATOR_END)
+		fprintf(stderr, "%s is truncated, replaying %d events\n", path, replay.events->len);
+
+	return replay.events->len;
+}
+
+/* Stands in the profiles named by the log, so that profile callbacks can be registered */
+static void __replay_add_profiles(void)
+{
+	net_profile_info_t profile_info;
+	int i;
+
+	for (i = replay.events->len - 1; i >= 0; i--) {
+		net_event_info_t *event_info = &g_array_index(replay.events, struct replay_event_s, i).event_info;
+
+		if (event_info->ProfileName[0] == '\0')
+			continue;
+
+		if (event_info->Datalength == sizeof(net_profile_info_t)) {
+			memcpy(&profile_info, event_info->Data, sizeof(net_profile_info_t));
+		} else {
+			memset(&profile_info, 0, sizeof(net_profile_info_t));
+			profile_info.profile_type = NET_DEVICE_CELLULAR;
+			profile_info.ProfileState = NET_STATE_TYPE_IDLE;
+		}
+
+		g_strlcpy(profile_info.ProfileName, event_info->ProfileName, NET_PROFILE_NAME_LEN_MAX+1);
+
+		/* Walking backwards, the earliest payload of a profile is added last and wins */
+		connection_mock_add_profile(&profile_info);
+	}
+}
+
+static int __replay_register_callbacks(connection_h connection)
+{
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile;
+	int count = 0;
+
+	if (connection_get_profile_iterator(connection, CONNECTION_ITERATOR_TYPE_REGISTERED,
+			&iterator) != CONNECTION_ERROR_NONE)
+		return 0;
+
+	while (connection_profile_iterator_has_next(iterator)) {
+		if (connection_profile_iterator_next(iterator, &profile) != CONNECTION_ERROR_NONE)
+			break;
+
+		if (connection_profile_set_state_changed_cb(profile, __replay_state_changed_cb, NULL) ==
+				CONNECTION_ERROR_NONE)
+			count++;
+	}
+
+	connection_destroy_profile_iterator(iterator);
+
+	return count;
+}
+
+static void __replay_run(void)
+{
+	gint64 start = g_get_monotonic_time();
+	int i;
+
+	for (i = 0; i < replay.events->len; i++) {
+		struct replay_event_s *event = &g_array_index(replay.events, struct replay_event_s, i);
+		gint64 dispatch_time;
+
+		if (replay.speed > 0) {
+			gint64 due = start + (gint64)(event->timestamp / replay.speed);
+			gint64 now = g_get_monotonic_time();
+
+			if (due > now)
+				g_usleep(due - now);
+			else if (now - due > replay.lag_max)
+				replay.lag_max = now - due;
+		}
+
+		replay.delivery_start = __replay_now();
+		connection_mock_deliver_event(&event->event_info);
+		dispatch_time = __replay_now() - replay.delivery_start;
+
+		g_array_append_val(replay.dispatch_times, dispatch_time);
+	}
+}
+
+static int __replay_record(const char *path, const char *script)
+{
+	connection_h connection = NULL;
+	int count;
+
+	if (_connection_capture_start(path) != CONNECTION_ERROR_NONE) {
+		fprintf(stderr, "Cannot capture to %s\n", path);
+		return 1;
+	}
+
+	connection_mock_reset();
+	connection_create(&connection);
+
+	/* Nothing registers on its own here, and only a registered client receives the events */
+	_connection_libnet_register();
+
+	if (connection_mock_load_script(script) != NET_ERR_NONE) {
+		fprintf(stderr, "Cannot run %s\n", script);
+		connection_destroy(connection);
+		_connection_capture_stop();
+		return 1;
+	}
+
+	/* Let the main loop deliver the events, so the log keeps the delays of the script */
+	count = connection_mock_get_pending_events();
+	while (connection_mock_get_pending_events() > 0)
+		g_main_context_iteration(NULL, TRUE);
+
+	connection_destroy(connection);
+	_connection_capture_stop();
+
+	printf("Recorded %d events from %s to %s\n", count, script, path);
+
+	return 0;
+}
+
+static void __replay_usage(const char *program)
+{
+	printf("Usage: %s [--speed X] [--repeat N] [--output FILE] LOG\n", program);
+	printf("       %s --record LOG SCRIPT\n", program);
+	printf("  --speed X    Replay X times faster than captured, 0 replays as fast as possible (default 1)\n");
+	printf("  --repeat N   Replay the log N times (default 1)\n");
+	printf("  --record     Capture the events of a mock script into LOG\n");
+	printf("Logs are captured from any process with %s=<path> in its environment.\n",
+			CONNECTION_CAPTURE_ENV);
+}
+
+int main(int argc, char **argv)
+{
+	connection_h connection = NULL;
+	const char *output = NULL;
+	const char *path = NULL;
+	FILE *fp = stdout;
+	gint64 start, elapsed;
+	int profiles;
+	int i;
+
+	if (argc == 4 && strcmp(argv[1], "--record") == 0)
+		return __replay_record(argv[2], argv[3]);
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+			replay.speed = atof(argv[++i]);
+		else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+			replay.repeat = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else if (argv[i][0] != '-' && path == NULL)
+			path = argv[i];
+		else {
+			__replay_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (path == NULL || replay.speed < 0 || replay.repeat < 1) {
+		__replay_usage(argv[0]);
+		return 1;
+	}
+
+	replay.events = g_array_new(FALSE, FALSE, sizeof(struct replay_event_s));
+	replay.dispatch_times = g_array_new(FALSE, FALSE, sizeof(gint64));
+	replay.callback_latencies = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+	if (__replay_load(path) <= 0) {
+		fprintf(stderr, "No events to replay\n");
+		return 1;
+	}
+
+	connection_mock_reset();
+	__replay_add_profiles();
+
+	if (connection_create(&connection) != CONNECTION_ERROR_NONE) {
+		fprintf(stderr, "connection_create failed\n");
+		return 1;
+	}
+
+	profiles = __replay_register_callbacks(connection);
+
+	start = g_get_monotonic_time();
+	for (i = 0; i < replay.repeat; i++)
+		__replay_run();
+	elapsed = g_get_monotonic_time() - start;
+
+	if (output) {
+		fp = fopen(output, "w");
+		if (fp == NULL) {
+			fprintf(stderr, "Cannot open %s\n", output);
+			fp = stdout;
+		}
+	}
+
+	fprintf(fp, "{\n  \"log\": \"%s\",\n  \"speed\": %.2f,\n  \"events\": %u,\n  \"profiles\": %d,\n"
+			"  \"duration_us\": %lld,\n  \"events_per_sec\": %.1f,\n  \"callbacks\": %u,\n",
+			path, replay.speed, replay.dispatch_times->len, profiles, (long long)elapsed,
+			elapsed > 0 ? replay.dispatch_times->len * (double)G_USEC_PER_SEC / elapsed : 0.0,
+			replay.callback_latencies->len);
+
+	__replay_print_percentiles(fp, "dispatch", replay.dispatch_times);
+	__replay_print_percentiles(fp, "callback_latency", replay.callback_latencies);
+
+	fprintf(fp, "  \"max_schedule_lag_us\": %lld\n}\n", replay.lag_max);
+
+	if (fp != stdout)
+		fclose(fp);
+
+	connection_destroy(connection);
+
+	for (i = 0; i < replay.events->len; i++)
+		g_free(g_array_index(replay.events, struct replay_event_s, i).event_info.Data);
+
+	g_array_free(replay.events, TRUE);
+	g_array_free(replay.dispatch_times, TRUE);
+	g_array_free(replay.callback_latencies, TRUE);
+
+	return 0;
+}
@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <glib.h>
+#include "net_connection_private.h"
+#include "connection_mock.h"
+
+#define STRESS_THREADS_MAX 64
+
+enum {
+	STRESS_OP_CREATE_DESTROY = 0,
+	STRESS_OP_ITERATE,
+	STRESS_OP_ATTRIBUTES,
+	STRESS_OP_CALLBACKS,
+	STRESS_OP_MAX,
+};
+
+enum {
+	STRESS_VIOLATION_UNEXPECTED_ERROR = 0,
+	STRESS_VIOLATION_STALE_HANDLE,
+	STRESS_VIOLATION_STALE_PROFILE,
+	STRESS_VIOLATION_STALE_ITERATOR,
+	STRESS_VIOLATION_PROFILE_COUNT,
+	STRESS_VIOLATION_CALLBACK_VALUE,
+	STRESS_VIOLATION_MAX,
+};
+
+static const char *stress_op_names[STRESS_OP_MAX] = {
+	"create_destroy", "iterate", "attributes", "callbacks",
+};
+
+static const char *stress_violation_names[STRESS_VIOLATION_MAX] = {
+	"unexpected_error", "stale_handle_accepted", "stale_profile_accepted",
+	"stale_iterator_accepted", "profile_count_mismatch", "callback_value_out_of_range",
+};
+
+struct stress_worker_s {
+	pthread_t thread;
+	int index;
+	long long ops[STRESS_OP_MAX];
+};
+
+static struct {
+	int threads;
+	int duration;
+	int latency;
+	int profiles;
+	int event_interval;
+	volatile int running;
+	volatile gint64 violations[STRESS_VIOLATION_MAX];
+	volatile gint64 callbacks;
+	long long events;
+} stress = {8, 10, 0, 16, 100, 0};
+
+
+static void __stress_violation(int violation, const char *detail)
+{
+	/* Report the first few of each kind, count the rest */
+	if (__sync_fetch_and_add(&stress.violations[violation], 1) < 5)
+		fprintf(stderr, "violation %s: %s\n", stress_violation_names[violation], detail);
+}
+
+static void __stress_check(int rv, const char *operation)
+{
+	if (rv != CONNECTION_ERROR_NONE)
+		__stress_violation(STRESS_VIOLATION_UNEXPECTED_ERROR, operation);
+}
+
+static void __stress_type_changed_cb(connection_type_e type, void *user_data)
+{
+	if (type < CONNECTION_TYPE_DISCONNECTED || type > CONNECTION_TYPE_ETHERNET)
+		__stress_violation(STRESS_VIOLATION_CALLBACK_VALUE, "connection_type_changed_cb");
+
+	__sync_fetch_and_add(&stress.callbacks, 1);
+}
+
+static void __stress_address_changed_cb(const char *ipv4_address, const char *ipv6_address, void *user_data)
+{
+	if (ipv4_address == NULL)
+		__stress_violation(STRESS_VIOLATION_CALLBACK_VALUE, "connection_address_changed_cb");
+
+	__sync_fetch_and_add(&stress.callbacks, 1);
+}
+
+static void __stress_create_destroy(void)
+{
+	connection_h connection = NULL;
+	connection_type_e type;
+
+	if (connection_create(&connection) != CONNECTION_ERROR_NONE) {
+		__stress_check(CONNECTION_ERROR_OPERATION_FAILED, "connection_create");
+		return;
+	}
+
+	__stress_check(connection_destroy(connection), "connection_destroy");
+
+	/* The freed handle is only compared, never dereferenced, by the library */
+	if (connection_get_type(connection, &type) == CONNECTION_ERROR_NONE)
+		__stress_violation(STRESS_VIOLATION_STALE_HANDLE, "connection_get_type");
+}
+
+static void __stress_iterate(connection_h connection)
+{
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile = NULL;
+	connection_profile_type_e type;
+	char *name = NULL;
+	int count = 0;
+
+	if (connection_get_profile_iterator(connection, CONNECTION_ITERATOR_TYPE_REGISTERED,
+			&iterator) != CONNECTION_ERROR_NONE) {
+		__stress_check(CONNECTION_ERROR_OPERATION_FAILED, "connection_get_profile_iterator");
+		return;
+	}
+
+	while (connection_profile_iterator_has_next(iterator)) {
+		if (connection_profile_iterator_next(iterator, &profile) != CONNECTION_ERROR_NONE) {
+			__stress_check(CONNECTION_ERROR_OPERATION_FAILED, "connection_profile_iterator_next");
+			break;
+		}
+
+		__stress_check(connection_profile_get_name(profile, &name), "connection_profile_get_name");
+		__stress_check(connection_profile_get_type(profile, &type), "connection_profile_get_type");
+		free(name);
+		name = NULL;
+		count++;
+	}
+
+	if (count != stress.profiles)
+		__stress_violation(STRESS_VIOLATION_PROFILE_COUNT, "registered iterator");
+
+	__stress_check(connection_destroy_profile_iterator(iterator), "connection_destroy_profile_iterator");
+
+	if (connection_profile_iterator_has_next(iterator) ||
+	    connection_destroy_profile_iterator(iterator) == CONNECTION_ERROR_NONE)
+		__stress_violation(STRESS_VIOLATION_STALE_ITERATOR, "destroyed iterator");
+
+	if (profile && connection_profile_get_type(profile, &type) == CONNECTION_ERROR_NONE)
+		__stress_violation(STRESS_VIOLATION_STALE_PROFILE, "profile of a destroyed iterator");
+}
+
+static void __stress_attributes(connection_h connection)
+{
+	connection_type_e type;
+	connection_wifi_state_e wifi_state;
+	connection_cellular_state_e cellular_state;
+	connection_profile_h profile = NULL;
+	connection_profile_state_e profile_state;
+	connection_snapshot_s snapshot;
+	connection_proxy_endpoint_s endpoint;
+	char *value = NULL;
+
+	__stress_check(connection_get_type(connection, &type), "connection_get_type");
+	__stress_check(connection_get_snapshot(connection, &snapshot), "connection_get_snapshot");
+	__stress_check(connection_get_proxy_endpoint(connection, &endpoint), "connection_get_proxy_endpoint");
+	__stress_check(connection_get_wifi_state(connection, &wifi_state), "connection_get_wifi_state");
+	__stress_check(connection_get_cellular_state(connection, &cellular_state), "connection_get_cellular_state");
+
+	__stress_check(connection_get_ip_address(connection, CONNECTION_ADDRESS_FAMILY_IPV4, &value),
+			"connection_get_ip_address");
+	free(value);
+	value = NULL;
+
+	__stress_check(connection_get_proxy(connection, CONNECTION_ADDRESS_FAMILY_IPV4, &value),
+			"connection_get_proxy");
+	free(value);
+	value = NULL;
+
+	if (connection_get_current_profile(connection, &profile) != CONNECTION_ERROR_NONE) {
+		__stress_check(CONNECTION_ERROR_OPERATION_FAILED, "connection_get_current_profile");
+		return;
+	}
+
+	__stress_check(connection_profile_get_state(profile, &profile_state), "connection_profile_get_state");
+	__stress_check(connection_profile_get_ip_address(profile, CONNECTION_ADDRESS_FAMILY_IPV4, &value),
+			"connection_profile_get_ip_address");
+	free(value);
+
+	__stress_check(connection_profile_destroy(profile), "connection_profile_destroy");
+
+	if (connection_profile_get_state(profile, &profile_state) == CONNECTION_ERROR_NONE)
+		__stress_violation(STRESS_VIOLATION_STALE_PROFILE, "destroyed current profile");
+}
+
+static void __stress_callbacks(connection_h connection)
+{
+	__stress_check(connection_set_type_changed_cb(connection, __stress_type_changed_cb, NULL),
+			"connection_set_type_changed_cb");
+	__stress_check(connection_set_ip_address_changed_cb(connection, __stress_address_changed_cb, NULL),
+			"connection_set_ip_address_changed_cb");
+
+	g_usleep(10);
+
+	__stress_check(connection_unset_ip_address_changed_cb(connection), "connection_unset_ip_address_changed_cb");
+	__stress_check(connection_unset_type_changed_cb(connection), "connection_unset_type_changed_cb");
+}
+
+static void *__stress_worker(void *data)
+{
+	struct stress_worker_s *worker = data;
+	connection_h connection = NULL;
+	int op = worker->index % STRESS_OP_MAX;
+
+	if (connection_create(&connection) != CONNECTION_ERROR_NONE) {
+		__stress_check(CONNECTION_ERROR_OPERATION_FAILED, "connection_create");
+		return NULL;
+	}
+
+	/* Threads start on different operations, so every pair of operations overlaps */
+	while (g_atomic_int_get(&stress.running)) {
+		switch (op) {
+		case STRESS_OP_CREATE_DESTROY:
+			__stress_create_destroy();
+			break;
+		case STRESS_OP_ITERATE:
+			__stress_iterate(connection);
+			break;
+		case STRESS_OP_ATTRIBUTES:
+			__stress_attributes(connection);
+			break;
+		case STRESS_OP_CALLBACKS:
+			__stress_callbacks(connection);
+			break;
+		}
+
+		worker->ops[op]++;
+		op = (op + 1) % STRESS_OP_MAX;
+	}
+
+	connection_destroy(connection);
+
+	return NULL;
+}
+
+static void __stress_inject_events(gint64 end)
+{
+	int status = 1;
+
+	/* The main thread plays the event loop: it changes state and dispatches notifications */
+	while (g_get_monotonic_time() < end) {
+		status = (status == 1) ? 2 : 1;
+
+		vconf_set_int(VCONFKEY_NETWORK_STATUS, status);
+		vconf_set_str(VCONFKEY_NETWORK_IP, status == 1 ? "10.1.2.3" : "192.168.0.10");
+		connection_mock_queue_event(0, NET_EVENT_NET_STATE_IND, NET_ERR_NONE, "/context/internet",
+				status == 1 ? NET_STATE_TYPE_READY : NET_STATE_TYPE_IDLE);
+
+		stress.events += connection_mock_dispatch_events();
+
+		if (stress.event_interval > 0)
+			g_usleep(stress.event_interval);
+	}
+}
+
+static void __stress_setup(void)
+{
+	char command[256];
+	int i;
+
+	connection_mock_reset();
+	connection_mock_set_latency(stress.latency);
+
+	connection_mock_run_command("profile wifi /wifi/home wlan0 online HomeAP 192.168.0.10 80");
+	connection_mock_run_command("profile cellular /context/internet pdp0 ready internet.apn internet 10.1.2.3");
+	connection_mock_run_command("profile ethernet /ethernet/eth0 eth0 idle");
+
+	for (i = 3; i < stress.profiles; i++) {
+		snprintf(command, sizeof(command), "profile wifi /wifi/ap%d wlan0 idle AP%d", i, i);
+		connection_mock_run_command(command);
+	}
+
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_STATUS " 1");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_WIFI_STATE " 2");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_CELLULAR_STATE " 0");
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_IP " 192.168.0.10");
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_PROXY " proxy.example.com:8080");
+
+	connection_mock_dispatch_events();
+}
+
+static void __stress_report(FILE *output, struct stress_worker_s *workers, double elapsed)
+{
+	long long ops[STRESS_OP_MAX] = {0, };
+	long long total = 0;
+	long long acquisitions, contentions, wait_time;
+	int i, j;
+
+	for (i = 0; i < stress.threads; i++) {
+		for (j = 0; j < STRESS_OP_MAX; j++) {
+			ops[j] += workers[i].ops[j];
+			total += workers[i].ops[j];
+		}
+	}
+
+	_connection_inter_mutex_get_stats(&acquisitions, &contentions, &wait_time);
+
+	fprintf(output, "{\n  \"threads\": %d,\n  \"duration_s\": %.2f,\n  \"latency_us\": %d,\n"
+			"  \"profiles\": %d,\n  \"ops_per_sec\": %.1f,\n  \"operations\": {",
+			stress.threads, elapsed, stress.latency, stress.profiles, total / elapsed);
+
+	for (j = 0; j < STRESS_OP_MAX; j++)
+		fprintf(output, "%s\"%s\": %lld", j ? ", " : "", stress_op_names[j], ops[j]);
+
+	fprintf(output, "},\n  \"events_injected\": %lld,\n  \"callbacks_delivered\": %lld,\n",
+			stress.events, (long long)stress.callbacks);
+
+	fprintf(output, "  \"lock\": {\"acquisitions\": %lld, \"contended\": %lld, \"wait_us\": %lld, "
+			"\"mean_wait_us\": %.2f},\n  \"violations\": {",
+			acquisitions, contentions, wait_time,
+			contentions ? (double)wait_time / contentions : 0.0);
+
+	for (j = 0; j < STRESS_VIOLATION_MAX; j++)
+		fprintf(output, "%s\"%s\": %lld", j ? ", " : "", stress_violation_names[j],
+				(long long)stress.violations[j]);
+
+	fprintf(output, "}\n}\n");
+}
+
+static void __stress_usage(const char *program)
+{
+	printf("Usage: %s [--threads N] [--duration SEC] [--latency USEC] [--profiles N]\n"
+			"          [--event-interval USEC] [--output FILE]\n", program);
+}
+
+int main(int argc, char **argv)
+{
+	struct stress_worker_s workers[STRESS_THREADS_MAX];
+	connection_h connection = NULL;
+	const char *output = NULL;
+	FILE *fp = stdout;
+	gint64 start;
+	long long violations = 0;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			stress.threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+			stress.duration = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+			stress.latency = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--profiles") == 0 && i + 1 < argc)
+			stress.profiles = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--event-interval") == 0 && i + 1 < argc)
+			stress.event_interval = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else {
+			__stress_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (stress.threads < 1 || stress.threads > STRESS_THREADS_MAX ||
+	    stress.duration < 1 || stress.profiles < 3) {
+		__stress_usage(argv[0]);
+		return 1;
+	}
+
+	__stress_setup();
+
+	/* Keeps the daemon registration alive while the workers churn their handles */
+	if (connection_create(&connection) != CONNECTION_ERROR_NONE) {
+		fprintf(stderr, "connection_create failed\n");
+		return 1;
+	}
+
+	_connection_inter_mutex_reset_stats();
+	g_atomic_int_set(&stress.running, 1);
+	start = g_get_monotonic_time();
+
+	for (i = 0; i < stress.threads; i++) {
+		memset(&workers[i], 0, sizeof(struct stress_worker_s));
+		workers[i].index = i;
+		pthread_create(&workers[i].thread, NULL, __stress_worker, &workers[i]);
+	}
+
+	__stress_inject_events(start + (gint64)stress.duration * G_USEC_PER_SEC);
+
+	g_atomic_int_set(&stress.running, 0);
+	for (i = 0; i < stress.threads; i++)
+		pthread_join(workers[i].thread, NULL);
+
+	if (output) {
+		fp = fopen(output, "w");
+		if (fp == NULL) {
+			fprintf(stderr, "Cannot open %s\n", output);
+			fp = stdout;
+		}
+	}
+
+	__stress_report(fp, workers, (g_get_monotonic_time() - start) / (double)G_USEC_PER_SEC);
+
+	if (fp != stdout)
+		fclose(fp);
+
+	connection_destroy(connection);
+
+	for (i = 0; i < STRESS_VIOLATION_MAX; i++)
+		violations += stress.violations[i];
+
+	if (violations > 0) {
+		fprintf(stderr, "%lld invariant violation(s)\n", violations);
+		return 1;
+	}
+
+	return 0;
+}
@@ -23,6 +23,8 @@
 extern "C" {
 #endif
 
+#define CONNECTION_DNS_SERVER_MAX 2
+
 /**
 * @addtogroup CAPI_NETWORK_CONNECTION_WIFI_PROFILE_MODULE
 * @{
@@ -131,6 +133,24 @@ typedef enum
     CONNECTION_ADDRESS_FAMILY_IPV6 = 1,  /**< IPV6 Address type */
 } connection_address_family_e;
 
+/**
+* @brief A DNS server in binary form.
+*/
+typedef struct
+{
+    connection_address_family_e address_family;  /**< The address family of the server */
+    unsigned char address[16];  /**< The address in network byte order, in the first 4 bytes for IPv4 */
+} connection_dns_server_s;
+
+/**
+* @brief The DNS servers of a profile, in the order of the profile.
+*/
+typedef struct
+{
+    int count;  /**< Number of servers */
+    connection_dns_server_s servers[CONNECTION_DNS_SERVER_MAX];  /**< The servers, the first @a count are set */
+} connection_dns_servers_s;
+
 /**
 * @brief Net IP configuration Type
 */
@@ -188,6 +208,7 @@ int connection_profile_destroy(connection_profile_h profile);
 
 /**
 * @brief Clons the profile handle.
+* @details The contents are shared until one of the two profiles is modified with a connection_profile_set_* function, and copied at that point.
 * @remarks @a cloned_profile must be released with connection_profile_destroy().
 * @param[in] origin_profile  The handle of origin profile
 * @param[out] cloned_profile  The handle of cloned profile
@@ -199,6 +220,33 @@ int connection_profile_destroy(connection_profile_h profile);
 */
 int connection_profile_clone(connection_profile_h* cloned_profile, connection_profile_h origin_profile);
 
+/**
+* @brief Retains the profile handle.
+* @details Handles returned by iterators, callbacks and connection_get_current_profile() are shared, not copied.
+* A retained handle stays valid after its iterator is destroyed or its callback is unset, until the matching connection_profile_unref().
+* The profile functions accept every handle the library handed out until its last reference is released,
+* whether it belongs to an iterator, a callback or the application.
+* @remarks Retaining is an atomic increment, so it is cheaper than connection_profile_clone().
+* @param[in] profile  The handle of the profile
+* @return 0 on success, otherwise negative error value.
+* @retval #CONNECTION_ERROR_NONE  Successful
+* @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+* @see connection_profile_unref()
+*/
+int connection_profile_ref(connection_profile_h profile);
+
+/**
+* @brief Releases a handle retained with connection_profile_ref().
+* @remarks The profile is freed when its last reference is released.
+* Handles of iterators, callbacks and connection_profile_create() are released by their own functions, not by this one.
+* @param[in] profile  The handle of the profile
+* @return 0 on success, otherwise negative error value.
+* @retval #CONNECTION_ERROR_NONE  Successful
+* @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter, or no reference retained with connection_profile_ref() is left
+* @see connection_profile_ref()
+*/
+int connection_profile_unref(connection_profile_h profile);
+
 /**
 * @brief Gets the profile name.
 * @remarks @a profile_name must be released with free() by you.
@@ -234,6 +282,42 @@ int connection_profile_get_type(connection_profile_h profile, connection_profile
 */
 int connection_profile_get_network_interface_name(connection_profile_h profile, char** interface_name);
 
+/**
+* @brief Binds a socket to the network interface and the address of the profile.
+* @details The socket is bound to the interface of the profile, so its traffic goes through that
+* interface whatever the routing table says. An IPv4 socket which is not bound yet is also bound
+* to the IPv4 address of the profile, with any port.
+* The index of the interface is cached, so binding another socket to the same interface costs no lookup.
+* @param[in] profile  The handle of profile
+* @param[in] socket_fd  The socket
+* @return 0 on success, otherwise negative error value.
+* @retval #CONNECTION_ERROR_NONE  Successful
+* @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+* @retval #CONNECTION_ERROR_NO_CONNECTION  The interface of the profile does not exist
+* @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+* @see connection_profile_create_socket()
+*/
+int connection_profile_bind_socket(connection_profile_h profile, int socket_fd);
+
+/**
+* @brief Creates a socket bound to the network interface and the address of the profile.
+* @details The socket is created with @c SOCK_CLOEXEC, then bound as connection_profile_bind_socket() does.
+* @remarks @a socket_fd must be closed with close() by you.
+* @param[in] profile  The handle of profile
+* @param[in] address_family  The address family of the socket
+* @param[in] type  The type of the socket, such as @c SOCK_STREAM or @c SOCK_DGRAM
+* @param[in] protocol  The protocol of the socket, usually 0
+* @param[out] socket_fd  The socket
+* @return 0 on success, otherwise negative error value.
+* @retval #CONNECTION_ERROR_NONE  Successful
+* @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+* @retval #CONNECTION_ERROR_NO_CONNECTION  The interface of the profile does not exist
+* @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+* @see connection_profile_bind_socket()
+*/
+int connection_profile_create_socket(connection_profile_h profile, connection_address_family_e address_family,
+		int type, int protocol, int* socket_fd);
+
 /**
 * @brief Gets the network type.
 * @param[in] profile  The handle of profile
@@ -318,6 +402,19 @@ int connection_profile_get_gateway_address(connection_profile_h profile, connect
 */
 int connection_profile_get_dns_address(connection_profile_h profile, int order, connection_address_family_e address_family, char** dns_address);
 
+/**
+* @brief Gets all DNS servers of the profile at once, in binary form.
+* @details Unlike connection_profile_get_dns_address(), this call allocates nothing, and empty entries are skipped.
+* @param[in] profile  The handle of profile
+* @param[out] servers  The DNS servers
+* @return 0 on success, otherwise negative error value.
+* @retval #CONNECTION_ERROR_NONE  Successful
+* @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+* @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+* @see connection_get_dns_servers()
+*/
+int connection_profile_get_dns_servers(connection_profile_h profile, connection_dns_servers_s* servers);
+
 /**
 * @brief Gets the Proxy type.
 * @param[in] profile  The handle of profile
@@ -436,6 +533,7 @@ int connection_profile_set_proxy_address(connection_profile_h profile, connectio
 
 /**
 * @brief Called when the state of profile is changed.
+* @details Every call of a registration passes the same handle, updated in place.
 * @param[in] profile  The handle of profile
 * @param[in] is_requested  Indicates whether this change is requested or not
 * @param[in] user_data The user data passed from the callback registration function
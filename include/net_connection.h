@@ -28,6 +28,11 @@ extern "C" {
 #define DEPRECATED __attribute__((deprecated))
 #endif
 
+#define CONNECTION_SNAPSHOT_ADDRESS_LEN 65
+#define CONNECTION_SNAPSHOT_PROFILE_NAME_LEN 513
+#define CONNECTION_SNAPSHOT_INTERFACE_NAME_LEN 33
+#define CONNECTION_PROXY_HOST_LEN 65
+
 /**
  * @addtogroup CAPI_NETWORK_CONNECTION_MANAGER_MODULE
  * @{
@@ -110,6 +115,110 @@ typedef enum
     CONNECTION_ERROR_NO_CONNECTION = TIZEN_ERROR_NETWORK_CLASS|0x0403, /**< There is no connection */
 } connection_error_e;
 
+/**
+ * @brief The memory held by the library for one kind of object.
+ */
+typedef struct
+{
+    int count;  /**< Number of live objects */
+    long long bytes;  /**< Bytes held by the live objects */
+} connection_memory_entry_s;
+
+/**
+ * @brief The memory held by the library on behalf of the application.
+ */
+typedef struct
+{
+    connection_memory_entry_s handles;  /**< Connection handles */
+    connection_memory_entry_s profiles;  /**< Profile handles which must be released with connection_profile_destroy() */
+    connection_memory_entry_s iterators;  /**< Profile iterators with their profiles */
+    connection_memory_entry_s callbacks;  /**< Profile state callbacks with their copies of the profile */
+    long long total_bytes;  /**< Bytes held by all of the above */
+    long long peak_bytes;  /**< Highest @a total_bytes since the process started or connection_reset_memory_peak() */
+} connection_memory_usage_s;
+
+/**
+ * @brief Enumerations of profile list changes.
+ */
+typedef enum
+{
+    CONNECTION_PROFILE_CHANGE_ADDED = 0,  /**< The profile appeared, or came back after it was removed */
+    CONNECTION_PROFILE_CHANGE_REMOVED = 1,  /**< The profile is gone */
+    CONNECTION_PROFILE_CHANGE_CHANGED = 2,  /**< Some fields of the profile changed */
+} connection_profile_change_type_e;
+
+/**
+ * @brief Enumerations of profile fields, combined into the mask of a profile change.
+ */
+typedef enum
+{
+    CONNECTION_PROFILE_FIELD_STATE = 0x0001,  /**< Profile state */
+    CONNECTION_PROFILE_FIELD_INTERFACE = 0x0002,  /**< Network interface name */
+    CONNECTION_PROFILE_FIELD_IP_ADDRESS = 0x0004,  /**< IP config type, IP address, subnet mask and gateway */
+    CONNECTION_PROFILE_FIELD_DNS = 0x0008,  /**< DNS addresses */
+    CONNECTION_PROFILE_FIELD_PROXY = 0x0010,  /**< Proxy type and address */
+    CONNECTION_PROFILE_FIELD_WIFI_SIGNAL = 0x0020,  /**< Wi-Fi RSSI, frequency and max speed */
+    CONNECTION_PROFILE_FIELD_WIFI_SECURITY = 0x0040,  /**< Wi-Fi security, encryption and passphrase */
+    CONNECTION_PROFILE_FIELD_CELLULAR = 0x0080,  /**< Cellular service type, APN, auth info, home URL and roaming */
+    CONNECTION_PROFILE_FIELD_OTHER = 0x0100,  /**< Any other field */
+    CONNECTION_PROFILE_FIELD_ALL = 0x01FF,  /**< Every field */
+} connection_profile_field_e;
+
+/**
+ * @brief A change of the profile list.
+ */
+typedef struct
+{
+    connection_profile_change_type_e type;  /**< The kind of change */
+    char *profile_name;  /**< The name of the profile */
+    connection_profile_h profile;  /**< The profile as it is now, NULL when removed */
+    unsigned int changed_fields;  /**< The changed fields, a mask of #connection_profile_field_e */
+} connection_profile_change_s;
+
+/**
+ * @brief A consistent view of the connection state, taken with connection_get_snapshot().
+ */
+typedef struct
+{
+    unsigned int version;  /**< Changes whenever any of the fields below changes */
+    connection_type_e type;  /**< The type of the current connection */
+    connection_wifi_state_e wifi_state;  /**< The state of Wi-Fi */
+    connection_cellular_state_e cellular_state;  /**< The state of cellular */
+    connection_ethernet_state_e ethernet_state;  /**< The state of ethernet */
+    char ip_address[CONNECTION_SNAPSHOT_ADDRESS_LEN];  /**< The IPv4 address of the current connection */
+    char proxy_address[CONNECTION_SNAPSHOT_ADDRESS_LEN];  /**< The proxy address of the current connection */
+    bool has_profile;  /**< Whether a profile is connected; the profile fields below are only set if so */
+    connection_profile_type_e profile_type;  /**< The type of the current profile */
+    connection_profile_state_e profile_state;  /**< The state of the current profile */
+    char profile_name[CONNECTION_SNAPSHOT_PROFILE_NAME_LEN];  /**< The name of the current profile */
+    char interface_name[CONNECTION_SNAPSHOT_INTERFACE_NAME_LEN];  /**< The network interface of the current profile */
+} connection_snapshot_s;
+
+/**
+ * @brief The proxy of the current connection, taken with connection_get_proxy_endpoint().
+ */
+typedef struct
+{
+    connection_proxy_type_e type;  /**< #CONNECTION_PROXY_TYPE_DIRECT when there is no proxy address */
+    char host[CONNECTION_PROXY_HOST_LEN];  /**< The host of the proxy, or of the PAC file for #CONNECTION_PROXY_TYPE_AUTO, without brackets for IPv6 */
+    int port;  /**< The port of the proxy, 0 if the address has none */
+} connection_proxy_endpoint_s;
+
+/**
+ * @brief The attributes of a connected profile, passed to #connection_profile_score_cb.
+ */
+typedef struct
+{
+    const char *profile_name;  /**< The name of the profile, valid during the callback only */
+    connection_profile_type_e type;  /**< The type of the profile */
+    connection_profile_state_e state;  /**< The state of the profile */
+    int rssi;  /**< Wi-Fi RSSI, 0 for other types */
+    int frequency;  /**< Wi-Fi frequency (MHz), 0 for other types */
+    int max_speed;  /**< Wi-Fi max speed (Mbps), 0 for other types */
+    connection_cellular_network_type_e cellular_network_type;  /**< Cellular network type, #CONNECTION_CELLULAR_NETWORK_TYPE_UNKNOWN for other types */
+    bool is_roaming;  /**< Whether cellular is in roaming, false for other types */
+} connection_profile_score_info_s;
+
 /**
  * @}
 */
@@ -130,6 +239,41 @@ typedef enum
     CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA = 3,  /**< Total sent data */
 } connection_statistics_type_e;
 
+/**
+ * @brief The throughput rates of a connection type, in bits per second.
+ */
+typedef struct
+{
+    long long current_received;  /**< Received rate of the latest sample */
+    long long current_sent;  /**< Sent rate of the latest sample */
+    long long average_received;  /**< Average received rate over the window */
+    long long average_sent;  /**< Average sent rate over the window */
+    long long peak_received;  /**< Highest received rate in the window */
+    long long peak_sent;  /**< Highest sent rate in the window */
+} connection_statistics_rate_s;
+
+/**
+ * @brief The statistics information of a connection type (bytes).
+ */
+typedef struct
+{
+    long long last_received;  /**< Last received data */
+    long long last_sent;  /**< Last sent data */
+    long long total_received;  /**< Total received data */
+    long long total_sent;  /**< Total sent data */
+    bool is_valid;  /**< Whether the values could be read; they are 0 otherwise */
+} connection_statistics_data_s;
+
+/**
+ * @brief The statistics information of every connection type.
+ */
+typedef struct
+{
+    connection_statistics_data_s cellular;  /**< Statistics of cellular */
+    connection_statistics_data_s wifi;  /**< Statistics of Wi-Fi */
+    connection_statistics_data_s ethernet;  /**< Statistics of ethernet */
+} connection_statistics_info_s;
+
 /**
  * @}
 */
@@ -142,6 +286,8 @@ typedef enum
 
 /**
  * @brief Creates a handle for managing data connections.
+ * @details Creating a handle does not contact the network daemon. The process registers with the daemon
+ * on the first request that needs it, such as getting a profile iterator or setting a callback.
  * @remarks @a handle must be released with connection_destroy().
  * @param[out] connection  The handle of the connection
  * @return 0 on success, otherwise negative error value.
@@ -183,6 +329,46 @@ typedef void(*connection_type_changed_cb)(connection_type_e type, void* user_dat
  */
 typedef void(*connection_address_changed_cb)(const char* ipv4_address, const char* ipv6_address, void* user_data);
 
+/**
+ * @brief Called when the state of ethernet is changed.
+ * @param[in] state  The new state of Ethernet connection
+ * @param[in] user_data The user data passed from the callback registration function
+ * @see connection_set_ethernet_state_changed_cb()
+ * @see connection_unset_ethernet_state_changed_cb()
+ */
+typedef void(*connection_ethernet_state_changed_cb)(connection_ethernet_state_e state, void* user_data);
+
+/**
+ * @brief Called when the DNS servers of the current connection are changed.
+ * @param[in] servers  The new DNS servers, with a count of 0 when there is no connection
+ * @param[in] user_data The user data passed from the callback registration function
+ * @see connection_set_dns_servers_changed_cb()
+ * @see connection_unset_dns_servers_changed_cb()
+ */
+typedef void(*connection_dns_servers_changed_cb)(const connection_dns_servers_s* servers, void* user_data);
+
+/**
+ * @brief Called when the live profile list replaced the one of the warm start file.
+ * @param[in] user_data The user data passed from the callback registration function
+ * @see connection_get_cached_profile_iterator()
+ * @see connection_set_profile_list_refreshed_cb()
+ */
+typedef void(*connection_profile_list_refreshed_cb)(void* user_data);
+
+/**
+ * @brief Called when the address or the link state of a network interface is changed.
+ * @details The addresses are the first global IPv4 and IPv6 addresses of the interface.
+ * Link-local addresses are not reported.
+ * @param[in] interface_name  The name of the interface
+ * @param[in] ipv4_address  The IP address for IPv4, or an empty string if the interface has none
+ * @param[in] ipv6_address  The IP address for IPv6, or an empty string if the interface has none
+ * @param[in] user_data The user data passed from the callback registration function
+ * @see connection_set_interface_address_changed_cb()
+ * @see connection_unset_interface_address_changed_cb()
+ */
+typedef void(*connection_interface_address_changed_cb)(const char* interface_name,
+		const char* ipv4_address, const char* ipv6_address, void* user_data);
+
 
 /**
  * @brief Gets the type.
@@ -224,6 +410,40 @@ int connection_get_ip_address(connection_h connection, connection_address_family
  */
 int connection_get_proxy(connection_h connection, connection_address_family_e address_family, char** proxy);
 
+/**
+ * @brief Gets the proxy of the current connection, parsed into its host and port.
+ * @details The proxy address is parsed when it changes, not on every call. The first call loads and
+ * watches the state it shares with connection_get_snapshot(); the later calls copy it without taking
+ * a lock or making a system call, so the call suits code that asks for the proxy on every request.
+ * The type is the proxy type of the current profile, or #CONNECTION_PROXY_TYPE_MANUAL when
+ * the address is set without a profile saying so.
+ * @param[in] connection  The handle of the connection
+ * @param[out] endpoint  The proxy
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_set_proxy_address_changed_cb()
+ */
+int connection_get_proxy_endpoint(connection_h connection, connection_proxy_endpoint_s* endpoint);
+
+/**
+ * @brief Gets all DNS servers of the current connection at once, in binary form.
+ * @details Like connection_get_proxy_endpoint(), the call copies the state shared with
+ * connection_get_snapshot(), without taking a lock or making a system call after the first call.
+ * @param[in] connection  The handle of the connection
+ * @param[out] servers  The DNS servers, with a count of 0 when there is no connection
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_profile_get_dns_servers()
+ * @see connection_set_dns_servers_changed_cb()
+ */
+int connection_get_dns_servers(connection_h connection, connection_dns_servers_s* servers);
+
 /**
  * @brief  Gets the state of celluar connection.
  * @details The returned state is for the cellular connection state.
@@ -251,6 +471,8 @@ int connection_get_wifi_state(connection_h connection, connection_wifi_state_e*
 /**
  * @brief  Gets the state of ethernet.
  * @details The returned state is for the ethernet connection state.
+ * The state is kept up to date from the events of the network daemon, so only the first call
+ * after connection_create() queries it.
  * @param[in] connection  The handle of connection
  * @param[out] state  The state of Ethernet connection
  * @return 0 on success, otherwise negative error value.
@@ -260,6 +482,20 @@ int connection_get_wifi_state(connection_h connection, connection_wifi_state_e*
  */
 int connection_get_ethernet_state(connection_h connection, connection_ethernet_state_e* state);
 
+/**
+ * @brief Gets a consistent view of the connection state.
+ * @details The first call loads the state and watches it; the later calls copy it without taking
+ * a lock or making a system call, so the call suits code that asks for the current link very often.
+ * @param[in] connection  The handle of connection
+ * @param[out] snapshot  The state of the connection
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ */
+int connection_get_snapshot(connection_h connection, connection_snapshot_s* snapshot);
+
 /**
  * @brief Registers the callback called when the type of current connection is changed.
  * @param[in] connection  The handle of connection
@@ -326,6 +562,91 @@ int connection_set_proxy_address_changed_cb(connection_h connection, connection_
  */
 int connection_unset_proxy_address_changed_cb(connection_h connection);
 
+/**
+ * @brief Registers the callback called when an address of any network interface is changed.
+ * @details Unlike connection_set_ip_address_changed_cb(), the changes are read from the kernel
+ * directly, per interface and for both IPv4 and IPv6.
+ * The callback is also called when an interface appears, disappears or changes its link state.
+ * @remarks The notifications are delivered from the main loop of the thread default context.
+ * @param[in] connection  The handle of connection
+ * @param[in] callback  The callback function to be called
+ * @param[in] user_data The user data passed to the callback function
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_unset_interface_address_changed_cb()
+ */
+int connection_set_interface_address_changed_cb(connection_h connection,
+		connection_interface_address_changed_cb callback, void* user_data);
+
+/**
+ * @brief Unregisters the callback called when an address of any network interface is changed.
+ * @param[in] connection  The handle of connection
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_set_interface_address_changed_cb()
+ */
+int connection_unset_interface_address_changed_cb(connection_h connection);
+
+/**
+ * @brief Registers the callback called when the state of ethernet is changed.
+ * @details The state follows the events of the network daemon. A lost carrier is also
+ * reported as #CONNECTION_ETHERNET_STATE_DISCONNECTED as soon as the kernel notices it.
+ * @param[in] connection  The handle of connection
+ * @param[in] callback  The callback function to be called
+ * @param[in] user_data The user data passed to the callback function
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_get_ethernet_state()
+ * @see connection_unset_ethernet_state_changed_cb()
+ */
+int connection_set_ethernet_state_changed_cb(connection_h connection,
+		connection_ethernet_state_changed_cb callback, void* user_data);
+
+/**
+ * @brief Unregisters the callback called when the state of ethernet is changed.
+ * @param[in] connection  The handle of connection
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_set_ethernet_state_changed_cb()
+ */
+int connection_unset_ethernet_state_changed_cb(connection_h connection);
+
+/**
+ * @brief Registers the callback called when the DNS servers of the current connection are changed.
+ * @details The servers are compared whenever the current profile changes, so the callback is not
+ * called for a profile change which keeps the same servers.
+ * @param[in] connection  The handle of connection
+ * @param[in] callback  The callback function to be called
+ * @param[in] user_data The user data passed to the callback function
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_get_dns_servers()
+ * @see connection_unset_dns_servers_changed_cb()
+ */
+int connection_set_dns_servers_changed_cb(connection_h connection,
+		connection_dns_servers_changed_cb callback, void* user_data);
+
+/**
+ * @brief Unregisters the callback called when the DNS servers of the current connection are changed.
+ * @param[in] connection  The handle of connection
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_set_dns_servers_changed_cb()
+ */
+int connection_unset_dns_servers_changed_cb(connection_h connection);
+
 /**
  * @brief Adds new profile which is created by connection_profile_created().
  * @param[in] connection  The handle of connection
@@ -373,6 +694,24 @@ int connection_update_profile(connection_h connection, connection_profile_h prof
  */
 int connection_get_profile_iterator(connection_h connection, connection_iterator_type_e type, connection_profile_iterator_h* profile_iterator);
 
+/**
+ * @brief Gets a iterator of the Wi-Fi profiles, from the strongest signal to the weakest.
+ * @details With @a max_count set, only the strongest profiles are kept and sorted,
+ * so asking for a few of them is cheap even with many remembered networks.
+ * @remarks @a profile_iterator must be released with connection_destroy_profile_iterator().
+ * @param[in] connection  The handle of connection
+ * @param[in] max_count  The maximum number of profiles, or 0 for all of them
+ * @param[out] profile_iterator  The iterator of profile
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_get_profile_iterator()
+ */
+int connection_get_wifi_profile_iterator_by_strength(connection_h connection, int max_count,
+		connection_profile_iterator_h* profile_iterator);
+
 /**
  * @brief Moves the profile iterator to the next position and gets a profile handle.
  * @param[in] profile_iterator  The iterator of profile
@@ -400,6 +739,80 @@ bool connection_profile_iterator_has_next(connection_profile_iterator_h profile_
  */
 int connection_destroy_profile_iterator(connection_profile_iterator_h profile_iterator);
 
+/**
+ * @brief Sets the warm start file, which keeps the profile list across process starts.
+ * @details Every full enumeration of the profiles is saved to the file.
+ * After this call, the next connection_get_cached_profile_iterator() is served from the file.
+ * The file can also be set with the CONNECTION_WARM_START environment variable.
+ * @param[in] path  The path of the file, or NULL to stop using it
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_OPERATION  The file is being refreshed
+ * @see connection_get_cached_profile_iterator()
+ */
+int connection_set_warm_start_path(const char* path);
+
+/**
+ * @brief Gets a iterator of the profiles, served from the warm start file if the live list is not known yet.
+ * @details The first call after process start returns the profiles saved by the previous run,
+ * with @a is_stale set, and fetches the live list in the background.
+ * When it arrives, the callback set with connection_set_profile_list_refreshed_cb() is called,
+ * and later calls behave like connection_get_profile_iterator().
+ * @remarks @a profile_iterator must be released with connection_destroy_profile_iterator().
+ * @param[in] connection  The handle of connection
+ * @param[in] type  The type of connetion iterator
+ * @param[out] profile_iterator  The iterator of profile
+ * @param[out] is_stale  @c true if the profiles come from the warm start file and may be out of date
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_set_warm_start_path()
+ */
+int connection_get_cached_profile_iterator(connection_h connection, connection_iterator_type_e type,
+		connection_profile_iterator_h* profile_iterator, bool* is_stale);
+
+/**
+ * @brief Registers the callback called when the live profile list replaced the one of the warm start file.
+ * @param[in] connection  The handle of connection
+ * @param[in] callback  The callback function to be called
+ * @param[in] user_data The user data passed to the callback function
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_get_cached_profile_iterator()
+ */
+int connection_set_profile_list_refreshed_cb(connection_h connection,
+		connection_profile_list_refreshed_cb callback, void* user_data);
+
+/**
+ * @brief Unregisters the callback called when the live profile list replaced the one of the warm start file.
+ * @param[in] connection  The handle of connection
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ */
+int connection_unset_profile_list_refreshed_cb(connection_h connection);
+
+/**
+ * @brief Sets the state page, which shares the connection state between the processes of the device.
+ * @details The first process to open the page publishes the connection type, the addresses, the states
+ * of Wi-Fi and cellular and the connected profiles in it, and keeps them up to date.
+ * The other processes read them from the page without asking vconf or the network daemon.
+ * When the publisher goes away, another process takes over.
+ * The page can also be set with the CONNECTION_STATE_PAGE environment variable.
+ * @remarks The page is opened by the first connection_create() and closed with the last handle,
+ * so it must be set while no handle exists.
+ * @param[in] path  The path of the page, preferably on a memory file system, or NULL to stop using it
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_OPERATION  The page is in use
+ */
+int connection_set_state_page_path(const char* path);
+
 /**
  * @brief Gets the name of default profile.
  * @remarks @a profile must be released with connection_profile_destroy().
@@ -414,6 +827,37 @@ int connection_destroy_profile_iterator(connection_profile_iterator_h profile_it
  */
 int connection_get_current_profile(connection_h connection, connection_profile_h* profile);
 
+/**
+ * @brief Called to rank a connected profile in connection_get_best_profile().
+ * @param[in] info  The attributes of the profile
+ * @param[in] user_data The user data passed from connection_get_best_profile()
+ * @return The score of the profile, the higher the better, or a negative value to leave the profile out
+ * @see connection_get_best_profile()
+ */
+typedef int(*connection_profile_score_cb)(const connection_profile_score_info_s* info, void* user_data);
+
+/**
+ * @brief Gets the connected profile with the highest score.
+ * @details The profiles are ranked on the attributes the library already holds, and only the winner
+ * becomes a profile handle. Without @a score_cb, Ethernet comes first, then Wi-Fi by RSSI,
+ * then cellular by network type, with roaming cellular last.
+ * When several profiles have the same score, the first one the network daemon reports wins.
+ * @remarks @a profile must be released with connection_profile_destroy().
+ * @param[in] connection  The handle of connection
+ * @param[in] score_cb  The function ranking the profiles, or NULL for the default ranking
+ * @param[in] user_data The user data passed to @a score_cb
+ * @param[out] profile  The handle of the best profile
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER   Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @retval #CONNECTION_ERROR_NO_CONNECTION  No connected profile has a score
+ * @see connection_get_current_profile()
+ */
+int connection_get_best_profile(connection_h connection, connection_profile_score_cb score_cb,
+		void* user_data, connection_profile_h* profile);
+
 /**
  * @brief Opens the connection with the profile, asynchronously.
  * @param[in] connection  The handle of connection
@@ -450,6 +894,125 @@ int connection_open_cellular_service_type(connection_h connection, connection_ce
  */
 int connection_close_profile(connection_h connection, connection_profile_h profile);
 
+/**
+ * @brief Gets the memory held by the library on behalf of the process.
+ * @details A growing @a profiles count usually means profiles from connection_get_current_profile()
+ * or connection_profile_clone() are not released with connection_profile_destroy().
+ * @param[out] usage  The memory usage
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see connection_reset_memory_peak()
+ * @see connection_dump_live_handles()
+ */
+int connection_get_memory_usage(connection_memory_usage_s* usage);
+
+/**
+ * @brief Resets the high-water mark of the memory usage to the current usage.
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @see connection_get_memory_usage()
+ */
+int connection_reset_memory_peak(void);
+
+/**
+ * @brief Writes every live connection handle, profile handle, profile iterator and profile callback to the log.
+ * @details This is a debugging aid for tracking down leaked handles.
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @see connection_get_memory_usage()
+ */
+int connection_dump_live_handles(void);
+
+/**
+ * @brief Gets the changes of the profile list since a generation.
+ * @details The library numbers the states of the profile list it has seen with increasing generations.
+ * Pass 0 to get every profile as #CONNECTION_PROFILE_CHANGE_ADDED, then pass the returned @a generation
+ * to get only the profiles added, removed or changed since then.
+ * The changes are computed from the events the library receives, so the cost depends on the number of changes,
+ * not on the number of profiles.
+ * @remarks @a changes must be released with connection_free_profile_changes().
+ * The profiles of @a changes are valid until then; retain them with connection_profile_ref() to keep them longer.
+ * @param[in] connection  The handle of connection
+ * @param[in] since_generation  The generation of the previous call, or 0
+ * @param[out] generation  The current generation
+ * @param[out] changes  The changes
+ * @param[out] count  The number of changes
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_INVALID_OPERATION  @a since_generation is too old: call again with 0
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_free_profile_changes()
+ */
+int connection_get_profile_changes(connection_h connection, unsigned long long since_generation,
+		unsigned long long* generation, connection_profile_change_s** changes, int* count);
+
+/**
+ * @brief Releases the changes returned by connection_get_profile_changes().
+ * @param[in] changes  The changes
+ * @param[in] count  The number of changes
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see connection_get_profile_changes()
+ */
+int connection_free_profile_changes(connection_profile_change_s* changes, int count);
+
+/**
+ * @brief Gets a profile by its name.
+ * @details The lookup is served from the profile list the library keeps for connection_get_profile_changes().
+ * Only the first lookup reads the list from the daemon, later ones do not leave the process.
+ * @remarks @a profile must be released with connection_profile_destroy().
+ * @param[in] connection  The handle of connection
+ * @param[in] profile_name  The name of the profile, as returned by connection_profile_get_name()
+ * @param[out] profile  The handle of profile
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_NO_CONNECTION  No profile has the name
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_get_wifi_profile_by_essid()
+ * @see connection_get_wifi_profile_by_bssid()
+ */
+int connection_get_profile_by_name(connection_h connection, const char* profile_name, connection_profile_h* profile);
+
+/**
+ * @brief Gets a Wi-Fi profile by its ESSID.
+ * @details When several profiles have the ESSID, the connected one is returned, otherwise the one with the strongest signal.
+ * Like connection_get_profile_by_name(), only the first lookup reads the list from the daemon.
+ * @remarks @a profile must be released with connection_profile_destroy().
+ * @param[in] connection  The handle of connection
+ * @param[in] essid  The ESSID
+ * @param[out] profile  The handle of profile
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_NO_CONNECTION  No profile has the ESSID
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ */
+int connection_get_wifi_profile_by_essid(connection_h connection, const char* essid, connection_profile_h* profile);
+
+/**
+ * @brief Gets a Wi-Fi profile by the BSSID of its access point.
+ * @details The BSSID is compared without regard to case.
+ * Like connection_get_profile_by_name(), only the first lookup reads the list from the daemon.
+ * @remarks @a profile must be released with connection_profile_destroy().
+ * @param[in] connection  The handle of connection
+ * @param[in] bssid  The BSSID, such as "00:11:22:33:44:55"
+ * @param[out] profile  The handle of profile
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_NO_CONNECTION  No profile has the BSSID
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ */
+int connection_get_wifi_profile_by_bssid(connection_h connection, const char* bssid, connection_profile_h* profile);
+
 /**
  * @}
 */
@@ -461,7 +1024,15 @@ int connection_close_profile(connection_h connection, connection_profile_h profi
 
 /**
  * @brief Gets the statistics information.
- * @param[in] connection_type  The type of connection. CONNECTION_TYPE_WIFI and CONNECTION_TYPE_CELLULAR are only supported.
+ * @details The values are counted by the library from the kernel counters of the interface,
+ * and persist across connections and reboots. On first use, the Wi-Fi values start from those of
+ * the network daemon and the cellular values from those published in vconf. The daemon or vconf
+ * is only read directly when the kernel counters cannot be read.
+ * The last data restarts with each connection. The values are shared with the other processes
+ * once a minute and on every reset, so a reset made by another process shows within a minute.
+ * @remarks The Wi-Fi values used to be read from the network daemon at every call,
+ * so they may now differ from the counters the daemon keeps itself.
+ * @param[in] connection_type  The type of connection. CONNECTION_TYPE_WIFI, CONNECTION_TYPE_CELLULAR and CONNECTION_TYPE_ETHERNET are only supported.
  * @param[in] statistics_type  The type of statistics
  * @param[out] size  The received data size of the last cellular packet data connection (bytes)
  * @return 0 on success, otherwise negative error value.
@@ -471,9 +1042,24 @@ int connection_close_profile(connection_h connection, connection_profile_h profi
  */
 int connection_get_statistics(connection_type_e connection_type, connection_statistics_type_e statistics_type, long long* size);
 
+/**
+ * @brief Gets all statistics information of cellular, Wi-Fi and ethernet at once.
+ * @details The kernel counters of every connection type are read once.
+ * When they cannot be read, the last values counted by the library are reported,
+ * then the values connection_get_statistics() falls back to.
+ * The statistics of a connection type which cannot be read at all are 0, and not valid.
+ * @param[out] statistics  The statistics information
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Nothing is known of any connection type
+ * @see connection_get_statistics()
+ */
+int connection_get_all_statistics(connection_statistics_info_s* statistics);
+
 /**
  * @brief Resets the statistics information
- * @param[in] connection_type  The type of connection. CONNECTION_TYPE_WIFI and CONNECTION_TYPE_CELLULAR are only supported.
+ * @param[in] connection_type  The type of connection. CONNECTION_TYPE_WIFI, CONNECTION_TYPE_CELLULAR and CONNECTION_TYPE_ETHERNET are only supported.
  * @param[in] statistics_type  The type of statistics
  * @return 0 on success, otherwise negative error value.
  * @retval #CONNECTION_ERROR_NONE Successful
@@ -482,6 +1068,109 @@ int connection_get_statistics(connection_type_e connection_type, connection_stat
  */
 int connection_reset_statistics(connection_type_e connection_type, connection_statistics_type_e statistics_type);
 
+/**
+ * @brief Gets the statistics information of the network interface of a profile.
+ * @details The last data is counted by the kernel since the interface of the profile came up.
+ * The total data is the total of the connection type of the profile, as connection_get_statistics() returns it.
+ * @param[in] profile  The handle of profile
+ * @param[in] statistics_type  The type of statistics
+ * @param[out] size  The data size (bytes)
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_profile_get_network_interface_name()
+ */
+int connection_get_profile_statistics(connection_profile_h profile, connection_statistics_type_e statistics_type, long long* size);
+
+/**
+ * @brief Starts sampling the throughput of Wi-Fi, cellular and ethernet connections.
+ * @details There is only one sampler in a process. Each call adds a reference to it,
+ * and the shortest interval among the references is used. Sampling runs in the main loop.
+ * @remarks The sampler must be released with connection_stop_rate_sampling(), with the same interval.
+ * @param[in] interval  The sampling interval (milliseconds)
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_stop_rate_sampling()
+ * @see connection_get_statistics_rate()
+ */
+int connection_start_rate_sampling(int interval);
+
+/**
+ * @brief Releases a reference to the throughput sampler, and stops it when no reference is left.
+ * @details The sampler goes back to the shortest interval of the remaining references.
+ * @param[in] interval  The interval the reference was taken with (milliseconds)
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  No reference was taken with @a interval
+ * @retval #CONNECTION_ERROR_INVALID_OPERATION  The sampler is not running
+ * @see connection_start_rate_sampling()
+ */
+int connection_stop_rate_sampling(int interval);
+
+/**
+ * @brief Gets the current, average and peak throughput of a connection type.
+ * @details The average and the peak are computed over the samples of the last @a window seconds.
+ * The history is a fixed size ring buffer, so long windows are bounded by the sampling interval.
+ * This function never blocks the sampler.
+ * @param[in] connection_type  The type of connection. CONNECTION_TYPE_WIFI, CONNECTION_TYPE_CELLULAR and CONNECTION_TYPE_ETHERNET are only supported.
+ * @param[in] window  The window of the average and the peak (seconds)
+ * @param[out] rate  The throughput rates
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_INVALID_OPERATION  The sampler is not running
+ * @see connection_start_rate_sampling()
+ */
+int connection_get_statistics_rate(connection_type_e connection_type, int window, connection_statistics_rate_s* rate);
+
+/**
+ * @brief Called when a statistics counter crosses a threshold.
+ * @param[in] connection_type  The type of connection
+ * @param[in] statistics_type  The type of statistics
+ * @param[in] size  The data size when the threshold was crossed (bytes)
+ * @param[in] user_data The user data passed from the callback registration function
+ * @see connection_add_statistics_threshold()
+ */
+typedef void(*connection_statistics_threshold_cb)(connection_type_e connection_type,
+		connection_statistics_type_e statistics_type, long long size, void* user_data);
+
+/**
+ * @brief Registers a threshold on a statistics counter.
+ * @details The counters are checked on each tick of the throughput sampler, with one read of the
+ * kernel counters for all thresholds. The callback is called in the main loop, once when the counter
+ * reaches @a threshold. It is called again only after the counter was reset below @a threshold.
+ * @remarks The threshold holds a reference to the throughput sampler, which runs at least every second.
+ * The threshold must be released with connection_remove_statistics_threshold().
+ * @param[in] connection_type  The type of connection. CONNECTION_TYPE_WIFI, CONNECTION_TYPE_CELLULAR and CONNECTION_TYPE_ETHERNET are only supported.
+ * @param[in] statistics_type  The type of statistics
+ * @param[in] threshold  The threshold (bytes)
+ * @param[in] callback  The callback function to be called
+ * @param[in] user_data The user data passed to the callback function
+ * @param[out] threshold_id  The ID of the threshold
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval #CONNECTION_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval #CONNECTION_ERROR_OPERATION_FAILED  Operation failed
+ * @see connection_remove_statistics_threshold()
+ */
+int connection_add_statistics_threshold(connection_type_e connection_type, connection_statistics_type_e statistics_type,
+		long long threshold, connection_statistics_threshold_cb callback, void* user_data, int* threshold_id);
+
+/**
+ * @brief Removes a threshold on a statistics counter.
+ * @param[in] threshold_id  The ID of the threshold
+ * @return 0 on success, otherwise negative error value.
+ * @retval #CONNECTION_ERROR_NONE  Successful
+ * @retval #CONNECTION_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see connection_add_statistics_threshold()
+ */
+int connection_remove_statistics_threshold(int threshold_id);
+
 /**
  * @}
  */
@@ -19,6 +19,8 @@
 #ifndef __NET_CONNECTION_PRIVATE_H__        /* To prevent inclusion of a header file twice */
 #define __NET_CONNECTION_PRIVATE_H__
 
+#include <stdio.h>
+#include <arpa/inet.h>
 #include <dlog.h>
 #include <network-cm-intf.h>
 #include <network-wifi-intf.h>
@@ -37,6 +39,26 @@
 
 #define CONNECTION_MUTEX_UNLOCK _connection_inter_mutex_unlock()
 
+#define CONNECTION_STATISTICS_PROC_PATH "/proc/net/dev"
+#define CONNECTION_STATISTICS_STORAGE_DIR "/opt/usr/data/network"
+#define CONNECTION_STATISTICS_SYNC_INTERVAL 60
+#define CONNECTION_SAMPLER_HISTORY_MAX 256
+#define CONNECTION_SAMPLER_INTERVAL_MIN 100
+#define CONNECTION_THRESHOLD_SAMPLING_INTERVAL 1000
+#define CONNECTION_CAPTURE_ENV "CONNECTION_EVENT_CAPTURE"
+#define CONNECTION_CAPTURE_MAGIC 0x56454e43
+#define CONNECTION_CAPTURE_VERSION 1
+#define CONNECTION_TRACKER_REMOVED_MAX 64
+#define CONNECTION_WARM_START_ENV "CONNECTION_WARM_START"
+#define CONNECTION_WARM_START_MAGIC 0x4d524157
+#define CONNECTION_WARM_START_VERSION 1
+#define CONNECTION_STATE_PAGE_ENV "CONNECTION_STATE_PAGE"
+#define CONNECTION_STATE_PAGE_MAGIC 0x45474150
+#define CONNECTION_STATE_PAGE_VERSION 1
+#define CONNECTION_STATE_PAGE_PROFILE_MAX 4
+#define CONNECTION_STATE_PAGE_READ_RETRY 64
+#define CONNECTION_STATE_PAGE_CHECK_INTERVAL 1000
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -46,22 +68,171 @@ typedef struct _connection_handle_s
 	connection_type_changed_cb state_changed_callback;
 	connection_address_changed_cb ip_changed_callback;
 	connection_address_changed_cb proxy_changed_callback;
+	connection_interface_address_changed_cb interface_address_changed_callback;
+	connection_ethernet_state_changed_cb ethernet_state_changed_callback;
+	connection_profile_list_refreshed_cb profile_list_refreshed_callback;
+	connection_dns_servers_changed_cb dns_servers_changed_callback;
 	void *state_changed_user_data;
 	void *ip_changed_user_data;
 	void *proxy_changed_user_data;
+	void *interface_address_changed_user_data;
+	void *ethernet_state_changed_user_data;
+	void *profile_list_refreshed_user_data;
+	void *dns_servers_changed_user_data;
 } connection_handle_s;
 
+typedef enum
+{
+	CONNECTION_MEMORY_HANDLE = 0,
+	CONNECTION_MEMORY_PROFILE,
+	CONNECTION_MEMORY_ITERATOR,
+	CONNECTION_MEMORY_CALLBACK,
+	CONNECTION_MEMORY_MAX,
+} connection_memory_type_e;
+
+typedef enum
+{
+	CONNECTION_STATISTICS_DIRECTION_RX = 0,
+	CONNECTION_STATISTICS_DIRECTION_TX = 1,
+	CONNECTION_STATISTICS_DIRECTION_MAX,
+} connection_statistics_direction_e;
+
+typedef struct _connection_statistics_counter_s
+{
+	unsigned int ifindex;
+	unsigned long long raw[CONNECTION_STATISTICS_DIRECTION_MAX];
+	unsigned long long last[CONNECTION_STATISTICS_DIRECTION_MAX];
+	unsigned long long total[CONNECTION_STATISTICS_DIRECTION_MAX];
+} connection_statistics_counter_s;
+
+/* Event capture file: a header, then one record per event followed by
+ * the profile name (not terminated) and the event payload. */
+typedef struct _connection_capture_header_s
+{
+	unsigned int magic;
+	unsigned int version;
+} connection_capture_header_s;
+
+typedef struct _connection_capture_record_s
+{
+	unsigned long long timestamp;
+	unsigned int event;
+	int error;
+	unsigned int name_length;
+	unsigned int data_length;
+} connection_capture_record_s;
+
+/* Warm start file: a header, then the profiles as they are in memory, so it is used mapped */
+typedef struct _connection_warm_start_header_s
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int record_size;
+	unsigned int count;
+	long long saved_time;
+} connection_warm_start_header_s;
+
+/* The global facts every process reads from vconf, as the keys hold them */
+typedef struct _connection_state_facts_s
+{
+	int network_status;
+	int wifi_state;
+	int cellular_state;
+	char ip_address[INET6_ADDRSTRLEN];
+	char proxy_address[NET_PROXY_LEN_MAX+1];
+} connection_state_facts_s;
+
+/* State page: one process publishes under the sequence, the others read it lock-free.
+ * The publisher holds an exclusive flock() on the file for as long as it publishes. */
+typedef struct _connection_state_page_s
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int size;
+	volatile int sequence;
+	/* The process publishing the page, 0 while nobody does */
+	int publisher;
+	connection_state_facts_s facts;
+	int has_current_profile;
+	net_profile_info_t current_profile;
+	int connected_count;
+	net_profile_info_t connected_profiles[CONNECTION_STATE_PAGE_PROFILE_MAX];
+} connection_state_page_s;
+
+/* What connection_get_snapshot() copies, kept up to date by the event handlers */
+typedef struct _connection_snapshot_state_s
+{
+	unsigned int version;
+	connection_state_facts_s facts;
+	connection_ethernet_state_e ethernet_state;
+	bool has_profile;
+	connection_profile_type_e profile_type;
+	connection_profile_state_e profile_state;
+	char profile_name[NET_PROFILE_NAME_LEN_MAX+1];
+	char interface_name[NET_MAX_DEVICE_NAME_LEN+1];
+	/* Parsed from facts.proxy_address whenever it or the profile changes */
+	connection_proxy_endpoint_s proxy;
+	connection_dns_servers_s dns_servers;
+} connection_snapshot_state_s;
+
+typedef struct _connection_netlink_link_s
+{
+	unsigned int ifindex;
+	unsigned int flags;
+	char name[NET_MAX_DEVICE_NAME_LEN+1];
+	unsigned long long counters[CONNECTION_STATISTICS_DIRECTION_MAX];
+	bool counters_32bit;
+} connection_netlink_link_s;
+
+typedef enum
+{
+	CONNECTION_NETLINK_EVENT_LINK = 0,
+	CONNECTION_NETLINK_EVENT_ADDRESS = 1,
+} connection_netlink_event_e;
+
+typedef enum
+{
+	CONNECTION_TRACKER_KEY_NAME = 0,
+	CONNECTION_TRACKER_KEY_ESSID = 1,
+	CONNECTION_TRACKER_KEY_BSSID = 2,
+} connection_tracker_key_e;
+
+typedef struct _connection_netlink_interface_s
+{
+	unsigned int ifindex;
+	unsigned int flags;
+	char name[NET_MAX_DEVICE_NAME_LEN+1];
+	char ipv4_address[INET_ADDRSTRLEN];
+	char ipv6_address[INET6_ADDRSTRLEN];
+} connection_netlink_interface_s;
+
+typedef void (*connection_netlink_monitor_cb)(connection_netlink_event_e event,
+		const connection_netlink_interface_s *interface);
+
+typedef void (*connection_ethernet_monitor_cb)(connection_ethernet_state_e state);
+
+typedef void (*connection_warm_start_cb)(void);
+
+typedef void (*connection_snapshot_dns_cb)(const connection_dns_servers_s *servers);
+
 
 bool _connection_libnet_init(void);
 bool _connection_libnet_deinit(void);
-bool _connection_libnet_get_ethernet_state(connection_ethernet_state_e* state);
+int _connection_libnet_register(void);
 bool _connection_libnet_check_profile_validity(connection_profile_h profile);
 int _connection_libnet_get_profile_iterator(connection_iterator_type_e type,
 				connection_profile_iterator_h* profile_iterator);
+int _connection_libnet_get_wifi_iterator_by_strength(int max_count,
+				connection_profile_iterator_h* profile_iterator);
 bool _connection_libnet_iterator_has_next(connection_profile_iterator_h profile_iterator);
+int _connection_libnet_new_profile_iterator(connection_iterator_type_e type, net_profile_info_t *profiles,
+				int count, connection_profile_iterator_h* profile_iter_h);
 int _connection_libnet_get_iterator_next(connection_profile_iterator_h profile_iter_h, connection_profile_h *profile);
 int _connection_libnet_destroy_iterator(connection_profile_iterator_h profile_iter_h);
 int _connection_libnet_get_current_profile(connection_profile_h *profile);
+int _connection_libnet_get_active_profile_info(net_profile_info_t *profile_info);
+int _connection_libnet_get_connected_profiles(net_profile_info_t **profiles, int *count);
+net_dev_info_t *_connection_libnet_get_net_info(net_profile_info_t *profile_info);
 int _connection_libnet_open_profile(connection_profile_h profile);
 int _connection_libnet_open_cellular_service_type(connection_cellular_service_type_e type, connection_profile_h *profile);
 int _connection_libnet_close_profile(connection_profile_h profile);
@@ -71,13 +242,137 @@ bool _connection_libnet_add_to_profile_cb_list(connection_profile_h profile,
 		connection_profile_state_changed_cb callback, void *user_data);
 void _connection_libnet_remove_from_profile_cb_list(connection_profile_h profile);
 int _connection_libnet_set_statistics(net_device_t device_type, net_statistics_type_e statistics_type);
-int _connection_libnet_get_statistics(net_statistics_type_e statistics_type, unsigned long long *size);
+int _connection_libnet_get_statistics(net_device_t device_type, net_statistics_type_e statistics_type, unsigned long long *size);
+bool _connection_libnet_get_interface_name(net_device_t device_type, char *interface_name);
+void _connection_libnet_dump_handles(void);
+connection_profile_h _connection_libnet_new_profile(const net_profile_info_t *profile_info,
+		connection_memory_type_e memory_type);
+connection_profile_h _connection_libnet_clone_profile(connection_profile_h profile,
+		connection_memory_type_e memory_type);
+net_profile_info_t *_connection_libnet_read_profile_info(connection_profile_h profile,
+		net_profile_info_t *profile_info);
+/* Writes a field of a copy from _connection_libnet_read_profile_info() back into the profile */
+int _connection_libnet_modify_profile(connection_profile_h profile,
+		const net_profile_info_t *profile_info, const void *field, size_t size);
+void _connection_libnet_ref_profile(connection_profile_h profile);
+void _connection_libnet_unref_profile(connection_profile_h profile);
+bool _connection_libnet_retain_profile(connection_profile_h profile);
+bool _connection_libnet_release_profile(connection_profile_h profile);
+
+int _connection_statistics_read_interfaces(const char *path, int count, const char *interface_names[],
+				unsigned int ifindex[], unsigned long long counters[][CONNECTION_STATISTICS_DIRECTION_MAX]);
+int _connection_statistics_read_links(int count, const char *interface_names[], unsigned int ifindex[],
+				unsigned long long counters[][CONNECTION_STATISTICS_DIRECTION_MAX], bool counters_32bit[]);
+int _connection_statistics_read_counters(const char *path, const char *interface_name,
+				unsigned long long counters[]);
+void _connection_statistics_accumulate(connection_statistics_counter_s *counter,
+				unsigned int ifindex, const unsigned long long counters[], bool counters_32bit);
+int _connection_statistics_get(net_device_t device_type,
+				connection_statistics_type_e statistics_type, unsigned long long *size);
+int _connection_statistics_get_devices(int count, const net_device_t device_types[],
+				connection_statistics_counter_s counters[], int results[]);
+int _connection_statistics_feed(net_device_t device_type, const char *interface_name,
+				unsigned int ifindex, const unsigned long long counters[], bool counters_32bit,
+				connection_statistics_counter_s *counter);
+int _connection_statistics_reset(net_device_t device_type, connection_statistics_type_e statistics_type);
+void _connection_statistics_start_session(net_device_t device_type, const char *interface_name);
+int _connection_statistics_get_interface(const char *interface_name,
+				connection_statistics_direction_e direction, unsigned long long *size);
+
+int _connection_netlink_dump_links(connection_netlink_link_s **links, int *count);
+int _connection_netlink_monitor_start(connection_netlink_monitor_cb callback);
+int _connection_netlink_monitor_stop(connection_netlink_monitor_cb callback);
+bool _connection_netlink_monitor_get_interface(const char *interface_name,
+				connection_netlink_interface_s *interface);
+
+int _connection_ethernet_get_state(connection_ethernet_state_e *state);
+void _connection_ethernet_update(const char *profile_name, net_profile_info_t *profile_info,
+				connection_profile_state_e state);
+void _connection_ethernet_invalidate(void);
+int _connection_ethernet_monitor_start(connection_ethernet_monitor_cb callback);
+int _connection_ethernet_monitor_stop(connection_ethernet_monitor_cb callback);
+
+int _connection_warm_start_set_path(const char *path);
+void _connection_warm_start_save(int list_count, net_profile_info_t *profiles[], int counts[]);
+int _connection_warm_start_get_iterator(connection_iterator_type_e type,
+				connection_profile_iterator_h *profile_iterator, bool *is_stale);
+int _connection_warm_start_watch(connection_warm_start_cb callback);
+int _connection_warm_start_unwatch(connection_warm_start_cb callback);
+void _connection_warm_start_stop(void);
+
+int _connection_state_page_set_path(const char *path);
+void _connection_state_page_open(void);
+void _connection_state_page_close(void);
+void _connection_state_page_update_profiles(void);
+void _connection_state_page_load_facts(connection_state_facts_s *facts);
+bool _connection_state_page_get_facts(connection_state_facts_s *facts);
+int _connection_state_page_get_current_profile(net_profile_info_t *profile_info);
+int _connection_state_page_get_connected_profiles(net_profile_info_t **profiles, int *count);
+
+int _connection_snapshot_get(connection_snapshot_state_s *state);
+int _connection_snapshot_get_proxy(connection_proxy_endpoint_s *proxy);
+int _connection_snapshot_get_dns_servers(connection_dns_servers_s *servers);
+int _connection_snapshot_watch_dns(connection_snapshot_dns_cb callback);
+int _connection_snapshot_unwatch_dns(connection_snapshot_dns_cb callback);
+void _connection_snapshot_update_profile(void);
+void _connection_snapshot_open(void);
+void _connection_snapshot_clear(void);
+
+int _connection_socket_bind(int socket_fd, int family, bool is_bound, net_dev_info_t *net_info);
+
+int _connection_selection_get_best_profile(connection_profile_score_cb score_cb, void *user_data,
+				connection_profile_h *profile);
+
+int _connection_tracker_get_changes(unsigned long long since_generation, unsigned long long *generation,
+				connection_profile_change_s **changes, int *count);
+void _connection_tracker_free_changes(connection_profile_change_s *changes, int count);
+int _connection_tracker_find_profile(connection_tracker_key_e key_type, const char *key,
+				connection_profile_h *profile);
+void _connection_tracker_update(const char *profile_name, net_profile_info_t *profile_info,
+				connection_profile_state_e state);
+void _connection_tracker_refresh(void);
+void _connection_tracker_clear(void);
+
+void _connection_memory_add(connection_memory_type_e type, int count, long long bytes);
+void _connection_memory_get_usage(connection_memory_usage_s *usage);
+void _connection_memory_reset_peak(void);
+
+int _connection_capture_start(const char *path);
+void _connection_capture_stop(void);
+void _connection_capture_event(const net_event_info_t *event_info);
+int _connection_capture_read_header(FILE *fp);
+int _connection_capture_read_event(FILE *fp, unsigned long long *timestamp, net_event_info_t *event_info);
 
 net_service_type_t _connection_profile_convert_to_libnet_cellular_service_type(connection_cellular_service_type_e svc_type);
 net_state_type_t _connection_profile_convert_to_net_state(connection_profile_state_e state);
+connection_profile_state_e _connection_profile_convert_to_cp_state(net_state_type_t state);
+connection_cellular_network_type_e _connection_profile_convert_to_cp_network_type(net_pdp_type_t type);
+void _connection_profile_get_dns_servers(net_dev_info_t *net_info, connection_dns_servers_s *servers);
+int _connection_convert_net_state(int status);
+int _connection_convert_cellular_state(int status);
+int _connection_convert_wifi_state(int status);
+
+int _connection_sampler_start(int interval);
+int _connection_sampler_stop(int interval);
+int _connection_sampler_get_rate(net_device_t device_type, int window, connection_statistics_rate_s *rate);
+
+int _connection_threshold_add(connection_type_e connection_type, net_device_t device_type,
+				connection_statistics_type_e statistics_type, unsigned long long threshold,
+				connection_statistics_threshold_cb callback, void *user_data, int *threshold_id);
+int _connection_threshold_remove(int threshold_id);
+bool _connection_threshold_is_set(net_device_t device_type);
+void _connection_threshold_check(net_device_t device_type, const connection_statistics_counter_s *counter);
 
 void _connection_inter_mutex_lock(void);
 void _connection_inter_mutex_unlock(void);
+/* The lock is only counted in builds with CONNECTION_LOCK_STATS, the others report 0 */
+void _connection_inter_mutex_get_stats(long long *acquisitions, long long *contentions, long long *wait_time);
+void _connection_inter_mutex_reset_stats(void);
+void _connection_seqlock_write_begin(volatile int *sequence);
+void _connection_seqlock_write_end(volatile int *sequence);
+int _connection_seqlock_read_begin(volatile int *sequence);
+bool _connection_seqlock_try_read_begin(volatile int *sequence, int *seq);
+bool _connection_seqlock_read_retry(volatile int *sequence, int seq);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CONNECTION_MOCK_H__
+#define __CONNECTION_MOCK_H__
+
+#include <network-cm-intf.h>
+#include <vconf/vconf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * @brief Clears every profile, vconf key, statistics counter, latency, injected error, call count and pending event.
+ * @details The registered client and vconf notifications are kept.
+ */
+void connection_mock_reset(void);
+
+/**
+ * @brief Adds a profile to the mock network daemon, or replaces the profile with the same name.
+ * @return NET_ERR_NONE on success, otherwise a negative net_err_t value.
+ */
+int connection_mock_add_profile(const net_profile_info_t *profile_info);
+
+/**
+ * @brief Sets the delay of every network daemon call (microseconds), to stand in for the D-Bus round trip.
+ */
+void connection_mock_set_latency(int usec);
+
+/**
+ * @brief Makes the network daemon call named @a function fail with @a error. NET_ERR_NONE clears it.
+ */
+void connection_mock_set_error(const char *function, int error);
+
+/**
+ * @brief Sets a statistics counter kept by the mock network daemon.
+ */
+void connection_mock_set_statistics(net_device_t device_type,
+		net_statistics_type_e statistics_type, unsigned long long size);
+
+/**
+ * @brief Queues a network daemon event for a profile.
+ * @details The event is delivered to the registered client from the main loop after @a delay
+ * milliseconds, or by connection_mock_dispatch_events(). Successful open events set the profile
+ * online, successful close events set it idle and state events set it to @a state.
+ */
+void connection_mock_queue_event(int delay, net_event_t event, net_err_t error,
+		const char *profile_name, net_state_type_t state);
+
+/**
+ * @brief Delivers @a event_info to the registered client as is, synchronously.
+ * @details Unlike queued events it leaves the mock profiles untouched. Used to replay captured events.
+ * @return NET_ERR_NONE on success, NET_ERR_APP_NOT_REGISTERED if no client is registered.
+ */
+int connection_mock_deliver_event(const net_event_info_t *event_info);
+
+/**
+ * @brief Delivers every pending event and vconf notification now, in order.
+ * @return The number of delivered events.
+ */
+int connection_mock_dispatch_events(void);
+
+/**
+ * @brief Gets the number of queued events and vconf notifications not delivered yet.
+ */
+int connection_mock_get_pending_events(void);
+
+/**
+ * @brief Gets how many times the backend function named @a function was called since the last reset.
+ */
+int connection_mock_get_call_count(const char *function);
+
+/**
+ * @brief Runs one script command.
+ * @details Commands:
+ * reset
+ * latency <usec>
+ * error <function> <net_err_t value>
+ * profile wifi <name> <ifname> <state> <essid> [ip] [strength] [bssid]
+ * profile cellular <name> <ifname> <state> <apn> <internet|mms|wap|prepaid_internet|prepaid_mms> [ip]
+ * profile ethernet <name> <ifname> <state> [ip]
+ * vconf int <key> <value>
+ * vconf str <key> <value>
+ * statistics <wifi|cellular> <last_rx|last_tx|total_rx|total_tx> <bytes>
+ * event <delay ms> <open_rsp|open_ind|close_rsp|close_ind|scan_ind> <profile> [net_err_t value]
+ * event <delay ms> state_ind <profile> <state>
+ * where <state> is idle, failure, association, configuration, ready, online or disconnect.
+ * Empty lines and lines starting with # are ignored.
+ * @return NET_ERR_NONE on success, otherwise NET_ERR_INVALID_PARAM.
+ */
+int connection_mock_run_command(const char *command);
+
+/**
+ * @brief Runs every command of a script file.
+ * @return NET_ERR_NONE on success, otherwise the error of the first failing line.
+ */
+int connection_mock_load_script(const char *path);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
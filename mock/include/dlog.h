@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Stand-in for dlog, used by the mock backend build only */
+
+#ifndef __DLOG_H__
+#define __DLOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef enum
+{
+	LOG_UNKNOWN = 0,
+	LOG_DEFAULT,
+	LOG_VERBOSE,
+	LOG_DEBUG,
+	LOG_INFO,
+	LOG_WARN,
+	LOG_ERROR,
+	LOG_FATAL,
+	LOG_SILENT,
+} log_priority;
+
+/* Printed to stderr when CONNECTION_MOCK_LOG is set in the environment */
+int __dlog_print(log_priority prio, const char *tag, const char *fmt, ...);
+
+#define SLOG(priority, tag, format, arg...) __dlog_print(priority, tag, format, ##arg)
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
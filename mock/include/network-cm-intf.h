@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * Stand-in for the libnet connection manager interface, used by the mock backend build only.
+ * It declares the subset of the network daemon client API this library uses.
+ */
+
+#ifndef __NETWORK_CM_INTF_H__
+#define __NETWORK_CM_INTF_H__
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define NET_PROFILE_NAME_LEN_MAX	512
+#define NET_MAX_DEVICE_NAME_LEN		32
+#define NET_DNS_ADDR_MAX		2
+#define NET_PROXY_LEN_MAX		64
+#define NET_MAX_MAC_ADDR_LEN		32
+#define NET_WLAN_ESSID_LEN		128
+#define NETPM_WLAN_MAX_PSK_PASSPHRASE_LEN	65
+#define NET_PDP_APN_LEN_MAX		100
+#define NET_PDP_AUTH_USERNAME_LEN_MAX	32
+#define NET_PDP_AUTH_PASSWORD_LEN_MAX	32
+#define NET_HOME_URL_LEN_MAX		512
+
+typedef enum
+{
+	NET_ERR_NONE = 0,
+	NET_ERR_UNKNOWN = -999,
+	NET_ERR_APP_ALREADY_REGISTERED = -990,
+	NET_ERR_APP_NOT_REGISTERED = -989,
+	NET_ERR_NO_ACTIVE_CONNECTIONS = -988,
+	NET_ERR_ACTIVE_CONNECTION_EXISTS = -987,
+	NET_ERR_CONNECTION_DHCP_FAILED = -986,
+	NET_ERR_CONNECTION_INVALID_KEY = -985,
+	NET_ERR_IN_PROGRESS = -984,
+	NET_ERR_OPERATION_ABORTED = -983,
+	NET_ERR_TIME_OUT = -982,
+	NET_ERR_UNKNOWN_METHOD = -981,
+	NET_ERR_NO_SERVICE = -980,
+	NET_ERR_INVALID_PARAM = -979,
+	NET_ERR_INVALID_OPERATION = -978,
+	NET_ERR_ALREADY_EXISTS = -977,
+} net_err_t;
+
+typedef enum
+{
+	NET_DEVICE_UNKNOWN = 0,
+	NET_DEVICE_DEFAULT,
+	NET_DEVICE_CELLULAR,
+	NET_DEVICE_WIFI,
+	NET_DEVICE_USB,
+	NET_DEVICE_ETHERNET,
+	NET_DEVICE_MAX,
+} net_device_t;
+
+typedef enum
+{
+	NET_STATE_TYPE_UNKNOWN = 0,
+	NET_STATE_TYPE_IDLE,
+	NET_STATE_TYPE_FAILURE,
+	NET_STATE_TYPE_ASSOCIATION,
+	NET_STATE_TYPE_CONFIGURATION,
+	NET_STATE_TYPE_READY,
+	NET_STATE_TYPE_ONLINE,
+	NET_STATE_TYPE_DISCONNECT,
+} net_state_type_t;
+
+typedef enum
+{
+	NET_SERVICE_UNKNOWN = 0,
+	NET_SERVICE_INTERNET,
+	NET_SERVICE_MMS,
+	NET_SERVICE_WAP,
+	NET_SERVICE_PREPAID_INTERNET,
+	NET_SERVICE_PREPAID_MMS,
+} net_service_type_t;
+
+typedef enum
+{
+	NET_IP_CONFIG_TYPE_STATIC = 1,
+	NET_IP_CONFIG_TYPE_DYNAMIC,
+	NET_IP_CONFIG_TYPE_AUTO_IP,
+	NET_IP_CONFIG_TYPE_FIXED,
+	NET_IP_CONFIG_TYPE_OFF,
+} net_ip_config_type_t;
+
+typedef enum
+{
+	NET_PROXY_TYPE_DIRECT = 1,
+	NET_PROXY_TYPE_AUTO,
+	NET_PROXY_TYPE_MANUAL,
+	NET_PROXY_TYPE_UNKNOWN,
+} net_proxy_type_t;
+
+typedef enum
+{
+	NET_PDP_TYPE_NONE = 0,
+	NET_PDP_TYPE_GPRS,
+	NET_PDP_TYPE_EDGE,
+	NET_PDP_TYPE_UMTS,
+} net_pdp_type_t;
+
+typedef enum
+{
+	NET_PDP_AUTH_NONE = 0,
+	NET_PDP_AUTH_PAP,
+	NET_PDP_AUTH_CHAP,
+} net_auth_type_t;
+
+typedef enum
+{
+	NET_ADDR_IPV4 = 0,
+	NET_ADDR_IPV6,
+} net_addr_type_t;
+
+typedef enum
+{
+	NET_STATISTICS_TYPE_LAST_RECEIVED_DATA = 0,
+	NET_STATISTICS_TYPE_LAST_SENT_DATA,
+	NET_STATISTICS_TYPE_TOTAL_RECEIVED_DATA,
+	NET_STATISTICS_TYPE_TOTAL_SENT_DATA,
+} net_statistics_type_e;
+
+typedef enum
+{
+	NET_EVENT_OPEN_RSP = 0,
+	NET_EVENT_CLOSE_RSP,
+	NET_EVENT_OPEN_IND,
+	NET_EVENT_CLOSE_IND,
+	NET_EVENT_NET_STATE_IND,
+	NET_EVENT_IP_CHANGE_IND,
+	NET_EVENT_WIFI_POWER_IND,
+	NET_EVENT_WIFI_POWER_RSP,
+	NET_EVENT_WIFI_SCAN_IND,
+	NET_EVENT_WIFI_SCAN_RSP,
+	NET_EVENT_WIFI_WPS_RSP,
+	NET_EVENT_LAST,
+} net_event_t;
+
+typedef struct
+{
+	net_addr_type_t Type;
+	union {
+		struct in_addr Ipv4;
+		struct in6_addr Ipv6;
+	} Data;
+} net_addr_t;
+
+typedef struct
+{
+	char ProfileName[NET_PROFILE_NAME_LEN_MAX+1];
+	char DevName[NET_MAX_DEVICE_NAME_LEN+1];
+	int DnsCount;
+	net_addr_t DnsAddr[NET_DNS_ADDR_MAX];
+	net_ip_config_type_t IpConfigType;
+	net_addr_t IpAddr;
+	char BNetmask;
+	net_addr_t SubnetMask;
+	char BDefGateway;
+	net_addr_t GatewayAddr;
+	net_proxy_type_t ProxyMethod;
+	char ProxyAddr[NET_PROXY_LEN_MAX+1];
+	char MacAddr[NET_MAX_MAC_ADDR_LEN+1];
+} net_dev_info_t;
+
+typedef struct
+{
+	net_auth_type_t AuthType;
+	char UserName[NET_PDP_AUTH_USERNAME_LEN_MAX+1];
+	char Password[NET_PDP_AUTH_PASSWORD_LEN_MAX+1];
+} net_auth_info_t;
+
+typedef struct
+{
+	net_pdp_type_t ProtocolType;
+	net_service_type_t ServiceType;
+	char Apn[NET_PDP_APN_LEN_MAX+1];
+	net_auth_info_t AuthInfo;
+	char HomeURL[NET_HOME_URL_LEN_MAX+1];
+	char Mcc[4];
+	char Mnc[4];
+	int IsStatic;
+	int Roaming;
+	int SetupRequired;
+	net_dev_info_t net_info;
+} net_pdp_profile_info_t;
+
+typedef struct
+{
+	net_dev_info_t net_info;
+} net_eth_profile_info_t;
+
+typedef struct
+{
+	char ProfileName[NET_PROFILE_NAME_LEN_MAX+1];
+} net_profile_name_t;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#include <network-wifi-intf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef union
+{
+	net_pdp_profile_info_t Pdp;
+	net_wifi_profile_info_t Wlan;
+	net_eth_profile_info_t Ethernet;
+} net_profile_info_union_t;
+
+typedef struct
+{
+	net_device_t profile_type;
+	char ProfileName[NET_PROFILE_NAME_LEN_MAX+1];
+	net_profile_info_union_t ProfileInfo;
+	net_state_type_t ProfileState;
+	int Favourite;
+} net_profile_info_t;
+
+typedef struct
+{
+	net_event_t Event;
+	net_err_t Error;
+	char ProfileName[NET_PROFILE_NAME_LEN_MAX+1];
+	int Datalength;
+	void *Data;
+} net_event_info_t;
+
+typedef void (*net_event_cb_t)(const net_event_info_t *net_event, void *user_data);
+
+int net_register_client_ext(net_event_cb_t event_cb, net_device_t client_type, void *user_data);
+int net_deregister_client_ext(net_device_t client_type);
+int net_get_profile_list(net_device_t device_type, net_profile_info_t **profile_list, int *count);
+int net_get_profile_info(const char *profile_name, net_profile_info_t *prof_info);
+int net_get_active_net_info(net_profile_info_t *active_profile_info);
+int net_open_connection_with_profile(const char *profile_name);
+int net_open_connection_with_preference_ext(net_service_type_t service_type, net_profile_name_t *prof_name);
+int net_close_connection(const char *profile_name);
+int net_add_profile(net_service_type_t network_type, net_profile_info_t *prof_info);
+int net_delete_profile(const char *profile_name);
+int net_modify_profile(const char *profile_name, net_profile_info_t *prof_info);
+int net_get_statistics(net_device_t device_type, net_statistics_type_e statistics_type, unsigned long long *size);
+int net_set_statistics(net_device_t device_type, net_statistics_type_e statistics_type);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Stand-in for the libnet Wi-Fi interface, used by the mock backend build only */
+
+/* Outside the guard: network-cm-intf.h includes this header after its own base types */
+#include <network-cm-intf.h>
+
+#ifndef __NETWORK_WIFI_INTF_H__
+#define __NETWORK_WIFI_INTF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef enum
+{
+	WLAN_SEC_MODE_NONE = 1,
+	WLAN_SEC_MODE_WEP,
+	WLAN_SEC_MODE_IEEE8021X,
+	WLAN_SEC_MODE_WPA_PSK,
+	WLAN_SEC_MODE_WPA2_PSK,
+} wlan_security_mode_type_t;
+
+typedef enum
+{
+	WLAN_ENC_MODE_NONE = 1,
+	WLAN_ENC_MODE_WEP,
+	WLAN_ENC_MODE_TKIP,
+	WLAN_ENC_MODE_AES,
+	WLAN_ENC_MODE_TKIP_AES_MIXED,
+} wlan_encryption_mode_type_t;
+
+typedef enum
+{
+	NETPM_WLAN_CONNMODE_AUTO = 1,
+	NETPM_WLAN_CONNMODE_ADHOC,
+	NETPM_WLAN_CONNMODE_INFRA,
+} wlan_connection_mode_type_t;
+
+typedef struct
+{
+	char pskKey[NETPM_WLAN_MAX_PSK_PASSPHRASE_LEN+1];
+} wlan_psk_info_t;
+
+typedef struct
+{
+	wlan_security_mode_type_t sec_mode;
+	wlan_encryption_mode_type_t enc_mode;
+	union {
+		wlan_psk_info_t psk;
+	} authentication;
+	int wps_support;
+} wlan_security_info_t;
+
+typedef struct
+{
+	net_dev_info_t net_info;
+	char essid[NET_WLAN_ESSID_LEN+1];
+	char bssid[NET_MAX_MAC_ADDR_LEN+1];
+	unsigned char Strength;
+	unsigned int frequency;
+	unsigned int max_rate;
+	wlan_connection_mode_type_t wlan_mode;
+	char PassphraseRequired;
+	wlan_security_info_t security_info;
+} net_wifi_profile_info_t;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Stand-in for capi-base-common, used by the mock backend build only */
+
+#ifndef __TIZEN_ERROR_H__
+#define __TIZEN_ERROR_H__
+
+#include <errno.h>
+
+#define TIZEN_ERROR_NONE			0
+#define TIZEN_ERROR_INVALID_PARAMETER		(-EINVAL)
+#define TIZEN_ERROR_OUT_OF_MEMORY		(-ENOMEM)
+#define TIZEN_ERROR_INVALID_OPERATION		(-ENOSYS)
+#define TIZEN_ERROR_ADDRESS_FAMILY_NOT_SUPPORTED	(-EAFNOSUPPORT)
+#define TIZEN_ERROR_NETWORK_CLASS		(-0x00600000)
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Stand-in for the vconf keys of the network daemon, used by the mock backend build only */
+
+#ifndef __VCONF_KEYS_H__
+#define __VCONF_KEYS_H__
+
+#define VCONFKEY_NETWORK_STATUS			"memory/dnet/status"
+#define VCONFKEY_NETWORK_IP			"memory/dnet/ip"
+#define VCONFKEY_NETWORK_PROXY			"memory/dnet/proxy"
+#define VCONFKEY_NETWORK_CELLULAR_STATE		"memory/dnet/state"
+#define VCONFKEY_NETWORK_WIFI_STATE		"memory/wifi/state"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT	"db/dnet/statistics/cellular/lastsnt"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV	"db/dnet/statistics/cellular/lastrcv"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT	"db/dnet/statistics/cellular/totalsnt"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV	"db/dnet/statistics/cellular/totalrcv"
+
+enum {
+	VCONFKEY_NETWORK_OFF = 0,
+	VCONFKEY_NETWORK_CELLULAR,
+	VCONFKEY_NETWORK_WIFI,
+};
+
+enum {
+	VCONFKEY_NETWORK_CELLULAR_ON = 0,
+	VCONFKEY_NETWORK_CELLULAR_3G_OPTION_OFF,
+	VCONFKEY_NETWORK_CELLULAR_ROAMING_OFF,
+	VCONFKEY_NETWORK_CELLULAR_FLIGHT_MODE,
+	VCONFKEY_NETWORK_CELLULAR_NO_SERVICE,
+};
+
+enum {
+	VCONFKEY_NETWORK_WIFI_OFF = 0,
+	VCONFKEY_NETWORK_WIFI_NOT_CONNECTED,
+	VCONFKEY_NETWORK_WIFI_CONNECTED,
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Stand-in for vconf, used by the mock backend build only */
+
+#ifndef __VCONF_H__
+#define __VCONF_H__
+
+#include <vconf/vconf-keys.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct _keynode_t keynode_t;
+
+typedef void (*vconf_callback_fn)(keynode_t *node, void *user_data);
+
+int vconf_get_int(const char *in_key, int *intval);
+int vconf_set_int(const char *in_key, const int intval);
+char *vconf_get_str(const char *in_key);
+int vconf_set_str(const char *in_key, const char *strval);
+int vconf_notify_key_changed(const char *in_key, vconf_callback_fn cb, void *user_data);
+int vconf_ignore_key_changed(const char *in_key, vconf_callback_fn cb);
+char *vconf_keynode_get_name(keynode_t *keynode);
+int vconf_keynode_get_int(const keynode_t *keynode);
+char *vconf_keynode_get_str(const keynode_t *keynode);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include "mock_private.h"
+
+struct _mock_event_s {
+	guint source;
+	mock_deliver_fn deliver;
+	gpointer data;
+	GDestroyNotify destroy;
+};
+
+static pthread_mutex_t mock_mutex = PTHREAD_MUTEX_INITIALIZER;
+static GHashTable *mock_calls = NULL;
+static GHashTable *mock_errors = NULL;
+static GSList *mock_events = NULL;
+static int mock_latency = 0;
+
+
+void _mock_lock(void)
+{
+	pthread_mutex_lock(&mock_mutex);
+}
+
+void _mock_unlock(void)
+{
+	pthread_mutex_unlock(&mock_mutex);
+}
+
+int _mock_enter(const char *function, bool ipc)
+{
+	int count;
+	int error = 0;
+	int latency;
+
+	MOCK_LOCK;
+
+	if (mock_calls == NULL)
+		mock_calls = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	count = GPOINTER_TO_INT(g_hash_table_lookup(mock_calls, function));
+	g_hash_table_replace(mock_calls, g_strdup(function), GINT_TO_POINTER(count + 1));
+
+	if (mock_errors)
+		error = GPOINTER_TO_INT(g_hash_table_lookup(mock_errors, function));
+
+	latency = mock_latency;
+
+	MOCK_UNLOCK;
+
+	/* Stands in for the D-Bus round trip to the network daemon */
+	if (ipc && latency > 0)
+		g_usleep(latency);
+
+	return error;
+}
+
+static void __mock_event_free(struct _mock_event_s *event)
+{
+	if (event->destroy)
+		event->destroy(event->data);
+
+	g_free(event);
+}
+
+static gboolean __mock_event_timeout(gpointer user_data)
+{
+	struct _mock_event_s *event = user_data;
+
+	MOCK_LOCK;
+	mock_events = g_slist_remove(mock_events, event);
+	MOCK_UNLOCK;
+
+	event->deliver(event->data);
+	__mock_event_free(event);
+
+	return FALSE;
+}
+
+void _mock_queue_push(int delay, mock_deliver_fn deliver, gpointer data, GDestroyNotify destroy)
+{
+	struct _mock_event_s *event = g_new0(struct _mock_event_s, 1);
+
+	event->deliver = deliver;
+	event->data = data;
+	event->destroy = destroy;
+
+	MOCK_LOCK;
+	mock_events = g_slist_append(mock_events, event);
+	event->source = g_timeout_add(delay > 0 ? delay : 0, __mock_event_timeout, event);
+	MOCK_UNLOCK;
+}
+
+void _mock_queue_clear(void)
+{
+	GSList *events;
+	GSList *list;
+
+	MOCK_LOCK;
+	events = mock_events;
+	mock_events = NULL;
+	MOCK_UNLOCK;
+
+	for (list = events; list; list = list->next) {
+		struct _mock_event_s *event = list->data;
+
+		g_source_remove(event->source);
+		__mock_event_free(event);
+	}
+
+	g_slist_free(events);
+}
+
+int connection_mock_dispatch_events(void)
+{
+	int count = 0;
+
+	while (true) {
+		struct _mock_event_s *event;
+
+		MOCK_LOCK;
+		if (mock_events == NULL) {
+			MOCK_UNLOCK;
+			break;
+		}
+
+		event = mock_events->data;
+		mock_events = g_slist_remove(mock_events, event);
+		MOCK_UNLOCK;
+
+		g_source_remove(event->source);
+
+		/* Delivering may queue more events, which are delivered in this call too */
+		event->deliver(event->data);
+		__mock_event_free(event);
+		count++;
+	}
+
+	return count;
+}
+
+int connection_mock_get_pending_events(void)
+{
+	int count;
+
+	MOCK_LOCK;
+	count = g_slist_length(mock_events);
+	MOCK_UNLOCK;
+
+	return count;
+}
+
+int connection_mock_get_call_count(const char *function)
+{
+	int count = 0;
+
+	if (function == NULL)
+		return 0;
+
+	MOCK_LOCK;
+	if (mock_calls)
+		count = GPOINTER_TO_INT(g_hash_table_lookup(mock_calls, function));
+	MOCK_UNLOCK;
+
+	return count;
+}
+
+void connection_mock_set_latency(int usec)
+{
+	MOCK_LOCK;
+	mock_latency = usec;
+	MOCK_UNLOCK;
+}
+
+void connection_mock_set_error(const char *function, int error)
+{
+	if (function == NULL)
+		return;
+
+	MOCK_LOCK;
+
+	if (mock_errors == NULL)
+		mock_errors = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	if (error == NET_ERR_NONE)
+		g_hash_table_remove(mock_errors, function);
+	else
+		g_hash_table_replace(mock_errors, g_strdup(function), GINT_TO_POINTER(error));
+
+	MOCK_UNLOCK;
+}
+
+void connection_mock_reset(void)
+{
+	_mock_queue_clear();
+	_mock_libnet_reset();
+	_mock_vconf_reset();
+
+	MOCK_LOCK;
+
+	if (mock_calls)
+		g_hash_table_remove_all(mock_calls);
+	if (mock_errors)
+		g_hash_table_remove_all(mock_errors);
+
+	mock_latency = 0;
+
+	MOCK_UNLOCK;
+}
@@ -0,0 +1,537 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <network-cm-intf.h>
+#include <network-wifi-intf.h>
+#include "mock_private.h"
+
+struct _mock_net_event_s {
+	net_event_t event;
+	net_err_t error;
+	net_state_type_t state;
+	char profile_name[NET_PROFILE_NAME_LEN_MAX+1];
+};
+
+static GArray *mock_profiles = NULL;
+static net_event_cb_t mock_event_cb = NULL;
+static void *mock_event_user_data = NULL;
+static int mock_profile_last_id = 0;
+static unsigned long long mock_statistics[NET_DEVICE_MAX][NET_STATISTICS_TYPE_TOTAL_SENT_DATA+1];
+
+
+static net_profile_info_t *__mock_find_profile(const char *profile_name)
+{
+	guint i;
+
+	if (mock_profiles == NULL || profile_name == NULL)
+		return NULL;
+
+	for (i = 0; i < mock_profiles->len; i++) {
+		net_profile_info_t *profile_info = &g_array_index(mock_profiles, net_profile_info_t, i);
+
+		if (strcmp(profile_info->ProfileName, profile_name) == 0)
+			return profile_info;
+	}
+
+	return NULL;
+}
+
+static void __mock_deliver_event(gpointer data)
+{
+	struct _mock_net_event_s *mock_event = data;
+	net_profile_info_t *profile_info;
+	net_profile_info_t profile_copy;
+	net_state_type_t state = mock_event->state;
+	net_event_info_t event_info;
+	net_event_cb_t event_cb;
+	void *user_data;
+
+	memset(&event_info, 0, sizeof(net_event_info_t));
+	event_info.Event = mock_event->event;
+	event_info.Error = mock_event->error;
+	g_strlcpy(event_info.ProfileName, mock_event->profile_name, NET_PROFILE_NAME_LEN_MAX+1);
+
+	MOCK_LOCK;
+
+	profile_info = __mock_find_profile(mock_event->profile_name);
+
+	switch (mock_event->event) {
+	case NET_EVENT_OPEN_RSP:
+	case NET_EVENT_OPEN_IND:
+		if (profile_info == NULL || mock_event->error != NET_ERR_NONE)
+			break;
+
+		profile_info->ProfileState = NET_STATE_TYPE_ONLINE;
+		memcpy(&profile_copy, profile_info, sizeof(net_profile_info_t));
+		event_info.Datalength = sizeof(net_profile_info_t);
+		event_info.Data = &profile_copy;
+		break;
+	case NET_EVENT_CLOSE_RSP:
+	case NET_EVENT_CLOSE_IND:
+		if (profile_info && mock_event->error == NET_ERR_NONE)
+			profile_info->ProfileState = NET_STATE_TYPE_IDLE;
+		break;
+	case NET_EVENT_NET_STATE_IND:
+		if (profile_info)
+			profile_info->ProfileState = state;
+
+		event_info.Datalength = sizeof(net_state_type_t);
+		event_info.Data = &state;
+		break;
+	default:
+		break;
+	}
+
+	event_cb = mock_event_cb;
+	user_data = mock_event_user_data;
+
+	MOCK_UNLOCK;
+
+	if (event_cb)
+		event_cb(&event_info, user_data);
+}
+
+void connection_mock_queue_event(int delay, net_event_t event, net_err_t error,
+		const char *profile_name, net_state_type_t state)
+{
+	struct _mock_net_event_s *mock_event = g_new0(struct _mock_net_event_s, 1);
+
+	mock_event->event = event;
+	mock_event->error = error;
+	mock_event->state = state;
+	if (profile_name)
+		g_strlcpy(mock_event->profile_name, profile_name, NET_PROFILE_NAME_LEN_MAX+1);
+
+	_mock_queue_push(delay, __mock_deliver_event, mock_event, g_free);
+}
+
+int connection_mock_deliver_event(const net_event_info_t *event_info)
+{
+	net_event_cb_t event_cb;
+	void *user_data;
+
+	if (event_info == NULL)
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+	event_cb = mock_event_cb;
+	user_data = mock_event_user_data;
+	MOCK_UNLOCK;
+
+	if (event_cb == NULL)
+		return NET_ERR_APP_NOT_REGISTERED;
+
+	event_cb(event_info, user_data);
+
+	return NET_ERR_NONE;
+}
+
+int connection_mock_add_profile(const net_profile_info_t *profile_info)
+{
+	net_profile_info_t *existing;
+
+	if (profile_info == NULL || profile_info->ProfileName[0] == '\0')
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+
+	if (mock_profiles == NULL)
+		mock_profiles = g_array_new(FALSE, TRUE, sizeof(net_profile_info_t));
+
+	existing = __mock_find_profile(profile_info->ProfileName);
+	if (existing)
+		memcpy(existing, profile_info, sizeof(net_profile_info_t));
+	else
+		g_array_append_vals(mock_profiles, profile_info, 1);
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+void connection_mock_set_statistics(net_device_t device_type,
+		net_statistics_type_e statistics_type, unsigned long long size)
+{
+	if (device_type >= NET_DEVICE_MAX || statistics_type > NET_STATISTICS_TYPE_TOTAL_SENT_DATA)
+		return;
+
+	MOCK_LOCK;
+	mock_statistics[device_type][statistics_type] = size;
+	MOCK_UNLOCK;
+}
+
+void _mock_libnet_reset(void)
+{
+	/* The registered client survives a reset */
+	MOCK_LOCK;
+	if (mock_profiles)
+		g_array_set_size(mock_profiles, 0);
+
+	mock_profile_last_id = 0;
+	memset(mock_statistics, 0, sizeof(mock_statistics));
+	MOCK_UNLOCK;
+}
+
+/* Like libnet, refuses the requests of a process that did not register */
+static int __mock_enter_client(const char *function)
+{
+	int error = _mock_enter(function, true);
+	bool registered;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	MOCK_LOCK;
+	registered = (mock_event_cb != NULL);
+	MOCK_UNLOCK;
+
+	return registered ? NET_ERR_NONE : NET_ERR_APP_NOT_REGISTERED;
+}
+
+int net_register_client_ext(net_event_cb_t event_cb, net_device_t client_type, void *user_data)
+{
+	int error = _mock_enter("net_register_client_ext", true);
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	MOCK_LOCK;
+
+	if (mock_event_cb) {
+		MOCK_UNLOCK;
+		return NET_ERR_APP_ALREADY_REGISTERED;
+	}
+
+	mock_event_cb = event_cb;
+	mock_event_user_data = user_data;
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+int net_deregister_client_ext(net_device_t client_type)
+{
+	int error = _mock_enter("net_deregister_client_ext", true);
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	MOCK_LOCK;
+
+	if (mock_event_cb == NULL) {
+		MOCK_UNLOCK;
+		return NET_ERR_APP_NOT_REGISTERED;
+	}
+
+	mock_event_cb = NULL;
+	mock_event_user_data = NULL;
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+int net_get_profile_list(net_device_t device_type, net_profile_info_t **profile_list, int *count)
+{
+	int error = __mock_enter_client("net_get_profile_list");
+	int found = 0;
+	guint i;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (profile_list == NULL || count == NULL)
+		return NET_ERR_INVALID_PARAM;
+
+	*profile_list = NULL;
+	*count = 0;
+
+	MOCK_LOCK;
+
+	for (i = 0; mock_profiles && i < mock_profiles->len; i++)
+		if (g_array_index(mock_profiles, net_profile_info_t, i).profile_type == device_type)
+			found++;
+
+	if (found > 0) {
+		*profile_list = g_new0(net_profile_info_t, found);
+
+		for (i = 0; i < mock_profiles->len; i++) {
+			net_profile_info_t *profile_info = &g_array_index(mock_profiles, net_profile_info_t, i);
+
+			if (profile_info->profile_type == device_type)
+				memcpy(&(*profile_list)[(*count)++], profile_info, sizeof(net_profile_info_t));
+		}
+	}
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+int net_get_profile_info(const char *profile_name, net_profile_info_t *prof_info)
+{
+	int error = __mock_enter_client("net_get_profile_info");
+	net_profile_info_t *profile_info;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (prof_info == NULL)
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+
+	profile_info = __mock_find_profile(profile_name);
+	if (profile_info == NULL) {
+		MOCK_UNLOCK;
+		return NET_ERR_NO_SERVICE;
+	}
+
+	memcpy(prof_info, profile_info, sizeof(net_profile_info_t));
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+int net_get_active_net_info(net_profile_info_t *active_profile_info)
+{
+	int error = __mock_enter_client("net_get_active_net_info");
+	net_profile_info_t *active = NULL;
+	guint i;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (active_profile_info == NULL)
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+
+	/* The default connection: the first online profile, else the first ready one */
+	for (i = 0; mock_profiles && i < mock_profiles->len; i++) {
+		net_profile_info_t *profile_info = &g_array_index(mock_profiles, net_profile_info_t, i);
+
+		if (profile_info->ProfileState == NET_STATE_TYPE_ONLINE) {
+			active = profile_info;
+			break;
+		}
+
+		if (profile_info->ProfileState == NET_STATE_TYPE_READY && active == NULL)
+			active = profile_info;
+	}
+
+	if (active == NULL) {
+		MOCK_UNLOCK;
+		return NET_ERR_NO_SERVICE;
+	}
+
+	memcpy(active_profile_info, active, sizeof(net_profile_info_t));
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+int net_open_connection_with_profile(const char *profile_name)
+{
+	int error = __mock_enter_client("net_open_connection_with_profile");
+	bool found;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	MOCK_LOCK;
+	found = (__mock_find_profile(profile_name) != NULL);
+	MOCK_UNLOCK;
+
+	if (!found)
+		return NET_ERR_INVALID_PARAM;
+
+	connection_mock_queue_event(0, NET_EVENT_OPEN_RSP, NET_ERR_NONE, profile_name, NET_STATE_TYPE_ONLINE);
+
+	return NET_ERR_NONE;
+}
+
+int net_open_connection_with_preference_ext(net_service_type_t service_type, net_profile_name_t *prof_name)
+{
+	int error = __mock_enter_client("net_open_connection_with_preference_ext");
+	net_profile_info_t *found = NULL;
+	guint i;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (prof_name == NULL)
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+
+	for (i = 0; mock_profiles && i < mock_profiles->len; i++) {
+		net_profile_info_t *profile_info = &g_array_index(mock_profiles, net_profile_info_t, i);
+
+		if (profile_info->profile_type == NET_DEVICE_CELLULAR &&
+		    profile_info->ProfileInfo.Pdp.ServiceType == service_type) {
+			found = profile_info;
+			break;
+		}
+	}
+
+	if (found == NULL) {
+		MOCK_UNLOCK;
+		return NET_ERR_NO_SERVICE;
+	}
+
+	g_strlcpy(prof_name->ProfileName, found->ProfileName, NET_PROFILE_NAME_LEN_MAX+1);
+
+	MOCK_UNLOCK;
+
+	connection_mock_queue_event(0, NET_EVENT_OPEN_RSP, NET_ERR_NONE,
+			prof_name->ProfileName, NET_STATE_TYPE_ONLINE);
+
+	return NET_ERR_NONE;
+}
+
+int net_close_connection(const char *profile_name)
+{
+	int error = __mock_enter_client("net_close_connection");
+	bool found;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	MOCK_LOCK;
+	found = (__mock_find_profile(profile_name) != NULL);
+	MOCK_UNLOCK;
+
+	if (!found)
+		return NET_ERR_INVALID_PARAM;
+
+	connection_mock_queue_event(0, NET_EVENT_CLOSE_RSP, NET_ERR_NONE, profile_name, NET_STATE_TYPE_IDLE);
+
+	return NET_ERR_NONE;
+}
+
+int net_add_profile(net_service_type_t network_type, net_profile_info_t *prof_info)
+{
+	int error = __mock_enter_client("net_add_profile");
+	net_profile_info_t profile_info;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (prof_info == NULL || prof_info->profile_type != NET_DEVICE_CELLULAR)
+		return NET_ERR_INVALID_PARAM;
+
+	memcpy(&profile_info, prof_info, sizeof(net_profile_info_t));
+	profile_info.ProfileInfo.Pdp.ServiceType = network_type;
+
+	MOCK_LOCK;
+	snprintf(profile_info.ProfileName, NET_PROFILE_NAME_LEN_MAX+1,
+			"/context/mock%d", ++mock_profile_last_id);
+	MOCK_UNLOCK;
+
+	return connection_mock_add_profile(&profile_info);
+}
+
+int net_delete_profile(const char *profile_name)
+{
+	int error = __mock_enter_client("net_delete_profile");
+	guint i;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	MOCK_LOCK;
+
+	for (i = 0; mock_profiles && i < mock_profiles->len; i++) {
+		if (g_strcmp0(g_array_index(mock_profiles, net_profile_info_t, i).ProfileName, profile_name) == 0) {
+			g_array_remove_index(mock_profiles, i);
+			MOCK_UNLOCK;
+			return NET_ERR_NONE;
+		}
+	}
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_INVALID_PARAM;
+}
+
+int net_modify_profile(const char *profile_name, net_profile_info_t *prof_info)
+{
+	int error = __mock_enter_client("net_modify_profile");
+	net_profile_info_t *profile_info;
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (prof_info == NULL)
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+
+	profile_info = __mock_find_profile(profile_name);
+	if (profile_info == NULL) {
+		MOCK_UNLOCK;
+		return NET_ERR_INVALID_PARAM;
+	}
+
+	memcpy(profile_info, prof_info, sizeof(net_profile_info_t));
+	g_strlcpy(profile_info->ProfileName, profile_name, NET_PROFILE_NAME_LEN_MAX+1);
+
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+int net_get_statistics(net_device_t device_type, net_statistics_type_e statistics_type, unsigned long long *size)
+{
+	int error = __mock_enter_client("net_get_statistics");
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (size == NULL || device_type >= NET_DEVICE_MAX ||
+	    statistics_type > NET_STATISTICS_TYPE_TOTAL_SENT_DATA)
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+	*size = mock_statistics[device_type][statistics_type];
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
+
+int net_set_statistics(net_device_t device_type, net_statistics_type_e statistics_type)
+{
+	int error = __mock_enter_client("net_set_statistics");
+
+	if (error != NET_ERR_NONE)
+		return error;
+
+	if (device_type >= NET_DEVICE_MAX || statistics_type > NET_STATISTICS_TYPE_TOTAL_SENT_DATA)
+		return NET_ERR_INVALID_PARAM;
+
+	MOCK_LOCK;
+	mock_statistics[device_type][statistics_type] = 0;
+	MOCK_UNLOCK;
+
+	return NET_ERR_NONE;
+}
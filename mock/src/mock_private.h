@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CONNECTION_MOCK_PRIVATE_H__
+#define __CONNECTION_MOCK_PRIVATE_H__
+
+#include <pthread.h>
+#include <glib.h>
+#include "connection_mock.h"
+
+#define MOCK_LOCK _mock_lock()
+#define MOCK_UNLOCK _mock_unlock()
+
+typedef void (*mock_deliver_fn)(gpointer data);
+
+void _mock_lock(void);
+void _mock_unlock(void);
+int _mock_enter(const char *function, bool ipc);
+void _mock_queue_push(int delay, mock_deliver_fn deliver, gpointer data, GDestroyNotify destroy);
+void _mock_queue_clear(void);
+void _mock_libnet_reset(void);
+void _mock_vconf_reset(void);
+
+#endif
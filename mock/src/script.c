@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "mock_private.h"
+
+struct _mock_name_s {
+	const char *name;
+	int value;
+};
+
+static const struct _mock_name_s mock_states[] = {
+	{"idle", NET_STATE_TYPE_IDLE},
+	{"failure", NET_STATE_TYPE_FAILURE},
+	{"association", NET_STATE_TYPE_ASSOCIATION},
+	{"configuration", NET_STATE_TYPE_CONFIGURATION},
+	{"ready", NET_STATE_TYPE_READY},
+	{"online", NET_STATE_TYPE_ONLINE},
+	{"disconnect", NET_STATE_TYPE_DISCONNECT},
+	{NULL, 0},
+};
+
+static const struct _mock_name_s mock_services[] = {
+	{"internet", NET_SERVICE_INTERNET},
+	{"mms", NET_SERVICE_MMS},
+	{"wap", NET_SERVICE_WAP},
+	{"prepaid_internet", NET_SERVICE_PREPAID_INTERNET},
+	{"prepaid_mms", NET_SERVICE_PREPAID_MMS},
+	{NULL, 0},
+};
+
+static const struct _mock_name_s mock_events[] = {
+	{"open_rsp", NET_EVENT_OPEN_RSP},
+	{"open_ind", NET_EVENT_OPEN_IND},
+	{"close_rsp", NET_EVENT_CLOSE_RSP},
+	{"close_ind", NET_EVENT_CLOSE_IND},
+	{"state_ind", NET_EVENT_NET_STATE_IND},
+	{"scan_ind", NET_EVENT_WIFI_SCAN_IND},
+	{NULL, 0},
+};
+
+static const struct _mock_name_s mock_statistics[] = {
+	{"last_rx", NET_STATISTICS_TYPE_LAST_RECEIVED_DATA},
+	{"last_tx", NET_STATISTICS_TYPE_LAST_SENT_DATA},
+	{"total_rx", NET_STATISTICS_TYPE_TOTAL_RECEIVED_DATA},
+	{"total_tx", NET_STATISTICS_TYPE_TOTAL_SENT_DATA},
+	{NULL, 0},
+};
+
+static const struct _mock_name_s mock_devices[] = {
+	{"wifi", NET_DEVICE_WIFI},
+	{"cellular", NET_DEVICE_CELLULAR},
+	{"ethernet", NET_DEVICE_ETHERNET},
+	{NULL, 0},
+};
+
+
+static bool __mock_lookup(const struct _mock_name_s *names, const char *name, int *value)
+{
+	int i;
+
+	for (i = 0; names[i].name; i++) {
+		if (strcmp(names[i].name, name) == 0) {
+			*value = names[i].value;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static net_dev_info_t *__mock_get_net_info(net_profile_info_t *profile_info)
+{
+	switch (profile_info->profile_type) {
+	case NET_DEVICE_CELLULAR:
+		return &profile_info->ProfileInfo.Pdp.net_info;
+	case NET_DEVICE_WIFI:
+		return &profile_info->ProfileInfo.Wlan.net_info;
+	case NET_DEVICE_ETHERNET:
+		return &profile_info->ProfileInfo.Ethernet.net_info;
+	default:
+		return NULL;
+	}
+}
+
+static int __mock_run_profile(int argc, char **argv)
+{
+	net_profile_info_t profile_info;
+	net_dev_info_t *net_info;
+	int device_type;
+	int state;
+	int service;
+	int extra;
+
+	/* profile <type> <name> <ifname> <state> ... */
+	if (argc < 5 || !__mock_lookup(mock_devices, argv[1], &device_type) ||
+	    !__mock_lookup(mock_states, argv[4], &state))
+		return NET_ERR_INVALID_PARAM;
+
+	memset(&profile_info, 0, sizeof(net_profile_info_t));
+	profile_info.profile_type = device_type;
+	profile_info.ProfileState = state;
+	g_strlcpy(profile_info.ProfileName, argv[2], NET_PROFILE_NAME_LEN_MAX+1);
+
+	net_info = __mock_get_net_info(&profile_info);
+	g_strlcpy(net_info->ProfileName, argv[2], NET_PROFILE_NAME_LEN_MAX+1);
+	g_strlcpy(net_info->DevName, argv[3], NET_MAX_DEVICE_NAME_LEN+1);
+	net_info->IpConfigType = NET_IP_CONFIG_TYPE_DYNAMIC;
+	net_info->ProxyMethod = NET_PROXY_TYPE_DIRECT;
+
+	switch (device_type) {
+	case NET_DEVICE_WIFI:
+		if (argc < 6)
+			return NET_ERR_INVALID_PARAM;
+
+		g_strlcpy(profile_info.ProfileInfo.Wlan.essid, argv[5], NET_WLAN_ESSID_LEN+1);
+		profile_info.ProfileInfo.Wlan.security_info.sec_mode = WLAN_SEC_MODE_NONE;
+		profile_info.ProfileInfo.Wlan.security_info.enc_mode = WLAN_ENC_MODE_NONE;
+		if (argc > 7)
+			profile_info.ProfileInfo.Wlan.Strength = atoi(argv[7]);
+		if (argc > 8)
+			g_strlcpy(profile_info.ProfileInfo.Wlan.bssid, argv[8], NET_MAX_MAC_ADDR_LEN+1);
+		extra = 6;
+		break;
+	case NET_DEVICE_CELLULAR:
+		if (argc < 7 || !__mock_lookup(mock_services, argv[6], &service))
+			return NET_ERR_INVALID_PARAM;
+
+		g_strlcpy(profile_info.ProfileInfo.Pdp.Apn, argv[5], NET_PDP_APN_LEN_MAX+1);
+		profile_info.ProfileInfo.Pdp.ServiceType = service;
+		profile_info.ProfileInfo.Pdp.ProtocolType = NET_PDP_TYPE_UMTS;
+		extra = 7;
+		break;
+	default:
+		extra = 5;
+		break;
+	}
+
+	if (argc > extra) {
+		net_info->IpAddr.Type = NET_ADDR_IPV4;
+		if (inet_pton(AF_INET, argv[extra], &net_info->IpAddr.Data.Ipv4) != 1)
+			return NET_ERR_INVALID_PARAM;
+	}
+
+	return connection_mock_add_profile(&profile_info);
+}
+
+static int __mock_run_event(int argc, char **argv)
+{
+	int event;
+	int state = NET_STATE_TYPE_UNKNOWN;
+	int error = NET_ERR_NONE;
+
+	/* event <delay> <type> <profile> [error|state] */
+	if (argc < 4 || !__mock_lookup(mock_events, argv[2], &event))
+		return NET_ERR_INVALID_PARAM;
+
+	if (event == NET_EVENT_NET_STATE_IND) {
+		if (argc < 5 || !__mock_lookup(mock_states, argv[4], &state))
+			return NET_ERR_INVALID_PARAM;
+	} else if (argc > 4)
+		error = atoi(argv[4]);
+
+	connection_mock_queue_event(atoi(argv[1]), event, error, argv[3], state);
+
+	return NET_ERR_NONE;
+}
+
+int connection_mock_run_command(const char *command)
+{
+	char **argv;
+	int argc = 0;
+	int device_type;
+	int statistics_type;
+	int rv = NET_ERR_NONE;
+	char *line;
+	int i;
+
+	if (command == NULL)
+		return NET_ERR_INVALID_PARAM;
+
+	line = g_strstrip(g_strdup(command));
+	if (line[0] == '\0' || line[0] == '#') {
+		g_free(line);
+		return NET_ERR_NONE;
+	}
+
+	argv = g_strsplit_set(line, " \t", -1);
+	g_free(line);
+
+	/* Runs of blanks give empty arguments, squeeze them out */
+	for (i = 0; argv[i]; i++) {
+		if (argv[i][0] == '\0')
+			g_free(argv[i]);
+		else
+			argv[argc++] = argv[i];
+	}
+	argv[argc] = NULL;
+
+	if (strcmp(argv[0], "reset") == 0)
+		connection_mock_reset();
+	else if (strcmp(argv[0], "latency") == 0 && argc == 2)
+		connection_mock_set_latency(atoi(argv[1]));
+	else if (strcmp(argv[0], "error") == 0 && argc == 3)
+		connection_mock_set_error(argv[1], atoi(argv[2]));
+	else if (strcmp(argv[0], "profile") == 0)
+		rv = __mock_run_profile(argc, argv);
+	else if (strcmp(argv[0], "vconf") == 0 && argc == 4 && strcmp(argv[1], "int") == 0)
+		rv = vconf_set_int(argv[2], atoi(argv[3])) == 0 ? NET_ERR_NONE : NET_ERR_INVALID_PARAM;
+	else if (strcmp(argv[0], "vconf") == 0 && argc == 4 && strcmp(argv[1], "str") == 0)
+		rv = vconf_set_str(argv[2], argv[3]) == 0 ? NET_ERR_NONE : NET_ERR_INVALID_PARAM;
+	else if (strcmp(argv[0], "statistics") == 0 && argc == 4 &&
+		 __mock_lookup(mock_devices, argv[1], &device_type) &&
+		 __mock_lookup(mock_statistics, argv[2], &statistics_type))
+		connection_mock_set_statistics(device_type, statistics_type, g_ascii_strtoull(argv[3], NULL, 10));
+	else if (strcmp(argv[0], "event") == 0)
+		rv = __mock_run_event(argc, argv);
+	else
+		rv = NET_ERR_INVALID_PARAM;
+
+	if (rv != NET_ERR_NONE)
+		fprintf(stderr, "connection mock: invalid command: %s\n", command);
+
+	g_strfreev(argv);
+
+	return rv;
+}
+
+int connection_mock_load_script(const char *path)
+{
+	gchar *contents = NULL;
+	gchar **lines;
+	int rv = NET_ERR_NONE;
+	int i;
+
+	if (path == NULL || !g_file_get_contents(path, &contents, NULL, NULL))
+		return NET_ERR_INVALID_PARAM;
+
+	lines = g_strsplit(contents, "\n", -1);
+	g_free(contents);
+
+	for (i = 0; lines[i] && rv == NET_ERR_NONE; i++)
+		rv = connection_mock_run_command(lines[i]);
+
+	g_strfreev(lines);
+
+	return rv;
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <vconf/vconf.h>
+#include "mock_private.h"
+
+enum {
+	MOCK_VCONF_INT = 1,
+	MOCK_VCONF_STR,
+};
+
+struct _keynode_t {
+	char *keyname;
+	int type;
+	int value;
+	char *str;
+};
+
+struct _mock_vconf_notify_s {
+	char *key;
+	vconf_callback_fn callback;
+	void *user_data;
+};
+
+static GHashTable *vconf_table = NULL;
+static GSList *vconf_notify_list = NULL;
+
+
+static void __mock_vconf_node_free(gpointer data)
+{
+	keynode_t *node = data;
+
+	g_free(node->keyname);
+	g_free(node->str);
+	g_free(node);
+}
+
+static keynode_t *__mock_vconf_node_copy(const keynode_t *node)
+{
+	keynode_t *copy = g_new0(keynode_t, 1);
+
+	copy->keyname = g_strdup(node->keyname);
+	copy->type = node->type;
+	copy->value = node->value;
+	copy->str = g_strdup(node->str);
+
+	return copy;
+}
+
+static void __mock_vconf_deliver(gpointer data)
+{
+	keynode_t *node = data;
+	GSList *callbacks = NULL;
+	GSList *list;
+
+	MOCK_LOCK;
+	for (list = vconf_notify_list; list; list = list->next) {
+		struct _mock_vconf_notify_s *notify = list->data;
+
+		if (g_strcmp0(notify->key, node->keyname) == 0)
+			callbacks = g_slist_append(callbacks, g_memdup(notify, sizeof(*notify)));
+	}
+	MOCK_UNLOCK;
+
+	/* Callbacks run unlocked, they may read keys or unregister themselves */
+	for (list = callbacks; list; list = list->next) {
+		struct _mock_vconf_notify_s *notify = list->data;
+		notify->callback(node, notify->user_data);
+	}
+
+	g_slist_free_full(callbacks, g_free);
+}
+
+static int __mock_vconf_set(const char *in_key, int type, int value, const char *str)
+{
+	keynode_t *node;
+
+	if (in_key == NULL)
+		return -1;
+
+	_mock_enter(type == MOCK_VCONF_INT ? "vconf_set_int" : "vconf_set_str", false);
+
+	node = g_new0(keynode_t, 1);
+	node->keyname = g_strdup(in_key);
+	node->type = type;
+	node->value = value;
+	node->str = g_strdup(str);
+
+	MOCK_LOCK;
+	if (vconf_table == NULL)
+		vconf_table = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, __mock_vconf_node_free);
+
+	g_hash_table_replace(vconf_table, node->keyname, node);
+	node = __mock_vconf_node_copy(node);
+	MOCK_UNLOCK;
+
+	/* Like vconf, notifications reach the main loop asynchronously */
+	_mock_queue_push(0, __mock_vconf_deliver, node, __mock_vconf_node_free);
+
+	return 0;
+}
+
+int vconf_get_int(const char *in_key, int *intval)
+{
+	keynode_t *node = NULL;
+	int error = _mock_enter("vconf_get_int", false);
+
+	if (in_key == NULL || intval == NULL || error != 0)
+		return -1;
+
+	MOCK_LOCK;
+	if (vconf_table)
+		node = g_hash_table_lookup(vconf_table, in_key);
+
+	if (node == NULL || node->type != MOCK_VCONF_INT) {
+		MOCK_UNLOCK;
+		return -1;
+	}
+
+	*intval = node->value;
+	MOCK_UNLOCK;
+
+	return 0;
+}
+
+int vconf_set_int(const char *in_key, const int intval)
+{
+	return __mock_vconf_set(in_key, MOCK_VCONF_INT, intval, NULL);
+}
+
+char *vconf_get_str(const char *in_key)
+{
+	keynode_t *node = NULL;
+	char *str = NULL;
+	int error = _mock_enter("vconf_get_str", false);
+
+	if (in_key == NULL || error != 0)
+		return NULL;
+
+	MOCK_LOCK;
+	if (vconf_table)
+		node = g_hash_table_lookup(vconf_table, in_key);
+
+	/* vconf returns memory the caller releases with free() */
+	if (node && node->type == MOCK_VCONF_STR && node->str)
+		str = strdup(node->str);
+	MOCK_UNLOCK;
+
+	return str;
+}
+
+int vconf_set_str(const char *in_key, const char *strval)
+{
+	if (strval == NULL)
+		return -1;
+
+	return __mock_vconf_set(in_key, MOCK_VCONF_STR, 0, strval);
+}
+
+int vconf_notify_key_changed(const char *in_key, vconf_callback_fn cb, void *user_data)
+{
+	struct _mock_vconf_notify_s *notify;
+
+	if (in_key == NULL || cb == NULL || _mock_enter("vconf_notify_key_changed", false) != 0)
+		return -1;
+
+	notify = g_new0(struct _mock_vconf_notify_s, 1);
+	notify->key = g_strdup(in_key);
+	notify->callback = cb;
+	notify->user_data = user_data;
+
+	MOCK_LOCK;
+	vconf_notify_list = g_slist_append(vconf_notify_list, notify);
+	MOCK_UNLOCK;
+
+	return 0;
+}
+
+int vconf_ignore_key_changed(const char *in_key, vconf_callback_fn cb)
+{
+	GSList *list;
+
+	if (in_key == NULL || cb == NULL || _mock_enter("vconf_ignore_key_changed", false) != 0)
+		return -1;
+
+	MOCK_LOCK;
+	for (list = vconf_notify_list; list; list = list->next) {
+		struct _mock_vconf_notify_s *notify = list->data;
+
+		if (notify->callback == cb && g_strcmp0(notify->key, in_key) == 0) {
+			vconf_notify_list = g_slist_delete_link(vconf_notify_list, list);
+			MOCK_UNLOCK;
+
+			g_free(notify->key);
+			g_free(notify);
+			return 0;
+		}
+	}
+	MOCK_UNLOCK;
+
+	return -1;
+}
+
+char *vconf_keynode_get_name(keynode_t *keynode)
+{
+	return keynode ? keynode->keyname : NULL;
+}
+
+int vconf_keynode_get_int(const keynode_t *keynode)
+{
+	return keynode ? keynode->value : -1;
+}
+
+char *vconf_keynode_get_str(const keynode_t *keynode)
+{
+	return keynode ? keynode->str : NULL;
+}
+
+void _mock_vconf_reset(void)
+{
+	/* Registered notifications belong to the client and survive a reset */
+	MOCK_LOCK;
+	if (vconf_table)
+		g_hash_table_remove_all(vconf_table);
+	MOCK_UNLOCK;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+#define CAPTURE_DATA_LENGTH_MAX (1024 * 1024)
+
+enum {
+	CAPTURE_STATE_UNKNOWN = 0,
+	CAPTURE_STATE_OFF,
+	CAPTURE_STATE_ON,
+};
+
+static FILE *capture_file = NULL;
+static gint64 capture_start_time = 0;
+static volatile int capture_state = CAPTURE_STATE_UNKNOWN;
+
+
+/* Must be called with the lock held */
+static int __capture_open(const char *path)
+{
+	connection_capture_header_s header;
+
+	if (capture_file) {
+		fclose(capture_file);
+		capture_file = NULL;
+	}
+
+	capture_file = fopen(path, "wb");
+	if (capture_file == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot open event capture file %s\n", path);
+		g_atomic_int_set(&capture_state, CAPTURE_STATE_OFF);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	header.magic = CONNECTION_CAPTURE_MAGIC;
+	header.version = CONNECTION_CAPTURE_VERSION;
+
+	if (fwrite(&header, sizeof(connection_capture_header_s), 1, capture_file) != 1) {
+		fclose(capture_file);
+		capture_file = NULL;
+		g_atomic_int_set(&capture_state, CAPTURE_STATE_OFF);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	capture_start_time = g_get_monotonic_time();
+	g_atomic_int_set(&capture_state, CAPTURE_STATE_ON);
+
+	CONNECTION_LOG(CONNECTION_INFO, "Capturing network events to %s\n", path);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+static void __capture_init(void)
+{
+	const char *path;
+
+	CONNECTION_MUTEX_LOCK;
+
+	if (g_atomic_int_get(&capture_state) == CAPTURE_STATE_UNKNOWN) {
+		path = getenv(CONNECTION_CAPTURE_ENV);
+
+		if (path && path[0] != '\0')
+			__capture_open(path);
+		else
+			g_atomic_int_set(&capture_state, CAPTURE_STATE_OFF);
+	}
+
+	CONNECTION_MUTEX_UNLOCK;
+}
+
+int _connection_capture_start(const char *path)
+{
+	int rv;
+
+	if (path == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	CONNECTION_MUTEX_LOCK;
+	rv = __capture_open(path);
+	CONNECTION_MUTEX_UNLOCK;
+
+	return rv;
+}
+
+void _connection_capture_stop(void)
+{
+	CONNECTION_MUTEX_LOCK;
+
+	if (capture_file) {
+		fclose(capture_file);
+		capture_file = NULL;
+	}
+
+	g_atomic_int_set(&capture_state, CAPTURE_STATE_OFF);
+
+	CONNECTION_MUTEX_UNLOCK;
+}
+
+void _connection_capture_event(const net_event_info_t *event_info)
+{
+	connection_capture_record_s record;
+	bool written;
+
+	if (g_atomic_int_get(&capture_state) == CAPTURE_STATE_UNKNOWN)
+		__capture_init();
+
+	/* Capturing is off in production, this is the only cost then */
+	if (g_atomic_int_get(&capture_state) != CAPTURE_STATE_ON || event_info == NULL)
+		return;
+
+	record.event = event_info->Event;
+	record.error = event_info->Error;
+	record.name_length = strnlen(event_info->ProfileName, NET_PROFILE_NAME_LEN_MAX+1);
+	record.data_length = (event_info->Data && event_info->Datalength > 0) ? event_info->Datalength : 0;
+
+	CONNECTION_MUTEX_LOCK;
+
+	if (capture_file == NULL) {
+		CONNECTION_MUTEX_UNLOCK;
+		return;
+	}
+
+	record.timestamp = g_get_monotonic_time() - capture_start_time;
+
+	written = fwrite(&record, sizeof(connection_capture_record_s), 1, capture_file) == 1 &&
+			fwrite(event_info->ProfileName, 1, record.name_length, capture_file) == record.name_length &&
+			fwrite(event_info->Data, 1, record.data_length, capture_file) == record.data_length;
+
+	/* Keep the log usable if the process dies in the middle of an event storm */
+	if (written)
+		fflush(capture_file);
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	if (!written)
+		CONNECTION_LOG(CONNECTION_ERROR, "Failed to capture event %d\n", event_info->Event);
+}
+
+int _connection_capture_read_header(FILE *fp)
+{
+	connection_capture_header_s header;
+
+	if (fp == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	if (fread(&header, sizeof(connection_capture_header_s), 1, fp) != 1 ||
+	    header.magic != CONNECTION_CAPTURE_MAGIC ||
+	    header.version != CONNECTION_CAPTURE_VERSION) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Not an event capture file\n");
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_capture_read_event(FILE *fp, unsigned long long *timestamp, net_event_info_t *event_info)
+{
+	connection_capture_record_s record;
+
+	if (fp == NULL || timestamp == NULL || event_info == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	if (fread(&record, sizeof(connection_capture_record_s), 1, fp) != 1)
+		return feof(fp) ? CONNECTION_ERROR_ITERATOR_END : CONNECTION_ERROR_OPERATION_FAILED;
+
+	if (record.name_length > NET_PROFILE_NAME_LEN_MAX ||
+	    record.data_length > CAPTURE_DATA_LENGTH_MAX)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	memset(event_info, 0, sizeof(net_event_info_t));
+	event_info->Event = record.event;
+	event_info->Error = record.error;
+
+	if (fread(event_info->ProfileName, 1, record.name_length, fp) != record.name_length)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	if (record.data_length > 0) {
+		event_info->Data = g_try_malloc(record.data_length);
+		if (event_info->Data == NULL)
+			return CONNECTION_ERROR_OUT_OF_MEMORY;
+
+		if (fread(event_info->Data, 1, record.data_length, fp) != record.data_length) {
+			g_free(event_info->Data);
+			event_info->Data = NULL;
+			return CONNECTION_ERROR_OPERATION_FAILED;
+		}
+
+		event_info->Datalength = record.data_length;
+	}
+
+	*timestamp = record.timestamp;
+
+	return CONNECTION_ERROR_NONE;
+}
@@ -22,12 +22,24 @@
 
 static GSList *conn_handle_list = NULL;
 
+struct _connection_callback_s {
+	void *callback;
+	void *user_data;
+};
+
+typedef int (*connection_callback_setter)(connection_h connection, void *callback, void *user_data);
+
 static void __connection_cb_state_change_cb(keynode_t *node, void *user_data);
 static void __connection_cb_ip_change_cb(keynode_t *node, void *user_data);
 static void __connection_cb_proxy_change_cb(keynode_t *node, void *user_data);
+static void __connection_cb_interface_change_cb(connection_netlink_event_e event,
+		const connection_netlink_interface_s *interface);
+static void __connection_cb_ethernet_change_cb(connection_ethernet_state_e state);
+static void __connection_cb_profile_list_refreshed_cb(void);
+static void __connection_cb_dns_servers_change_cb(const connection_dns_servers_s *servers);
 
 
-static int __connection_convert_net_state(int status)
+int _connection_convert_net_state(int status)
 {
 	switch (status) {
 	case VCONFKEY_NETWORK_CELLULAR:
@@ -39,7 +51,7 @@ static int __connection_convert_net_state(int status)
 	}
 }
 
-static int __connection_convert_cellular_state(int status)
+int _connection_convert_cellular_state(int status)
 {
 	switch (status) {
 	case VCONFKEY_NETWORK_CELLULAR_ON:
@@ -55,7 +67,7 @@ static int __connection_convert_cellular_state(int status)
 	}
 }
 
-static int __connection_convert_wifi_state(int status)
+int _connection_convert_wifi_state(int status)
 {
 	switch (status) {
 	case VCONFKEY_NETWORK_WIFI_CONNECTED:
@@ -106,6 +118,58 @@ static int __connection_get_proxy_changed_callback_count(void)
 	return count;
 }
 
+static int __connection_get_interface_address_changed_callback_count(void)
+{
+	GSList *list;
+	int count = 0;
+
+	for (list = conn_handle_list; list; list = list->next) {
+		connection_handle_s *local_handle = (connection_handle_s *)list->data;
+		if (local_handle->interface_address_changed_callback) count++;
+	}
+
+	return count;
+}
+
+static int __connection_get_ethernet_state_changed_callback_count(void)
+{
+	GSList *list;
+	int count = 0;
+
+	for (list = conn_handle_list; list; list = list->next) {
+		connection_handle_s *local_handle = (connection_handle_s *)list->data;
+		if (local_handle->ethernet_state_changed_callback) count++;
+	}
+
+	return count;
+}
+
+static int __connection_get_profile_list_refreshed_callback_count(void)
+{
+	GSList *list;
+	int count = 0;
+
+	for (list = conn_handle_list; list; list = list->next) {
+		connection_handle_s *local_handle = (connection_handle_s *)list->data;
+		if (local_handle->profile_list_refreshed_callback) count++;
+	}
+
+	return count;
+}
+
+static int __connection_get_dns_servers_changed_callback_count(void)
+{
+	GSList *list;
+	int count = 0;
+
+	for (list = conn_handle_list; list; list = list->next) {
+		connection_handle_s *local_handle = (connection_handle_s *)list->data;
+		if (local_handle->dns_servers_changed_callback) count++;
+	}
+
+	return count;
+}
+
 static int __connection_set_state_changed_callback(connection_h connection, void *callback, void *user_data)
 {
 	connection_handle_s *local_handle = (connection_handle_s *)connection;
@@ -175,55 +239,262 @@ static int __connection_set_proxy_changed_callback(connection_h connection, void
 	return CONNECTION_ERROR_NONE;
 }
 
+static int __connection_set_interface_address_changed_callback(connection_h connection,
+		void *callback, void *user_data)
+{
+	connection_handle_s *local_handle = (connection_handle_s *)connection;
+
+	if (callback) {
+		if (__connection_get_interface_address_changed_callback_count() == 0)
+			if (_connection_netlink_monitor_start(__connection_cb_interface_change_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+
+		local_handle->interface_address_changed_user_data = user_data;
+	} else {
+		if (local_handle->interface_address_changed_callback &&
+		    __connection_get_interface_address_changed_callback_count() == 1)
+			if (_connection_netlink_monitor_stop(__connection_cb_interface_change_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	local_handle->interface_address_changed_callback = callback;
+	return CONNECTION_ERROR_NONE;
+}
+
+static int __connection_set_ethernet_state_changed_callback(connection_h connection,
+		void *callback, void *user_data)
+{
+	connection_handle_s *local_handle = (connection_handle_s *)connection;
+
+	if (callback) {
+		if (__connection_get_ethernet_state_changed_callback_count() == 0)
+			if (_connection_ethernet_monitor_start(__connection_cb_ethernet_change_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+
+		local_handle->ethernet_state_changed_user_data = user_data;
+	} else {
+		if (local_handle->ethernet_state_changed_callback &&
+		    __connection_get_ethernet_state_changed_callback_count() == 1)
+			if (_connection_ethernet_monitor_stop(__connection_cb_ethernet_change_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	local_handle->ethernet_state_changed_callback = callback;
+	return CONNECTION_ERROR_NONE;
+}
+
+static int __connection_set_profile_list_refreshed_callback(connection_h connection,
+		void *callback, void *user_data)
+{
+	connection_handle_s *local_handle = (connection_handle_s *)connection;
+
+	if (callback) {
+		if (__connection_get_profile_list_refreshed_callback_count() == 0)
+			if (_connection_warm_start_watch(__connection_cb_profile_list_refreshed_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+
+		local_handle->profile_list_refreshed_user_data = user_data;
+	} else {
+		if (local_handle->profile_list_refreshed_callback &&
+		    __connection_get_profile_list_refreshed_callback_count() == 1)
+			if (_connection_warm_start_unwatch(__connection_cb_profile_list_refreshed_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	local_handle->profile_list_refreshed_callback = callback;
+	return CONNECTION_ERROR_NONE;
+}
+
+static int __connection_set_dns_servers_changed_callback(connection_h connection,
+		void *callback, void *user_data)
+{
+	connection_handle_s *local_handle = (connection_handle_s *)connection;
+
+	if (callback) {
+		if (__connection_get_dns_servers_changed_callback_count() == 0)
+			if (_connection_snapshot_watch_dns(__connection_cb_dns_servers_change_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+
+		local_handle->dns_servers_changed_user_data = user_data;
+	} else {
+		if (local_handle->dns_servers_changed_callback &&
+		    __connection_get_dns_servers_changed_callback_count() == 1)
+			if (_connection_snapshot_unwatch_dns(__connection_cb_dns_servers_change_cb))
+				return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	local_handle->dns_servers_changed_callback = callback;
+	return CONNECTION_ERROR_NONE;
+}
+
+/* Callbacks are collected under the lock and invoked without it, so they may call back into the API */
+static GArray *__connection_collect_callbacks(size_t callback_offset, size_t user_data_offset)
+{
+	GArray *callbacks = g_array_new(FALSE, FALSE, sizeof(struct _connection_callback_s));
+	GSList *list;
+
+	CONNECTION_MUTEX_LOCK;
+
+	for (list = conn_handle_list; list; list = list->next) {
+		struct _connection_callback_s entry;
+
+		entry.callback = G_STRUCT_MEMBER(void *, list->data, callback_offset);
+		entry.user_data = G_STRUCT_MEMBER(void *, list->data, user_data_offset);
+
+		if (entry.callback)
+			g_array_append_val(callbacks, entry);
+	}
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	return callbacks;
+}
+
 static void __connection_cb_state_change_cb(keynode_t *node, void *user_data)
 {
 	CONNECTION_LOG(CONNECTION_INFO, "Net Status Changed Indication\n");
 
-	GSList *list;
+	GArray *callbacks;
 	int state = vconf_keynode_get_int(node);
+	int i;
 
-	for (list = conn_handle_list; list; list = list->next) {
-		connection_handle_s *local_handle = (connection_handle_s *)list->data;
-		if (local_handle->state_changed_callback)
-			local_handle->state_changed_callback(
-					__connection_convert_net_state(state),
-					local_handle->state_changed_user_data);
+	callbacks = __connection_collect_callbacks(
+			G_STRUCT_OFFSET(connection_handle_s, state_changed_callback),
+			G_STRUCT_OFFSET(connection_handle_s, state_changed_user_data));
+
+	for (i = 0; i < callbacks->len; i++) {
+		struct _connection_callback_s *entry =
+				&g_array_index(callbacks, struct _connection_callback_s, i);
+		((connection_type_changed_cb)entry->callback)(
+				_connection_convert_net_state(state), entry->user_data);
 	}
+
+	g_array_free(callbacks, TRUE);
 }
 
 static void __connection_cb_ip_change_cb(keynode_t *node, void *user_data)
 {
 	CONNECTION_LOG(CONNECTION_INFO, "Net IP Changed Indication\n");
 
-	GSList *list;
+	GArray *callbacks;
 	char *ip_addr = vconf_keynode_get_str(node);
+	int i;
 
-	for (list = conn_handle_list; list; list = list->next) {
-		connection_handle_s *local_handle = (connection_handle_s *)list->data;
-		if (local_handle->ip_changed_callback)
-			local_handle->ip_changed_callback(
-					ip_addr, NULL,
-					local_handle->ip_changed_user_data);
+	callbacks = __connection_collect_callbacks(
+			G_STRUCT_OFFSET(connection_handle_s, ip_changed_callback),
+			G_STRUCT_OFFSET(connection_handle_s, ip_changed_user_data));
+
+	for (i = 0; i < callbacks->len; i++) {
+		struct _connection_callback_s *entry =
+				&g_array_index(callbacks, struct _connection_callback_s, i);
+		((connection_address_changed_cb)entry->callback)(ip_addr, NULL, entry->user_data);
 	}
+
+	g_array_free(callbacks, TRUE);
 }
 
 static void __connection_cb_proxy_change_cb(keynode_t *node, void *user_data)
 {
 	CONNECTION_LOG(CONNECTION_INFO, "Net IP Changed Indication\n");
 
-	GSList *list;
+	GArray *callbacks;
 	char *proxy = vconf_keynode_get_str(node);
+	int i;
 
-	for (list = conn_handle_list; list; list = list->next) {
-		connection_handle_s *local_handle = (connection_handle_s *)list->data;
-		if (local_handle->proxy_changed_callback)
-			local_handle->proxy_changed_callback(
-					proxy, NULL,
-					local_handle->proxy_changed_user_data);
+	callbacks = __connection_collect_callbacks(
+			G_STRUCT_OFFSET(connection_handle_s, proxy_changed_callback),
+			G_STRUCT_OFFSET(connection_handle_s, proxy_changed_user_data));
+
+	for (i = 0; i < callbacks->len; i++) {
+		struct _connection_callback_s *entry =
+				&g_array_index(callbacks, struct _connection_callback_s, i);
+		((connection_address_changed_cb)entry->callback)(proxy, NULL, entry->user_data);
 	}
+
+	g_array_free(callbacks, TRUE);
 }
 
-static bool __connection_check_handle_validity(connection_h connection)
+static void __connection_cb_interface_change_cb(connection_netlink_event_e event,
+		const connection_netlink_interface_s *interface)
+{
+	GArray *callbacks;
+	int i;
+
+	callbacks = __connection_collect_callbacks(
+			G_STRUCT_OFFSET(connection_handle_s, interface_address_changed_callback),
+			G_STRUCT_OFFSET(connection_handle_s, interface_address_changed_user_data));
+
+	for (i = 0; i < callbacks->len; i++) {
+		struct _connection_callback_s *entry =
+				&g_array_index(callbacks, struct _connection_callback_s, i);
+		((connection_interface_address_changed_cb)entry->callback)(interface->name,
+				interface->ipv4_address, interface->ipv6_address, entry->user_data);
+	}
+
+	g_array_free(callbacks, TRUE);
+}
+
+static void __connection_cb_ethernet_change_cb(connection_ethernet_state_e state)
+{
+	CONNECTION_LOG(CONNECTION_INFO, "Ethernet State Changed : %d\n", state);
+
+	GArray *callbacks;
+	int i;
+
+	callbacks = __connection_collect_callbacks(
+			G_STRUCT_OFFSET(connection_handle_s, ethernet_state_changed_callback),
+			G_STRUCT_OFFSET(connection_handle_s, ethernet_state_changed_user_data));
+
+	for (i = 0; i < callbacks->len; i++) {
+		struct _connection_callback_s *entry =
+				&g_array_index(callbacks, struct _connection_callback_s, i);
+		((connection_ethernet_state_changed_cb)entry->callback)(state, entry->user_data);
+	}
+
+	g_array_free(callbacks, TRUE);
+}
+
+static void __connection_cb_profile_list_refreshed_cb(void)
+{
+	CONNECTION_LOG(CONNECTION_INFO, "Profile List Refreshed\n");
+
+	GArray *callbacks;
+	int i;
+
+	callbacks = __connection_collect_callbacks(
+			G_STRUCT_OFFSET(connection_handle_s, profile_list_refreshed_callback),
+			G_STRUCT_OFFSET(connection_handle_s, profile_list_refreshed_user_data));
+
+	for (i = 0; i < callbacks->len; i++) {
+		struct _connection_callback_s *entry =
+				&g_array_index(callbacks, struct _connection_callback_s, i);
+		((connection_profile_list_refreshed_cb)entry->callback)(entry->user_data);
+	}
+
+	g_array_free(callbacks, TRUE);
+}
+
+static void __connection_cb_dns_servers_change_cb(const connection_dns_servers_s *servers)
+{
+	CONNECTION_LOG(CONNECTION_INFO, "DNS Servers Changed : %d\n", servers->count);
+
+	GArray *callbacks;
+	int i;
+
+	callbacks = __connection_collect_callbacks(
+			G_STRUCT_OFFSET(connection_handle_s, dns_servers_changed_callback),
+			G_STRUCT_OFFSET(connection_handle_s, dns_servers_changed_user_data));
+
+	for (i = 0; i < callbacks->len; i++) {
+		struct _connection_callback_s *entry =
+				&g_array_index(callbacks, struct _connection_callback_s, i);
+		((connection_dns_servers_changed_cb)entry->callback)(servers, entry->user_data);
+	}
+
+	g_array_free(callbacks, TRUE);
+}
+
+static bool __connection_find_handle(connection_h connection)
 {
 	GSList *list;
 
@@ -233,6 +504,36 @@ static bool __connection_check_handle_validity(connection_h connection)
 	return false;
 }
 
+static bool __connection_check_handle_validity(connection_h connection)
+{
+	bool valid;
+
+	CONNECTION_MUTEX_LOCK;
+	valid = __connection_find_handle(connection);
+	CONNECTION_MUTEX_UNLOCK;
+
+	return valid;
+}
+
+static int __connection_set_callback(connection_h connection, connection_callback_setter setter,
+		void *callback, void *user_data)
+{
+	int rv;
+
+	CONNECTION_MUTEX_LOCK;
+
+	if (!(__connection_find_handle(connection))) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		CONNECTION_MUTEX_UNLOCK;
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	rv = setter(connection, callback, user_data);
+
+	CONNECTION_MUTEX_UNLOCK;
+	return rv;
+}
+
 static int __connection_get_handle_count(void)
 {
 	GSList *list;
@@ -252,7 +553,7 @@ int connection_create(connection_h* connection)
 {
 	CONNECTION_MUTEX_LOCK;
 
-	if (connection == NULL || __connection_check_handle_validity(*connection)) {
+	if (connection == NULL || __connection_find_handle(*connection)) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		CONNECTION_MUTEX_UNLOCK;
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -272,7 +573,13 @@ int connection_create(connection_h* connection)
 		return CONNECTION_ERROR_OUT_OF_MEMORY;
 	}
 
+	if (conn_handle_list == NULL) {
+		_connection_snapshot_open();
+		_connection_state_page_open();
+	}
+
 	conn_handle_list = g_slist_append(conn_handle_list, *connection);
+	_connection_memory_add(CONNECTION_MEMORY_HANDLE, 1, sizeof(connection_handle_s) + sizeof(GSList));
 
 	CONNECTION_MUTEX_UNLOCK;
 	return CONNECTION_ERROR_NONE;
@@ -282,7 +589,7 @@ int connection_destroy(connection_h connection)
 {
 	CONNECTION_MUTEX_LOCK;
 
-	if (connection == NULL || !(__connection_check_handle_validity(connection))) {
+	if (connection == NULL || !(__connection_find_handle(connection))) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		CONNECTION_MUTEX_UNLOCK;
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -293,13 +600,21 @@ int connection_destroy(connection_h connection)
 	__connection_set_state_changed_callback(connection, NULL, NULL);
 	__connection_set_ip_changed_callback(connection, NULL, NULL);
 	__connection_set_proxy_changed_callback(connection, NULL, NULL);
+	__connection_set_interface_address_changed_callback(connection, NULL, NULL);
+	__connection_set_ethernet_state_changed_callback(connection, NULL, NULL);
+	__connection_set_profile_list_refreshed_callback(connection, NULL, NULL);
+	__connection_set_dns_servers_changed_callback(connection, NULL, NULL);
 
 	conn_handle_list = g_slist_remove(conn_handle_list, connection);
+	_connection_memory_add(CONNECTION_MEMORY_HANDLE, -1, -(long long)(sizeof(connection_handle_s) + sizeof(GSList)));
 
 	g_free(connection);
 
-	if (__connection_get_handle_count() == 0)
+	if (__connection_get_handle_count() == 0) {
+		_connection_snapshot_clear();
+		_connection_state_page_close();
 		_connection_libnet_deinit();
+	}
 
 	CONNECTION_MUTEX_UNLOCK;
 	return CONNECTION_ERROR_NONE;
@@ -307,6 +622,7 @@ int connection_destroy(connection_h connection)
 
 int connection_get_type(connection_h connection, connection_type_e* type)
 {
+	connection_state_facts_s facts;
 	int status = 0;
 
 	if (type == NULL || !(__connection_check_handle_validity(connection))) {
@@ -314,20 +630,24 @@ int connection_get_type(connection_h connection, connection_type_e* type)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	if (vconf_get_int(VCONFKEY_NETWORK_STATUS, &status)) {
+	if (_connection_state_page_get_facts(&facts)) {
+		status = facts.network_status;
+	} else if (vconf_get_int(VCONFKEY_NETWORK_STATUS, &status)) {
 		CONNECTION_LOG(CONNECTION_ERROR, "vconf_get_int Failed = %d\n", status);
 		return CONNECTION_ERROR_OPERATION_FAILED;
 	}
 
 	CONNECTION_LOG(CONNECTION_INFO, "Connected Network = %d\n", status);
 
-	*type = __connection_convert_net_state(status);
+	*type = _connection_convert_net_state(status);
 
 	return CONNECTION_ERROR_NONE;
 }
 
 int connection_get_ip_address(connection_h connection, connection_address_family_e address_family, char** ip_address)
 {
+	connection_state_facts_s facts;
+
 	if (ip_address == NULL || !(__connection_check_handle_validity(connection))) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -335,7 +655,10 @@ int connection_get_ip_address(connection_h connection, connection_address_family
 
 	switch (address_family) {
 	case CONNECTION_ADDRESS_FAMILY_IPV4:
-		*ip_address = vconf_get_str(VCONFKEY_NETWORK_IP);
+		if (_connection_state_page_get_facts(&facts))
+			*ip_address = strdup(facts.ip_address);
+		else
+			*ip_address = vconf_get_str(VCONFKEY_NETWORK_IP);
 		break;
 	case CONNECTION_ADDRESS_FAMILY_IPV6:
 		CONNECTION_LOG(CONNECTION_ERROR, "Not supported yet\n");
@@ -358,6 +681,8 @@ int connection_get_ip_address(connection_h connection, connection_address_family
 
 int connection_get_proxy(connection_h connection, connection_address_family_e address_family, char** proxy)
 {
+	connection_state_facts_s facts;
+
 	if (proxy == NULL || !(__connection_check_handle_validity(connection))) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -365,7 +690,10 @@ int connection_get_proxy(connection_h connection, connection_address_family_e ad
 
 	switch (address_family) {
 	case CONNECTION_ADDRESS_FAMILY_IPV4:
-		*proxy = vconf_get_str(VCONFKEY_NETWORK_PROXY);
+		if (_connection_state_page_get_facts(&facts))
+			*proxy = strdup(facts.proxy_address);
+		else
+			*proxy = vconf_get_str(VCONFKEY_NETWORK_PROXY);
 		break;
 	case CONNECTION_ADDRESS_FAMILY_IPV6:
 		CONNECTION_LOG(CONNECTION_ERROR, "Not supported yet\n");
@@ -386,8 +714,29 @@ int connection_get_proxy(connection_h connection, connection_address_family_e ad
 	return CONNECTION_ERROR_NONE;
 }
 
+int connection_get_proxy_endpoint(connection_h connection, connection_proxy_endpoint_s* endpoint)
+{
+	if (connection == NULL || endpoint == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_snapshot_get_proxy(endpoint);
+}
+
+int connection_get_dns_servers(connection_h connection, connection_dns_servers_s* servers)
+{
+	if (connection == NULL || servers == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_snapshot_get_dns_servers(servers);
+}
+
 int connection_get_cellular_state(connection_h connection, connection_cellular_state_e* state)
 {
+	connection_state_facts_s facts;
 	int status = 0;
 
 	if (state == NULL || !(__connection_check_handle_validity(connection))) {
@@ -395,9 +744,12 @@ int connection_get_cellular_state(connection_h connection, connection_cellular_s
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	if (!vconf_get_int(VCONFKEY_NETWORK_CELLULAR_STATE, &status)) {
+	if (_connection_state_page_get_facts(&facts)) {
+		*state = _connection_convert_cellular_state(facts.cellular_state);
+		return CONNECTION_ERROR_NONE;
+	} else if (!vconf_get_int(VCONFKEY_NETWORK_CELLULAR_STATE, &status)) {
 		CONNECTION_LOG(CONNECTION_INFO, "Cellular = %d\n", status);
-		*state = __connection_convert_cellular_state(status);
+		*state = _connection_convert_cellular_state(status);
 		return CONNECTION_ERROR_NONE;
 	} else {
 		CONNECTION_LOG(CONNECTION_ERROR, "vconf_get_int Failed = %d\n", status);
@@ -407,6 +759,7 @@ int connection_get_cellular_state(connection_h connection, connection_cellular_s
 
 int connection_get_wifi_state(connection_h connection, connection_wifi_state_e* state)
 {
+	connection_state_facts_s facts;
 	int status = 0;
 
 	if (state == NULL || !(__connection_check_handle_validity(connection))) {
@@ -414,9 +767,12 @@ int connection_get_wifi_state(connection_h connection, connection_wifi_state_e*
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	if (!vconf_get_int(VCONFKEY_NETWORK_WIFI_STATE, &status)) {
+	if (_connection_state_page_get_facts(&facts)) {
+		*state = _connection_convert_wifi_state(facts.wifi_state);
+		return CONNECTION_ERROR_NONE;
+	} else if (!vconf_get_int(VCONFKEY_NETWORK_WIFI_STATE, &status)) {
 		CONNECTION_LOG(CONNECTION_INFO, "WiFi = %d\n", status);
-		*state = __connection_convert_wifi_state(status);
+		*state = _connection_convert_wifi_state(status);
 		return CONNECTION_ERROR_NONE;
 	} else {
 		CONNECTION_LOG(CONNECTION_ERROR, "vconf_get_int Failed = %d\n", status);
@@ -424,80 +780,147 @@ int connection_get_wifi_state(connection_h connection, connection_wifi_state_e*
 	}
 }
 
-int connection_get_ethernet_state(connection_h connection, connection_ethernet_state_e* state)
+int connection_get_snapshot(connection_h connection, connection_snapshot_s* snapshot)
 {
-	if (state == NULL || !(__connection_check_handle_validity(connection))) {
+	connection_snapshot_state_s state;
+	int rv;
+
+	if (connection == NULL || snapshot == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	if (_connection_libnet_get_ethernet_state(state) == false)
-		return CONNECTION_ERROR_OPERATION_FAILED;
+	rv = _connection_snapshot_get(&state);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	snapshot->version = state.version;
+	snapshot->type = _connection_convert_net_state(state.facts.network_status);
+	snapshot->wifi_state = _connection_convert_wifi_state(state.facts.wifi_state);
+	snapshot->cellular_state = _connection_convert_cellular_state(state.facts.cellular_state);
+	snapshot->ethernet_state = state.ethernet_state;
+	g_strlcpy(snapshot->ip_address, state.facts.ip_address, sizeof(snapshot->ip_address));
+	g_strlcpy(snapshot->proxy_address, state.facts.proxy_address, sizeof(snapshot->proxy_address));
+
+	snapshot->has_profile = state.has_profile;
+	snapshot->profile_type = state.profile_type;
+	snapshot->profile_state = state.profile_state;
+	g_strlcpy(snapshot->profile_name, state.profile_name, sizeof(snapshot->profile_name));
+	g_strlcpy(snapshot->interface_name, state.interface_name, sizeof(snapshot->interface_name));
 
 	return CONNECTION_ERROR_NONE;
 }
 
+int connection_get_ethernet_state(connection_h connection, connection_ethernet_state_e* state)
+{
+	if (state == NULL || !(__connection_check_handle_validity(connection))) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_ethernet_get_state(state);
+}
+
 int connection_set_type_changed_cb(connection_h connection,
 					connection_type_changed_cb callback, void* user_data)
 {
-	if (callback == NULL || !(__connection_check_handle_validity(connection))) {
+	if (callback == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return __connection_set_state_changed_callback(connection, callback, user_data);
+	return __connection_set_callback(connection, __connection_set_state_changed_callback, callback, user_data);
 }
 
 int connection_unset_type_changed_cb(connection_h connection)
 {
-	if (!(__connection_check_handle_validity(connection))) {
+	return __connection_set_callback(connection, __connection_set_state_changed_callback, NULL, NULL);
+}
+
+int connection_set_ip_address_changed_cb(connection_h connection,
+				connection_address_changed_cb callback, void* user_data)
+{
+	if (callback == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return __connection_set_state_changed_callback(connection, NULL, NULL);
+	return __connection_set_callback(connection, __connection_set_ip_changed_callback, callback, user_data);
 }
 
-int connection_set_ip_address_changed_cb(connection_h connection,
+int connection_unset_ip_address_changed_cb(connection_h connection)
+{
+	return __connection_set_callback(connection, __connection_set_ip_changed_callback, NULL, NULL);
+}
+
+int connection_set_proxy_address_changed_cb(connection_h connection,
 				connection_address_changed_cb callback, void* user_data)
 {
-	if (callback == NULL || !(__connection_check_handle_validity(connection))) {
+	if (callback == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return __connection_set_ip_changed_callback(connection, callback, user_data);
+	return __connection_set_callback(connection, __connection_set_proxy_changed_callback, callback, user_data);
 }
 
-int connection_unset_ip_address_changed_cb(connection_h connection)
+int connection_unset_proxy_address_changed_cb(connection_h connection)
 {
-	if (!(__connection_check_handle_validity(connection))) {
+	return __connection_set_callback(connection, __connection_set_proxy_changed_callback, NULL, NULL);
+}
+
+int connection_set_interface_address_changed_cb(connection_h connection,
+				connection_interface_address_changed_cb callback, void* user_data)
+{
+	if (callback == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return __connection_set_ip_changed_callback(connection, NULL, NULL);
+	return __connection_set_callback(connection, __connection_set_interface_address_changed_callback,
+			callback, user_data);
 }
 
-int connection_set_proxy_address_changed_cb(connection_h connection,
-				connection_address_changed_cb callback, void* user_data)
+int connection_unset_interface_address_changed_cb(connection_h connection)
+{
+	return __connection_set_callback(connection, __connection_set_interface_address_changed_callback,
+			NULL, NULL);
+}
+
+int connection_set_ethernet_state_changed_cb(connection_h connection,
+				connection_ethernet_state_changed_cb callback, void* user_data)
 {
-	if (callback == NULL || !(__connection_check_handle_validity(connection))) {
+	if (callback == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return __connection_set_proxy_changed_callback(connection, callback, user_data);
+	return __connection_set_callback(connection, __connection_set_ethernet_state_changed_callback,
+			callback, user_data);
 }
 
-int connection_unset_proxy_address_changed_cb(connection_h connection)
+int connection_unset_ethernet_state_changed_cb(connection_h connection)
+{
+	return __connection_set_callback(connection, __connection_set_ethernet_state_changed_callback,
+			NULL, NULL);
+}
+
+int connection_set_dns_servers_changed_cb(connection_h connection,
+				connection_dns_servers_changed_cb callback, void* user_data)
 {
-	if (!(__connection_check_handle_validity(connection))) {
+	if (callback == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return __connection_set_proxy_changed_callback(connection, NULL, NULL);
+	return __connection_set_callback(connection, __connection_set_dns_servers_changed_callback,
+			callback, user_data);
+}
+
+int connection_unset_dns_servers_changed_cb(connection_h connection)
+{
+	return __connection_set_callback(connection, __connection_set_dns_servers_changed_callback,
+			NULL, NULL);
 }
 
 int connection_add_profile(connection_h connection, connection_profile_h profile)
@@ -510,14 +933,21 @@ int connection_add_profile(connection_h connection, connection_profile_h profile
 
 	int rv = 0;
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
-	rv = net_add_profile(profile_info->ProfileInfo.Pdp.ServiceType, (net_profile_info_t*)profile);
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	rv = net_add_profile(profile_info->ProfileInfo.Pdp.ServiceType, profile_info);
 	if (rv != NET_ERR_NONE) {
 		CONNECTION_LOG(CONNECTION_ERROR, "net_add_profile Failed = %d\n", rv);
 		return CONNECTION_ERROR_OPERATION_FAILED;
 	}
 
+	_connection_tracker_refresh();
+
 	return CONNECTION_ERROR_NONE;
 }
 
@@ -530,7 +960,12 @@ int connection_remove_profile(connection_h connection, connection_profile_h prof
 	}
 
 	int rv = 0;
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
+
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
 
 	rv = net_delete_profile(profile_info->ProfileName);
 	if (rv != NET_ERR_NONE) {
@@ -538,6 +973,8 @@ int connection_remove_profile(connection_h connection, connection_profile_h prof
 		return CONNECTION_ERROR_OPERATION_FAILED;
 	}
 
+	_connection_tracker_refresh();
+
 	return CONNECTION_ERROR_NONE;
 }
 
@@ -550,14 +987,21 @@ int connection_update_profile(connection_h connection, connection_profile_h prof
 	}
 
 	int rv = 0;
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
+
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
 
-	rv = net_modify_profile(profile_info->ProfileName, (net_profile_info_t*)profile);
+	rv = net_modify_profile(profile_info->ProfileName, profile_info);
 	if (rv != NET_ERR_NONE) {
 		CONNECTION_LOG(CONNECTION_ERROR, "net_modify_profile Failed = %d\n", rv);
 		return CONNECTION_ERROR_OPERATION_FAILED;
 	}
 
+	_connection_tracker_refresh();
+
 	return CONNECTION_ERROR_NONE;
 }
 
@@ -574,6 +1018,59 @@ int connection_get_profile_iterator(connection_h connection,
 	return _connection_libnet_get_profile_iterator(type, profile_iterator);
 }
 
+int connection_get_wifi_profile_iterator_by_strength(connection_h connection, int max_count,
+		connection_profile_iterator_h* profile_iterator)
+{
+	if (!(__connection_check_handle_validity(connection)) || max_count < 0 || profile_iterator == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_libnet_get_wifi_iterator_by_strength(max_count, profile_iterator);
+}
+
+int connection_set_warm_start_path(const char* path)
+{
+	return _connection_warm_start_set_path(path);
+}
+
+int connection_set_state_page_path(const char* path)
+{
+	return _connection_state_page_set_path(path);
+}
+
+int connection_get_cached_profile_iterator(connection_h connection, connection_iterator_type_e type,
+		connection_profile_iterator_h* profile_iterator, bool* is_stale)
+{
+	if (!(__connection_check_handle_validity(connection)) ||
+	    (type != CONNECTION_ITERATOR_TYPE_REGISTERED &&
+	     type != CONNECTION_ITERATOR_TYPE_CONNECTED) ||
+	    profile_iterator == NULL || is_stale == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_warm_start_get_iterator(type, profile_iterator, is_stale);
+}
+
+int connection_set_profile_list_refreshed_cb(connection_h connection,
+				connection_profile_list_refreshed_cb callback, void* user_data)
+{
+	if (callback == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return __connection_set_callback(connection, __connection_set_profile_list_refreshed_callback,
+			callback, user_data);
+}
+
+int connection_unset_profile_list_refreshed_cb(connection_h connection)
+{
+	return __connection_set_callback(connection, __connection_set_profile_list_refreshed_callback,
+			NULL, NULL);
+}
+
 int connection_profile_iterator_next(connection_profile_iterator_h profile_iterator, connection_profile_h* profile)
 {
 	return _connection_libnet_get_iterator_next(profile_iterator, profile);
@@ -599,6 +1096,17 @@ int connection_get_current_profile(connection_h connection, connection_profile_h
 	return _connection_libnet_get_current_profile(profile);
 }
 
+int connection_get_best_profile(connection_h connection, connection_profile_score_cb score_cb,
+		void* user_data, connection_profile_h* profile)
+{
+	if (!(__connection_check_handle_validity(connection)) || profile == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_selection_get_best_profile(score_cb, user_data, profile);
+}
+
 int connection_open_profile(connection_h connection, connection_profile_h profile)
 {
 	if (!(__connection_check_handle_validity(connection)) || profile == NULL) {
@@ -631,6 +1139,107 @@ int connection_close_profile(connection_h connection, connection_profile_h profi
 }
 
 
+int connection_get_memory_usage(connection_memory_usage_s* usage)
+{
+	if (usage == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	_connection_memory_get_usage(usage);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int connection_reset_memory_peak(void)
+{
+	_connection_memory_reset_peak();
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int connection_dump_live_handles(void)
+{
+	connection_memory_usage_s usage;
+	GSList *list;
+
+	_connection_memory_get_usage(&usage);
+
+	CONNECTION_LOG(CONNECTION_INFO, "Live handles %d, profiles %d, iterators %d, callbacks %d : "
+			"%lld bytes, peak %lld bytes\n", usage.handles.count, usage.profiles.count,
+			usage.iterators.count, usage.callbacks.count, usage.total_bytes, usage.peak_bytes);
+
+	CONNECTION_MUTEX_LOCK;
+
+	for (list = conn_handle_list; list; list = list->next) {
+		connection_handle_s *local_handle = list->data;
+
+		CONNECTION_LOG(CONNECTION_INFO, "Connection handle %p : type cb %p, ip cb %p, proxy cb %p\n",
+				local_handle, local_handle->state_changed_callback,
+				local_handle->ip_changed_callback, local_handle->proxy_changed_callback);
+	}
+
+	_connection_libnet_dump_handles();
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int connection_get_profile_changes(connection_h connection, unsigned long long since_generation,
+		unsigned long long* generation, connection_profile_change_s** changes, int* count)
+{
+	if (!(__connection_check_handle_validity(connection)) ||
+	    generation == NULL || changes == NULL || count == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_tracker_get_changes(since_generation, generation, changes, count);
+}
+
+int connection_free_profile_changes(connection_profile_change_s* changes, int count)
+{
+	if (count < 0 || (changes == NULL && count > 0)) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	_connection_tracker_free_changes(changes, count);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int connection_get_profile_by_name(connection_h connection, const char* profile_name, connection_profile_h* profile)
+{
+	if (!(__connection_check_handle_validity(connection)) || profile_name == NULL || profile == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_tracker_find_profile(CONNECTION_TRACKER_KEY_NAME, profile_name, profile);
+}
+
+int connection_get_wifi_profile_by_essid(connection_h connection, const char* essid, connection_profile_h* profile)
+{
+	if (!(__connection_check_handle_validity(connection)) || essid == NULL || profile == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_tracker_find_profile(CONNECTION_TRACKER_KEY_ESSID, essid, profile);
+}
+
+int connection_get_wifi_profile_by_bssid(connection_h connection, const char* bssid, connection_profile_h* profile)
+{
+	if (!(__connection_check_handle_validity(connection)) || bssid == NULL || profile == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_tracker_find_profile(CONNECTION_TRACKER_KEY_BSSID, bssid, profile);
+}
+
 /* Connection Statistics module ******************************************************************/
 
 static int __get_statistic(connection_type_e connection_type, connection_statistics_type_e statistics_type, long long* llsize)
@@ -638,6 +1247,7 @@ static int __get_statistic(connection_type_e connection_type, connection_statist
 	int size;
 	unsigned long long ull_size;
 	int stat_type;
+	int rv;
 	char *key = NULL;
 
 	if (llsize == NULL) {
@@ -663,6 +1273,12 @@ static int __get_statistic(connection_type_e connection_type, connection_statist
 			return CONNECTION_ERROR_INVALID_PARAMETER;
 		}
 
+		if (_connection_statistics_get(NET_DEVICE_CELLULAR, statistics_type, &ull_size) == CONNECTION_ERROR_NONE) {
+			CONNECTION_LOG(CONNECTION_INFO,"%s:%llu bytes\n", key, ull_size);
+			*llsize = (long long)ull_size;
+			return CONNECTION_ERROR_NONE;
+		}
+
 		if (vconf_get_int(key, &size)) {
 			CONNECTION_LOG(CONNECTION_ERROR, "Cannot Get %s = %d\n", key, size);
 			*llsize = 0;
@@ -689,13 +1305,32 @@ static int __get_statistic(connection_type_e connection_type, connection_statist
 			return CONNECTION_ERROR_INVALID_PARAMETER;
 		}
 
-		if (_connection_libnet_get_statistics(stat_type, &ull_size) != CONNECTION_ERROR_NONE) {
-			CONNECTION_LOG(CONNECTION_ERROR, "Cannot Get Wi-Fi statistics : %d\n", ull_size);
+		if (_connection_statistics_get(NET_DEVICE_WIFI, statistics_type, &ull_size) == CONNECTION_ERROR_NONE) {
+			CONNECTION_LOG(CONNECTION_INFO,"%llu bytes\n", ull_size);
+			*llsize = (long long)ull_size;
+			return CONNECTION_ERROR_NONE;
+		}
+
+		if (_connection_libnet_get_statistics(NET_DEVICE_WIFI, stat_type, &ull_size) != CONNECTION_ERROR_NONE) {
+			CONNECTION_LOG(CONNECTION_ERROR, "Cannot Get Wi-Fi statistics : %llu\n", ull_size);
+			*llsize = 0;
+			return CONNECTION_ERROR_OPERATION_FAILED;
+		}
+
+		CONNECTION_LOG(CONNECTION_INFO,"%llu bytes\n", ull_size);
+		*llsize = (long long)ull_size;
+	} else if (connection_type == CONNECTION_TYPE_ETHERNET) {
+		rv = _connection_statistics_get(NET_DEVICE_ETHERNET, statistics_type, &ull_size);
+		if (rv == CONNECTION_ERROR_INVALID_PARAMETER)
+			return rv;
+
+		if (rv != CONNECTION_ERROR_NONE) {
+			CONNECTION_LOG(CONNECTION_ERROR, "Cannot Get ethernet statistics\n");
 			*llsize = 0;
 			return CONNECTION_ERROR_OPERATION_FAILED;
 		}
 
-		CONNECTION_LOG(CONNECTION_INFO,"%d bytes\n", ull_size);
+		CONNECTION_LOG(CONNECTION_INFO,"%llu bytes\n", ull_size);
 		*llsize = (long long)ull_size;
 	} else
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -713,6 +1348,8 @@ static int __reset_statistic(connection_type_e connection_type, connection_stati
 		conn_type = NET_DEVICE_CELLULAR;
 	else if (connection_type == CONNECTION_TYPE_WIFI)
 		conn_type = NET_DEVICE_WIFI;
+	else if (connection_type == CONNECTION_TYPE_ETHERNET)
+		conn_type = NET_DEVICE_ETHERNET;
 	else
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 
@@ -733,8 +1370,15 @@ static int __reset_statistic(connection_type_e connection_type, connection_stati
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	rv = _connection_libnet_set_statistics(conn_type, stat_type);
-	if(rv != CONNECTION_ERROR_NONE)
+	/* The network daemon keeps no ethernet statistics */
+	if (conn_type != NET_DEVICE_ETHERNET) {
+		rv = _connection_libnet_set_statistics(conn_type, stat_type);
+		if(rv != CONNECTION_ERROR_NONE)
+			return rv;
+	}
+
+	rv = _connection_statistics_reset(conn_type, statistics_type);
+	if (rv != CONNECTION_ERROR_NONE && conn_type == NET_DEVICE_ETHERNET)
 		return rv;
 
 
@@ -748,8 +1392,200 @@ int connection_get_statistics(connection_type_e connection_type, connection_stat
 	return __get_statistic(connection_type, statistics_type, size);
 }
 
+int connection_get_all_statistics(connection_statistics_info_s* statistics)
+{
+	const net_device_t device_types[3] = {NET_DEVICE_CELLULAR, NET_DEVICE_WIFI, NET_DEVICE_ETHERNET};
+	const connection_type_e connection_types[3] = {CONNECTION_TYPE_CELLULAR, CONNECTION_TYPE_WIFI,
+			CONNECTION_TYPE_ETHERNET};
+	connection_statistics_counter_s counters[3];
+	connection_statistics_data_s *data[3];
+	int results[3];
+	bool read = false;
+	int i;
+
+	if (statistics == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	memset(statistics, 0, sizeof(connection_statistics_info_s));
+	data[0] = &statistics->cellular;
+	data[1] = &statistics->wifi;
+	data[2] = &statistics->ethernet;
+
+	/* Every type is read once: from the kernel counters, or the values the engine was seeded with */
+	if (_connection_statistics_get_devices(3, device_types, counters, results) != CONNECTION_ERROR_NONE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	for (i = 0; i < 3; i++) {
+		if (results[i] != CONNECTION_ERROR_NONE) {
+			/* The same fallback as connection_get_statistics(), one value at a time */
+			data[i]->is_valid =
+				__get_statistic(connection_types[i], CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA,
+						&data[i]->last_received) == CONNECTION_ERROR_NONE &&
+				__get_statistic(connection_types[i], CONNECTION_STATISTICS_TYPE_LAST_SENT_DATA,
+						&data[i]->last_sent) == CONNECTION_ERROR_NONE &&
+				__get_statistic(connection_types[i], CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA,
+						&data[i]->total_received) == CONNECTION_ERROR_NONE &&
+				__get_statistic(connection_types[i], CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA,
+						&data[i]->total_sent) == CONNECTION_ERROR_NONE;
+
+			if (!data[i]->is_valid)
+				memset(data[i], 0, sizeof(connection_statistics_data_s));
+		} else {
+			data[i]->last_received = (long long)counters[i].last[CONNECTION_STATISTICS_DIRECTION_RX];
+			data[i]->last_sent = (long long)counters[i].last[CONNECTION_STATISTICS_DIRECTION_TX];
+			data[i]->total_received = (long long)counters[i].total[CONNECTION_STATISTICS_DIRECTION_RX];
+			data[i]->total_sent = (long long)counters[i].total[CONNECTION_STATISTICS_DIRECTION_TX];
+			data[i]->is_valid = true;
+		}
+
+		if (data[i]->is_valid)
+			read = true;
+	}
+
+	if (!read) {
+		CONNECTION_LOG(CONNECTION_ERROR, "No statistics could be read\n");
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
+
 int connection_reset_statistics(connection_type_e connection_type, connection_statistics_type_e statistics_type)
 {
 	return __reset_statistic(connection_type, statistics_type);
 }
 
+int connection_get_profile_statistics(connection_profile_h profile,
+		connection_statistics_type_e statistics_type, long long* size)
+{
+	connection_profile_type_e profile_type;
+	connection_type_e connection_type;
+	connection_statistics_direction_e direction;
+	unsigned long long ull_size;
+	char *interface_name = NULL;
+	int rv;
+
+	if (!(_connection_libnet_check_profile_validity(profile)) || size == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	switch (statistics_type) {
+	case CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA:
+		direction = CONNECTION_STATISTICS_DIRECTION_RX;
+		break;
+	case CONNECTION_STATISTICS_TYPE_LAST_SENT_DATA:
+		direction = CONNECTION_STATISTICS_DIRECTION_TX;
+		break;
+	case CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA:
+	case CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA:
+		rv = connection_profile_get_type(profile, &profile_type);
+		if (rv != CONNECTION_ERROR_NONE)
+			return rv;
+
+		switch (profile_type) {
+		case CONNECTION_PROFILE_TYPE_CELLULAR:
+			connection_type = CONNECTION_TYPE_CELLULAR;
+			break;
+		case CONNECTION_PROFILE_TYPE_WIFI:
+			connection_type = CONNECTION_TYPE_WIFI;
+			break;
+		case CONNECTION_PROFILE_TYPE_ETHERNET:
+			connection_type = CONNECTION_TYPE_ETHERNET;
+			break;
+		default:
+			return CONNECTION_ERROR_INVALID_PARAMETER;
+		}
+
+		return __get_statistic(connection_type, statistics_type, size);
+	default:
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	rv = connection_profile_get_network_interface_name(profile, &interface_name);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	rv = _connection_statistics_get_interface(interface_name, direction, &ull_size);
+	if (rv != CONNECTION_ERROR_NONE) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot Get statistics of %s\n", interface_name);
+		g_free(interface_name);
+		*size = 0;
+		return rv;
+	}
+
+	CONNECTION_LOG(CONNECTION_INFO,"%s:%llu bytes\n", interface_name, ull_size);
+	*size = (long long)ull_size;
+	g_free(interface_name);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+
+int connection_start_rate_sampling(int interval)
+{
+	return _connection_sampler_start(interval);
+}
+
+int connection_stop_rate_sampling(int interval)
+{
+	return _connection_sampler_stop(interval);
+}
+
+int connection_get_statistics_rate(connection_type_e connection_type, int window, connection_statistics_rate_s* rate)
+{
+	net_device_t device_type;
+
+	switch (connection_type) {
+	case CONNECTION_TYPE_WIFI:
+		device_type = NET_DEVICE_WIFI;
+		break;
+	case CONNECTION_TYPE_CELLULAR:
+		device_type = NET_DEVICE_CELLULAR;
+		break;
+	case CONNECTION_TYPE_ETHERNET:
+		device_type = NET_DEVICE_ETHERNET;
+		break;
+	default:
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_sampler_get_rate(device_type, window, rate);
+}
+
+int connection_add_statistics_threshold(connection_type_e connection_type, connection_statistics_type_e statistics_type,
+		long long threshold, connection_statistics_threshold_cb callback, void* user_data, int* threshold_id)
+{
+	net_device_t device_type;
+
+	switch (connection_type) {
+	case CONNECTION_TYPE_WIFI:
+		device_type = NET_DEVICE_WIFI;
+		break;
+	case CONNECTION_TYPE_CELLULAR:
+		device_type = NET_DEVICE_CELLULAR;
+		break;
+	case CONNECTION_TYPE_ETHERNET:
+		device_type = NET_DEVICE_ETHERNET;
+		break;
+	default:
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	if (threshold <= 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return _connection_threshold_add(connection_type, device_type, statistics_type,
+			(unsigned long long)threshold, callback, user_data, threshold_id);
+}
+
+int connection_remove_statistics_threshold(int threshold_id)
+{
+	return _connection_threshold_remove(threshold_id);
+}
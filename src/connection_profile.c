@@ -16,6 +16,9 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
 #include <glib.h>
 #include <vconf/vconf.h>
 #include "net_connection_private.h"
@@ -57,7 +60,7 @@ static net_dev_info_t* __profile_get_net_info(net_profile_info_t *profile_info)
 	}
 }
 
-static connection_profile_state_e __profile_convert_to_cp_state(net_state_type_t state)
+connection_profile_state_e _connection_profile_convert_to_cp_state(net_state_type_t state)
 {
 	connection_profile_state_e cp_state;
 
@@ -97,6 +100,53 @@ static char* __profile_convert_ip_to_string(net_addr_t *ip_addr)
 	return ipstr;
 }
 
+connection_cellular_network_type_e _connection_profile_convert_to_cp_network_type(net_pdp_type_t type)
+{
+	switch (type) {
+	case NET_PDP_TYPE_NONE:
+		return CONNECTION_CELLULAR_NETWORK_TYPE_UNKNOWN;
+	case NET_PDP_TYPE_GPRS:
+		return CONNECTION_CELLULAR_NETWORK_TYPE_GPRS;
+	case NET_PDP_TYPE_EDGE:
+		return CONNECTION_CELLULAR_NETWORK_TYPE_EDGE;
+	case NET_PDP_TYPE_UMTS:
+		return CONNECTION_CELLULAR_NETWORK_TYPE_UMTS;
+	default:
+		return -1;
+	}
+}
+
+void _connection_profile_get_dns_servers(net_dev_info_t *net_info, connection_dns_servers_s *servers)
+{
+	connection_dns_server_s *server;
+	net_addr_t *address;
+	int i;
+
+	memset(servers, 0, sizeof(connection_dns_servers_s));
+
+	/* The setters fill entries without counting them: an unspecified address is an empty entry */
+	for (i = 0; i < NET_DNS_ADDR_MAX && servers->count < CONNECTION_DNS_SERVER_MAX; i++) {
+		address = &net_info->DnsAddr[i];
+		server = &servers->servers[servers->count];
+
+		if (address->Type == NET_ADDR_IPV6) {
+			if (IN6_IS_ADDR_UNSPECIFIED(&address->Data.Ipv6))
+				continue;
+
+			server->address_family = CONNECTION_ADDRESS_FAMILY_IPV6;
+			memcpy(server->address, &address->Data.Ipv6, sizeof(struct in6_addr));
+		} else {
+			if (address->Data.Ipv4.s_addr == INADDR_ANY)
+				continue;
+
+			server->address_family = CONNECTION_ADDRESS_FAMILY_IPV4;
+			memcpy(server->address, &address->Data.Ipv4, sizeof(struct in_addr));
+		}
+
+		servers->count++;
+	}
+}
+
 net_service_type_t _connection_profile_convert_to_libnet_cellular_service_type(connection_cellular_service_type_e svc_type)
 {
 	switch (svc_type) {
@@ -175,23 +225,26 @@ int connection_profile_create(connection_profile_type_e type, connection_profile
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = g_try_malloc0(sizeof(net_profile_info_t));
-	if (profile_info == NULL)
-		return CONNECTION_ERROR_OUT_OF_MEMORY;
+	net_profile_info_t profile_info;
+
+	memset(&profile_info, 0, sizeof(net_profile_info_t));
 
 	switch (type) {
 	case CONNECTION_PROFILE_TYPE_CELLULAR:
-		__profile_init_cellular_profile(profile_info);
+		__profile_init_cellular_profile(&profile_info);
 		break;
 	case CONNECTION_PROFILE_TYPE_WIFI:
-		__profile_init_wifi_profile(profile_info);
+		__profile_init_wifi_profile(&profile_info);
 		break;
 	case CONNECTION_PROFILE_TYPE_ETHERNET:
-		__profile_init_ethernet_profile(profile_info);
+		__profile_init_ethernet_profile(&profile_info);
 		break;
 	}
 
-	*profile = (connection_profile_h)profile_info;
+	*profile = _connection_libnet_new_profile(&profile_info, CONNECTION_MEMORY_PROFILE);
+	if (*profile == NULL)
+		return CONNECTION_ERROR_OUT_OF_MEMORY;
+
 	_connection_libnet_add_to_profile_list(*profile);
 
 	return CONNECTION_ERROR_NONE;
@@ -216,16 +269,37 @@ int connection_profile_clone(connection_profile_h* cloned_profile, connection_pr
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	*cloned_profile = g_try_malloc0(sizeof(net_profile_info_t));
+	/* The contents are copied on the first modification of either profile */
+	*cloned_profile = _connection_libnet_clone_profile(origin_profile, CONNECTION_MEMORY_PROFILE);
 	if (*cloned_profile == NULL)
 		return CONNECTION_ERROR_OUT_OF_MEMORY;
 
-	memcpy(*cloned_profile, origin_profile, sizeof(net_profile_info_t));
 	_connection_libnet_add_to_profile_list(*cloned_profile);
 
 	return CONNECTION_ERROR_NONE;
 }
 
+int connection_profile_ref(connection_profile_h profile)
+{
+	if (profile == NULL || !_connection_libnet_retain_profile(profile)) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int connection_profile_unref(connection_profile_h profile)
+{
+	/* Without a matching connection_profile_ref(), the reference would be a list's or an iterator's */
+	if (profile == NULL || !_connection_libnet_release_profile(profile)) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
+
 int connection_profile_get_name(connection_profile_h profile, char** profile_name)
 {
 	if (!(_connection_libnet_check_profile_validity(profile)) || profile_name == NULL) {
@@ -233,7 +307,8 @@ int connection_profile_get_name(connection_profile_h profile, char** profile_nam
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	*profile_name = g_strdup(profile_info->ProfileName);
 	if (*profile_name == NULL)
@@ -249,7 +324,8 @@ int connection_profile_get_type(connection_profile_h profile, connection_profile
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	switch (profile_info->profile_type) {
 	case NET_DEVICE_CELLULAR:
@@ -276,7 +352,8 @@ int connection_profile_get_network_interface_name(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -288,6 +365,78 @@ int connection_profile_get_network_interface_name(connection_profile_h profile,
 	return CONNECTION_ERROR_NONE;
 }
 
+int connection_profile_bind_socket(connection_profile_h profile, int socket_fd)
+{
+	struct sockaddr_storage address;
+	socklen_t length = sizeof(address);
+	bool is_bound;
+
+	if (!(_connection_libnet_check_profile_validity(profile)) || socket_fd < 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
+	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
+	if (net_info == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	/* The family, and whether the application bound it already */
+	memset(&address, 0, sizeof(address));
+	if (getsockname(socket_fd, (struct sockaddr *)&address, &length) < 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Not a socket : %d\n", socket_fd);
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	if (address.ss_family == AF_INET)
+		is_bound = ((struct sockaddr_in *)&address)->sin_port != 0 ||
+				((struct sockaddr_in *)&address)->sin_addr.s_addr != INADDR_ANY;
+	else
+		is_bound = true;
+
+	return _connection_socket_bind(socket_fd, address.ss_family, is_bound, net_info);
+}
+
+int connection_profile_create_socket(connection_profile_h profile, connection_address_family_e address_family,
+		int type, int protocol, int* socket_fd)
+{
+	int family;
+	int error;
+	int rv;
+
+	if (!(_connection_libnet_check_profile_validity(profile)) || socket_fd == NULL ||
+	    (address_family != CONNECTION_ADDRESS_FAMILY_IPV4 &&
+	     address_family != CONNECTION_ADDRESS_FAMILY_IPV6)) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
+	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
+	if (net_info == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	family = (address_family == CONNECTION_ADDRESS_FAMILY_IPV4) ? AF_INET : AF_INET6;
+
+	*socket_fd = socket(family, type | SOCK_CLOEXEC, protocol);
+	if (*socket_fd < 0) {
+		error = errno;
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot create a socket : %d\n", error);
+		return error == EINVAL || error == EPROTONOSUPPORT ?
+				CONNECTION_ERROR_INVALID_PARAMETER : CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	rv = _connection_socket_bind(*socket_fd, family, false, net_info);
+	if (rv != CONNECTION_ERROR_NONE) {
+		close(*socket_fd);
+		*socket_fd = -1;
+	}
+
+	return rv;
+}
+
 int connection_profile_get_state(connection_profile_h profile, connection_profile_state_e* state)
 {
 	if (!(_connection_libnet_check_profile_validity(profile)) || state == NULL) {
@@ -295,8 +444,9 @@ int connection_profile_get_state(connection_profile_h profile, connection_profil
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
-	*state = __profile_convert_to_cp_state(profile_info->ProfileState);
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
+	*state = _connection_profile_convert_to_cp_state(profile_info->ProfileState);
 	if (*state < 0)
 		return CONNECTION_ERROR_OPERATION_FAILED;
 
@@ -316,7 +466,8 @@ int connection_profile_get_ip_config_type(connection_profile_h profile, connecti
 	if (address_family == CONNECTION_ADDRESS_FAMILY_IPV6)
 		return CONNECTION_ERROR_ADDRESS_FAMILY_NOT_SUPPORTED;
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -355,7 +506,8 @@ int connection_profile_get_ip_address(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -381,7 +533,8 @@ int connection_profile_get_subnet_mask(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -407,7 +560,8 @@ int connection_profile_get_gateway_address(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -435,7 +589,8 @@ int connection_profile_get_dns_address(connection_profile_h profile, int order,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -450,6 +605,24 @@ int connection_profile_get_dns_address(connection_profile_h profile, int order,
 	return CONNECTION_ERROR_NONE;
 }
 
+int connection_profile_get_dns_servers(connection_profile_h profile, connection_dns_servers_s* servers)
+{
+	if (!(_connection_libnet_check_profile_validity(profile)) || servers == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
+	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
+	if (net_info == NULL)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	_connection_profile_get_dns_servers(net_info, servers);
+
+	return CONNECTION_ERROR_NONE;
+}
+
 int connection_profile_get_proxy_type(connection_profile_h profile, connection_proxy_type_e* type)
 {
 	if (!(_connection_libnet_check_profile_validity(profile)) || type == NULL) {
@@ -457,7 +630,8 @@ int connection_profile_get_proxy_type(connection_profile_h profile, connection_p
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -491,7 +665,8 @@ int connection_profile_get_proxy_address(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -515,7 +690,8 @@ int connection_profile_set_ip_config_type(connection_profile_h profile, connecti
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -543,7 +719,8 @@ int connection_profile_set_ip_config_type(connection_profile_h profile, connecti
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&net_info->IpConfigType, sizeof(net_info->IpConfigType));
 }
 
 int connection_profile_set_ip_address(connection_profile_h profile,
@@ -557,7 +734,8 @@ int connection_profile_set_ip_address(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -567,7 +745,8 @@ int connection_profile_set_ip_address(connection_profile_h profile,
 
 	inet_aton(ip_address, &(net_info->IpAddr.Data.Ipv4));
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&net_info->IpAddr, sizeof(net_info->IpAddr));
 }
 
 int connection_profile_set_subnet_mask(connection_profile_h profile,
@@ -581,7 +760,8 @@ int connection_profile_set_subnet_mask(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -591,7 +771,8 @@ int connection_profile_set_subnet_mask(connection_profile_h profile,
 
 	inet_aton(subnet_mask, &(net_info->SubnetMask.Data.Ipv4));
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&net_info->SubnetMask, sizeof(net_info->SubnetMask));
 }
 
 int connection_profile_set_gateway_address(connection_profile_h profile,
@@ -605,7 +786,8 @@ int connection_profile_set_gateway_address(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -615,7 +797,8 @@ int connection_profile_set_gateway_address(connection_profile_h profile,
 
 	inet_aton(gateway_address, &(net_info->GatewayAddr.Data.Ipv4));
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&net_info->GatewayAddr, sizeof(net_info->GatewayAddr));
 }
 
 int connection_profile_set_dns_address(connection_profile_h profile, int order,
@@ -631,7 +814,8 @@ int connection_profile_set_dns_address(connection_profile_h profile, int order,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -641,7 +825,8 @@ int connection_profile_set_dns_address(connection_profile_h profile, int order,
 
 	inet_aton(dns_address, &(net_info->DnsAddr[order-1].Data.Ipv4));
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&net_info->DnsAddr[order-1], sizeof(net_info->DnsAddr[order-1]));
 }
 
 int connection_profile_set_proxy_type(connection_profile_h profile, connection_proxy_type_e type)
@@ -651,7 +836,8 @@ int connection_profile_set_proxy_type(connection_profile_h profile, connection_p
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -670,7 +856,8 @@ int connection_profile_set_proxy_type(connection_profile_h profile, connection_p
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&net_info->ProxyMethod, sizeof(net_info->ProxyMethod));
 }
 
 int connection_profile_set_proxy_address(connection_profile_h profile,
@@ -684,7 +871,8 @@ int connection_profile_set_proxy_address(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	net_dev_info_t *net_info = __profile_get_net_info(profile_info);
 	if (net_info == NULL)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -694,7 +882,8 @@ int connection_profile_set_proxy_address(connection_profile_h profile,
 
 	g_strlcpy(net_info->ProxyAddr, proxy_address, NET_PROXY_LEN_MAX);
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			net_info->ProxyAddr, sizeof(net_info->ProxyAddr));
 }
 
 int connection_profile_set_state_changed_cb(connection_profile_h profile,
@@ -733,7 +922,8 @@ int connection_profile_get_wifi_essid(connection_profile_h profile, char** essid
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -752,7 +942,8 @@ int connection_profile_get_wifi_bssid(connection_profile_h profile, char** bssid
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -771,7 +962,8 @@ int connection_profile_get_wifi_rssi(connection_profile_h profile, int* rssi)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -788,7 +980,8 @@ int connection_profile_get_wifi_frequency(connection_profile_h profile, int* fre
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -805,7 +998,8 @@ int connection_profile_get_wifi_max_speed(connection_profile_h profile, int* max
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -822,7 +1016,8 @@ int connection_profile_get_wifi_security_type(connection_profile_h profile, conn
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -857,7 +1052,8 @@ int connection_profile_get_wifi_encryption_type(connection_profile_h profile, co
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -892,7 +1088,8 @@ int connection_profile_is_wifi_passphrase_required(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -912,7 +1109,8 @@ int connection_profile_set_wifi_passphrase(connection_profile_h profile, const c
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -920,7 +1118,9 @@ int connection_profile_set_wifi_passphrase(connection_profile_h profile, const c
 	g_strlcpy(profile_info->ProfileInfo.Wlan.security_info.authentication.psk.pskKey,
 						passphrase, NETPM_WLAN_MAX_PSK_PASSPHRASE_LEN);
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			profile_info->ProfileInfo.Wlan.security_info.authentication.psk.pskKey,
+			sizeof(profile_info->ProfileInfo.Wlan.security_info.authentication.psk.pskKey));
 }
 
 int connection_profile_is_wifi_wps_supported(connection_profile_h profile, bool* supported)
@@ -930,7 +1130,8 @@ int connection_profile_is_wifi_wps_supported(connection_profile_h profile, bool*
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_WIFI)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -948,32 +1149,24 @@ int connection_profile_is_wifi_wps_supported(connection_profile_h profile, bool*
 
 int connection_profile_get_cellular_network_type(connection_profile_h profile, connection_cellular_network_type_e* type)
 {
+	int network_type;
+
 	if (!(_connection_libnet_check_profile_validity(profile)) || type == NULL) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Wrong Parameter Passed\n");
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 
-	switch (profile_info->ProfileInfo.Pdp.ProtocolType) {
-	case NET_PDP_TYPE_NONE:
-		*type = CONNECTION_CELLULAR_NETWORK_TYPE_UNKNOWN;
-		break;
-	case NET_PDP_TYPE_GPRS:
-		*type = CONNECTION_CELLULAR_NETWORK_TYPE_GPRS;
-		break;
-	case NET_PDP_TYPE_EDGE:
-		*type = CONNECTION_CELLULAR_NETWORK_TYPE_EDGE;
-		break;
-	case NET_PDP_TYPE_UMTS:
-		*type = CONNECTION_CELLULAR_NETWORK_TYPE_UMTS;
-		break;
-	default:
+	network_type = _connection_profile_convert_to_cp_network_type(profile_info->ProfileInfo.Pdp.ProtocolType);
+	if (network_type < 0)
 		return CONNECTION_ERROR_OPERATION_FAILED;
-	}
+
+	*type = network_type;
 
 	return CONNECTION_ERROR_NONE;
 }
@@ -986,7 +1179,8 @@ int connection_profile_get_cellular_service_type(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR) {
 		CONNECTION_LOG(CONNECTION_ERROR, "Invalid profile type Passed\n");
@@ -1010,7 +1204,8 @@ int connection_profile_get_cellular_apn(connection_profile_h profile, char** apn
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -1031,7 +1226,8 @@ int connection_profile_get_cellular_auth_info(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -1070,7 +1266,8 @@ int connection_profile_get_cellular_home_url(connection_profile_h profile, char*
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -1089,7 +1286,8 @@ int connection_profile_is_cellular_roaming(connection_profile_h profile, bool* i
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -1110,7 +1308,8 @@ int connection_profile_set_cellular_service_type(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -1136,7 +1335,9 @@ int connection_profile_set_cellular_service_type(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&profile_info->ProfileInfo.Pdp.ServiceType,
+			sizeof(profile_info->ProfileInfo.Pdp.ServiceType));
 }
 
 int connection_profile_set_cellular_apn(connection_profile_h profile, const char* apn)
@@ -1146,14 +1347,17 @@ int connection_profile_set_cellular_apn(connection_profile_h profile, const char
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 
 	g_strlcpy(profile_info->ProfileInfo.Pdp.Apn, apn, NET_PDP_APN_LEN_MAX+1);
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			profile_info->ProfileInfo.Pdp.Apn,
+			sizeof(profile_info->ProfileInfo.Pdp.Apn));
 }
 
 int connection_profile_set_cellular_auth_info(connection_profile_h profile,
@@ -1165,7 +1369,8 @@ int connection_profile_set_cellular_auth_info(connection_profile_h profile,
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
@@ -1187,7 +1392,9 @@ int connection_profile_set_cellular_auth_info(connection_profile_h profile,
 	g_strlcpy(profile_info->ProfileInfo.Pdp.AuthInfo.UserName, user_name, NET_PDP_AUTH_USERNAME_LEN_MAX+1);
 	g_strlcpy(profile_info->ProfileInfo.Pdp.AuthInfo.Password, password, NET_PDP_AUTH_PASSWORD_LEN_MAX+1);
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			&profile_info->ProfileInfo.Pdp.AuthInfo,
+			sizeof(profile_info->ProfileInfo.Pdp.AuthInfo));
 }
 
 int connection_profile_set_cellular_home_url(connection_profile_h profile, const char* home_url)
@@ -1197,13 +1404,16 @@ int connection_profile_set_cellular_home_url(connection_profile_h profile, const
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (profile_info->profile_type != NET_DEVICE_CELLULAR)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 
 	g_strlcpy(profile_info->ProfileInfo.Pdp.HomeURL, home_url, NET_HOME_URL_LEN_MAX);
 
-	return CONNECTION_ERROR_NONE;
+	return _connection_libnet_modify_profile(profile, profile_info,
+			profile_info->ProfileInfo.Pdp.HomeURL,
+			sizeof(profile_info->ProfileInfo.Pdp.HomeURL));
 }
 
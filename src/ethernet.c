@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <linux/if.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+#define ETHERNET_STATE_UNKNOWN -1
+
+/* Taken after the connection lock and before the netlink lock */
+static pthread_mutex_t ethernet_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile int ethernet_state = ETHERNET_STATE_UNKNOWN;
+/* Bumped on every update, so a slow load cannot overwrite a newer event */
+static unsigned int ethernet_generation = 0;
+static char ethernet_profile_name[NET_PROFILE_NAME_LEN_MAX+1];
+static char ethernet_interface_name[NET_MAX_DEVICE_NAME_LEN+1];
+static GSList *ethernet_callbacks = NULL;
+
+
+static int __ethernet_convert_state(net_state_type_t profile_state)
+{
+	switch (profile_state) {
+	case NET_STATE_TYPE_ONLINE:
+	case NET_STATE_TYPE_READY:
+		return CONNECTION_ETHERNET_STATE_CONNECTED;
+	case NET_STATE_TYPE_IDLE:
+	case NET_STATE_TYPE_FAILURE:
+	case NET_STATE_TYPE_ASSOCIATION:
+	case NET_STATE_TYPE_CONFIGURATION:
+	case NET_STATE_TYPE_DISCONNECT:
+		return CONNECTION_ETHERNET_STATE_DISCONNECTED;
+	default:
+		return ETHERNET_STATE_UNKNOWN;
+	}
+}
+
+static void __ethernet_set_profile(const net_profile_info_t *profile_info)
+{
+	if (profile_info == NULL) {
+		ethernet_profile_name[0] = '\0';
+		return;
+	}
+
+	g_strlcpy(ethernet_profile_name, profile_info->ProfileName, NET_PROFILE_NAME_LEN_MAX+1);
+
+	if (profile_info->ProfileInfo.Ethernet.net_info.DevName[0] != '\0')
+		g_strlcpy(ethernet_interface_name, profile_info->ProfileInfo.Ethernet.net_info.DevName,
+				NET_MAX_DEVICE_NAME_LEN+1);
+}
+
+/* Must be called with the ethernet lock held. Returns the callbacks to notify, if any */
+static GSList *__ethernet_set_state(int state)
+{
+	int previous = ethernet_state;
+
+	ethernet_generation++;
+	g_atomic_int_set(&ethernet_state, state);
+
+	if (previous == state || previous == ETHERNET_STATE_UNKNOWN || state == ETHERNET_STATE_UNKNOWN)
+		return NULL;
+
+	CONNECTION_LOG(CONNECTION_INFO, "Ethernet state %d -> %d\n", previous, state);
+
+	return g_slist_copy(ethernet_callbacks);
+}
+
+static void __ethernet_notify(GSList *callbacks, int state)
+{
+	GSList *list;
+
+	/* Callbacks run without the lock, so they may stop the monitor */
+	for (list = callbacks; list; list = list->next)
+		((connection_ethernet_monitor_cb)list->data)(state);
+
+	g_slist_free(callbacks);
+}
+
+/* Reads the state from the network daemon and stores it, unless an event was faster */
+static int __ethernet_load(int *state, bool notify)
+{
+	net_profile_info_t *profiles = NULL;
+	GSList *callbacks = NULL;
+	unsigned int generation;
+	int count = 0;
+	int rv;
+
+	pthread_mutex_lock(&ethernet_mutex);
+	generation = ethernet_generation;
+	pthread_mutex_unlock(&ethernet_mutex);
+
+	/* Without the events of the daemon, the cached state would not follow */
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	rv = net_get_profile_list(NET_DEVICE_ETHERNET, &profiles, &count);
+	if (rv != NET_ERR_NONE && rv != NET_ERR_NO_SERVICE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	if (count == 0)
+		*state = CONNECTION_ETHERNET_STATE_DEACTIVATED;
+	else
+		*state = __ethernet_convert_state(profiles->ProfileState);
+
+	if (*state == ETHERNET_STATE_UNKNOWN) {
+		g_free(profiles);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	pthread_mutex_lock(&ethernet_mutex);
+
+	if (generation == ethernet_generation) {
+		__ethernet_set_profile(count > 0 ? profiles : NULL);
+		callbacks = __ethernet_set_state(*state);
+	}
+
+	pthread_mutex_unlock(&ethernet_mutex);
+
+	g_free(profiles);
+
+	if (notify)
+		__ethernet_notify(callbacks, *state);
+	else
+		g_slist_free(callbacks);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+static void __ethernet_link_cb(connection_netlink_event_e event, const connection_netlink_interface_s *interface)
+{
+	GSList *callbacks = NULL;
+	bool reload = false;
+
+	if (event != CONNECTION_NETLINK_EVENT_LINK)
+		return;
+
+	pthread_mutex_lock(&ethernet_mutex);
+
+	if (strcmp(interface->name, ethernet_interface_name) != 0) {
+		pthread_mutex_unlock(&ethernet_mutex);
+		return;
+	}
+
+	if (interface->flags & IFF_LOWER_UP) {
+		/* The cable is back: the network daemon decides what comes next */
+		reload = true;
+	} else if (ethernet_state == CONNECTION_ETHERNET_STATE_CONNECTED) {
+		/* No carrier, no connection, whatever the daemon reports later */
+		callbacks = __ethernet_set_state(CONNECTION_ETHERNET_STATE_DISCONNECTED);
+	}
+
+	pthread_mutex_unlock(&ethernet_mutex);
+
+	if (reload) {
+		int state;
+
+		__ethernet_load(&state, true);
+	} else {
+		__ethernet_notify(callbacks, CONNECTION_ETHERNET_STATE_DISCONNECTED);
+	}
+}
+
+int _connection_ethernet_get_state(connection_ethernet_state_e *state)
+{
+	int cached = g_atomic_int_get(&ethernet_state);
+	int rv;
+
+	if (state == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	if (cached != ETHERNET_STATE_UNKNOWN) {
+		*state = cached;
+		return CONNECTION_ERROR_NONE;
+	}
+
+	rv = __ethernet_load(&cached, true);
+	if (rv == CONNECTION_ERROR_NONE)
+		*state = cached;
+
+	return rv;
+}
+
+void _connection_ethernet_update(const char *profile_name, net_profile_info_t *profile_info,
+		connection_profile_state_e state)
+{
+	GSList *callbacks = NULL;
+	int ethernet;
+
+	if (profile_name == NULL || (int)state < 0)
+		return;
+
+	pthread_mutex_lock(&ethernet_mutex);
+
+	if (profile_info && profile_info->profile_type == NET_DEVICE_ETHERNET) {
+		__ethernet_set_profile(profile_info);
+	} else if (ethernet_profile_name[0] == '\0' || strcmp(profile_name, ethernet_profile_name) != 0) {
+		pthread_mutex_unlock(&ethernet_mutex);
+		return;
+	}
+
+	ethernet = (state == CONNECTION_PROFILE_STATE_CONNECTED) ?
+			CONNECTION_ETHERNET_STATE_CONNECTED : CONNECTION_ETHERNET_STATE_DISCONNECTED;
+	callbacks = __ethernet_set_state(ethernet);
+
+	pthread_mutex_unlock(&ethernet_mutex);
+
+	__ethernet_notify(callbacks, ethernet);
+}
+
+void _connection_ethernet_invalidate(void)
+{
+	pthread_mutex_lock(&ethernet_mutex);
+	ethernet_generation++;
+	g_atomic_int_set(&ethernet_state, ETHERNET_STATE_UNKNOWN);
+	ethernet_profile_name[0] = '\0';
+	pthread_mutex_unlock(&ethernet_mutex);
+}
+
+/* Called with the connection lock held, so it notifies nobody */
+int _connection_ethernet_monitor_start(connection_ethernet_monitor_cb callback)
+{
+	bool first;
+	int state;
+	int rv;
+
+	if (callback == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	pthread_mutex_lock(&ethernet_mutex);
+
+	if (g_slist_find(ethernet_callbacks, callback)) {
+		pthread_mutex_unlock(&ethernet_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	first = (ethernet_callbacks == NULL);
+	ethernet_callbacks = g_slist_append(ethernet_callbacks, callback);
+
+	pthread_mutex_unlock(&ethernet_mutex);
+
+	if (!first)
+		return CONNECTION_ERROR_NONE;
+
+	/* Changes are reported from a known state on */
+	if (g_atomic_int_get(&ethernet_state) == ETHERNET_STATE_UNKNOWN)
+		__ethernet_load(&state, false);
+
+	/* Without the carrier events the state still follows the network daemon */
+	rv = _connection_netlink_monitor_start(__ethernet_link_cb);
+	if (rv != CONNECTION_ERROR_NONE)
+		CONNECTION_LOG(CONNECTION_WARN, "Ethernet carrier is not monitored : %d\n", rv);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_ethernet_monitor_stop(connection_ethernet_monitor_cb callback)
+{
+	bool last;
+
+	pthread_mutex_lock(&ethernet_mutex);
+
+	if (g_slist_find(ethernet_callbacks, callback) == NULL) {
+		pthread_mutex_unlock(&ethernet_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	ethernet_callbacks = g_slist_remove(ethernet_callbacks, callback);
+	last = (ethernet_callbacks == NULL);
+
+	pthread_mutex_unlock(&ethernet_mutex);
+
+	if (last)
+		_connection_netlink_monitor_stop(__ethernet_link_cb);
+
+	return CONNECTION_ERROR_NONE;
+}
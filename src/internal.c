@@ -16,38 +16,98 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <sched.h>
 #include <glib.h>
 #include "net_connection_private.h"
 
 
-static pthread_mutex_t connection_mutex;
-static int connection_flag = 0;
+static pthread_mutex_t connection_mutex = PTHREAD_MUTEX_INITIALIZER;
+#ifdef CONNECTION_LOCK_STATS
+static volatile gint64 mutex_acquisitions = 0;
+static volatile gint64 mutex_contentions = 0;
+static volatile gint64 mutex_wait_time = 0;
+#endif
 
 
-static void __inter_mutex_init(void)
+void _connection_inter_mutex_lock(void)
 {
-	if (g_atomic_int_get(&connection_flag) == 0)
-		if (pthread_mutex_init(&connection_mutex, NULL) != 0)
-			CONNECTION_LOG(CONNECTION_ERROR, "Mutex initialization failed!\n");
+#ifdef CONNECTION_LOCK_STATS
+	gint64 start;
+
+	__sync_fetch_and_add(&mutex_acquisitions, 1);
+
+	if (pthread_mutex_trylock(&connection_mutex) == 0)
+		return;
+
+	/* Only a contended acquisition pays for the clock reads */
+	start = g_get_monotonic_time();
+	pthread_mutex_lock(&connection_mutex);
 
-	g_atomic_int_inc(&connection_flag);
+	__sync_fetch_and_add(&mutex_contentions, 1);
+	__sync_fetch_and_add(&mutex_wait_time, g_get_monotonic_time() - start);
+#else
+	pthread_mutex_lock(&connection_mutex);
+#endif
 }
 
-void __inter_mutex_destroy(void)
+void _connection_inter_mutex_unlock(void)
 {
-	if (g_atomic_int_dec_and_test(&connection_flag))
-		pthread_mutex_destroy(&connection_mutex);
+	pthread_mutex_unlock(&connection_mutex);
 }
 
-void _connection_inter_mutex_lock(void)
+void _connection_inter_mutex_get_stats(long long *acquisitions, long long *contentions, long long *wait_time)
 {
-	__inter_mutex_init();
-	pthread_mutex_lock(&connection_mutex);
+#ifdef CONNECTION_LOCK_STATS
+	*acquisitions = __sync_fetch_and_add(&mutex_acquisitions, 0);
+	*contentions = __sync_fetch_and_add(&mutex_contentions, 0);
+	*wait_time = __sync_fetch_and_add(&mutex_wait_time, 0);
+#else
+	*acquisitions = 0;
+	*contentions = 0;
+	*wait_time = 0;
+#endif
 }
 
-void _connection_inter_mutex_unlock(void)
+void _connection_inter_mutex_reset_stats(void)
 {
-	pthread_mutex_unlock(&connection_mutex);
-	__inter_mutex_destroy();
+#ifdef CONNECTION_LOCK_STATS
+	__sync_lock_test_and_set(&mutex_acquisitions, 0);
+	__sync_lock_test_and_set(&mutex_contentions, 0);
+	__sync_lock_test_and_set(&mutex_wait_time, 0);
+#endif
+}
+
+
+void _connection_seqlock_write_begin(volatile int *sequence)
+{
+	g_atomic_int_inc(sequence);
+}
+
+void _connection_seqlock_write_end(volatile int *sequence)
+{
+	g_atomic_int_inc(sequence);
 }
 
+int _connection_seqlock_read_begin(volatile int *sequence)
+{
+	int seq;
+
+	/* An odd sequence means a writer is in the middle of an update */
+	while ((seq = g_atomic_int_get(sequence)) & 1)
+		sched_yield();
+
+	return seq;
+}
+
+/* For a writer that may die in the middle of an update, such as another process */
+bool _connection_seqlock_try_read_begin(volatile int *sequence, int *seq)
+{
+	*seq = g_atomic_int_get(sequence);
+
+	return (*seq & 1) == 0;
+}
+
+bool _connection_seqlock_read_retry(volatile int *sequence, int seq)
+{
+	return g_atomic_int_get(sequence) != seq;
+}
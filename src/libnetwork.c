@@ -16,17 +16,37 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 #include <glib.h>
 #include <vconf/vconf.h>
 #include "net_connection_private.h"
 
 static GSList *prof_handle_list = NULL;
 static GHashTable *profile_cb_table = NULL;
-static bool registered = false;
+static GHashTable *profile_table = NULL;
+/* Set while handles exist. The daemon is only registered with once a feature needs it */
+static volatile int initialized = 0;
+static volatile int registered = 0;
+
+/* Profile contents, shared by clones until one of them is modified */
+struct _profile_data_s {
+	volatile int ref_count;
+	connection_memory_type_e memory_type;
+	net_profile_info_t info;
+};
+
+/* A profile handle is a reference counted block */
+struct _profile_block_s {
+	volatile int ref_count;
+	/* The part of ref_count taken with connection_profile_ref(), under the table lock */
+	int app_ref_count;
+	connection_memory_type_e memory_type;
+	struct _profile_data_s *data;
+};
 
 struct _profile_cb_s {
 	connection_profile_state_changed_cb callback;
-	net_profile_info_t profile;
+	connection_profile_h profile;
 	void *user_data;
 };
 
@@ -36,8 +56,100 @@ struct _profile_list_s {
 	net_profile_info_t *profiles;
 };
 
-static struct _profile_list_s profile_iterator = {0, 0, NULL};
+struct _profile_iterator_s {
+	int count;
+	int next;
+	connection_profile_h *profiles;
+};
+
+static GSList *profile_iterator_list = NULL;
+
+/* Taken after the connection lock, never before: profiles are released with either held.
+ * It also guards the data pointer of the blocks against concurrent clones. */
+static pthread_mutex_t profile_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Taken after the connection lock, never before */
+static pthread_mutex_t register_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Guards the names below. No other lock is taken while it is held */
+static pthread_mutex_t interface_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char interface_names[NET_DEVICE_MAX][NET_MAX_DEVICE_NAME_LEN+1];
+static bool interface_queried[NET_DEVICE_MAX];
+
+
+net_dev_info_t *_connection_libnet_get_net_info(net_profile_info_t *profile_info)
+{
+	switch (profile_info->profile_type) {
+	case NET_DEVICE_CELLULAR:
+		return &profile_info->ProfileInfo.Pdp.net_info;
+	case NET_DEVICE_WIFI:
+		return &profile_info->ProfileInfo.Wlan.net_info;
+	case NET_DEVICE_ETHERNET:
+		return &profile_info->ProfileInfo.Ethernet.net_info;
+	default:
+		return NULL;
+	}
+}
+
+static void __libnet_update_interface_name(net_profile_info_t *profile_info)
+{
+	net_dev_info_t *net_info = _connection_libnet_get_net_info(profile_info);
+
+	if (net_info == NULL || net_info->DevName[0] == '\0')
+		return;
+
+	pthread_mutex_lock(&interface_mutex);
+	g_strlcpy(interface_names[profile_info->profile_type],
+			net_info->DevName, NET_MAX_DEVICE_NAME_LEN+1);
+	pthread_mutex_unlock(&interface_mutex);
+}
+
+static void __libnet_unref_profile_data(struct _profile_data_s *data)
+{
+	if (!g_atomic_int_dec_and_test(&data->ref_count))
+		return;
+
+	_connection_memory_add(data->memory_type, 0, -(long long)sizeof(struct _profile_data_s));
+
+	g_free(data);
+}
+
+/*
+ * Other threads may read the handle: the new data is built aside and swapped in under the
+ * table lock, readers copy it out under the same lock
+ */
+static bool __libnet_publish_profile_info(connection_profile_h profile,
+		net_profile_info_t *profile_info, connection_profile_state_e state)
+{
+	struct _profile_block_s *block = profile;
+	struct _profile_data_s *data;
+	struct _profile_data_s *old;
+
+	data = g_try_malloc(sizeof(struct _profile_data_s));
+	if (data == NULL)
+		return false;
+
+	data->ref_count = 1;
+	data->memory_type = block->memory_type;
 
+	if (profile_info)
+		memcpy(&data->info, profile_info, sizeof(net_profile_info_t));
+
+	pthread_mutex_lock(&profile_table_mutex);
+
+	if (profile_info == NULL) {
+		memcpy(&data->info, &block->data->info, sizeof(net_profile_info_t));
+		data->info.ProfileState = _connection_profile_convert_to_net_state(state);
+	}
+
+	old = block->data;
+	block->data = data;
+
+	pthread_mutex_unlock(&profile_table_mutex);
+
+	_connection_memory_add(data->memory_type, 0, sizeof(struct _profile_data_s));
+	__libnet_unref_profile_data(old);
+
+	return true;
+}
 
 static void __libnet_state_changed_cb(char *profile_name, net_profile_info_t *profile_info,
 				connection_profile_state_e state, bool is_requested)
@@ -45,20 +157,48 @@ static void __libnet_state_changed_cb(char *profile_name, net_profile_info_t *pr
 	if (profile_name == NULL)
 		return;
 
+	_connection_tracker_update(profile_name, profile_info, state);
+	_connection_ethernet_update(profile_name, profile_info, state);
+	_connection_state_page_update_profiles();
+	_connection_snapshot_update_profile();
+
 	struct _profile_cb_s *cb_info;
-	cb_info = g_hash_table_lookup(profile_cb_table, profile_name);
+	connection_profile_state_changed_cb callback = NULL;
+	void *user_data = NULL;
+	connection_profile_h profile;
 
-	if (cb_info == NULL)
+	CONNECTION_MUTEX_LOCK;
+
+	if (profile_cb_table)
+		cb_info = g_hash_table_lookup(profile_cb_table, profile_name);
+	else
+		cb_info = NULL;
+
+	if (cb_info == NULL) {
+		CONNECTION_MUTEX_UNLOCK;
 		return;
+	}
 
-	if (profile_info)
-		memcpy(&cb_info->profile, profile_info, sizeof(net_profile_info_t));
-	else if (state >= 0)
-		cb_info->profile.ProfileState = _connection_profile_convert_to_net_state(state);
+	/* The handle stays the same, its data is replaced */
+	profile = cb_info->profile;
+	if ((profile_info || state >= 0) &&
+	    !__libnet_publish_profile_info(profile, profile_info, state)) {
+		CONNECTION_MUTEX_UNLOCK;
+		return;
+	}
 
-	if (cb_info->callback)
-		cb_info->callback((connection_profile_h)&cb_info->profile,
-							is_requested, cb_info->user_data);
+	callback = cb_info->callback;
+	user_data = cb_info->user_data;
+
+	/* Held for the callback, which may unset itself */
+	_connection_libnet_ref_profile(profile);
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	if (callback)
+		callback(profile, is_requested, user_data);
+
+	_connection_libnet_unref_profile(profile);
 }
 
 static void __libnet_clear_profile_list(struct _profile_list_s *profile_list)
@@ -71,10 +211,113 @@ static void __libnet_clear_profile_list(struct _profile_list_s *profile_list)
 	profile_list->profiles = NULL;
 }
 
+static struct _profile_block_s *__libnet_new_profile_block(struct _profile_data_s *data,
+		connection_memory_type_e memory_type)
+{
+	struct _profile_block_s *block;
+
+	block = g_try_malloc(sizeof(struct _profile_block_s));
+	if (block == NULL)
+		return NULL;
+
+	block->ref_count = 1;
+	block->app_ref_count = 0;
+	block->memory_type = memory_type;
+	block->data = data;
+
+	pthread_mutex_lock(&profile_table_mutex);
+
+	/* Outlives the libnet registration: retained handles stay valid after it */
+	if (profile_table == NULL)
+		profile_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	g_hash_table_insert(profile_table, block, block);
+
+	pthread_mutex_unlock(&profile_table_mutex);
+
+	_connection_memory_add(memory_type, memory_type == CONNECTION_MEMORY_PROFILE ? 1 : 0,
+			sizeof(struct _profile_block_s));
+
+	return block;
+}
+
+static long long __libnet_get_iterator_size(struct _profile_iterator_s *profile_iterator)
+{
+	return sizeof(struct _profile_iterator_s) + sizeof(GSList) +
+			(long long)profile_iterator->count * sizeof(connection_profile_h);
+}
+
+static void __libnet_free_profile_iterator(gpointer data)
+{
+	struct _profile_iterator_s *profile_iterator = data;
+	int i;
+
+	_connection_memory_add(CONNECTION_MEMORY_ITERATOR, -1, -__libnet_get_iterator_size(profile_iterator));
+
+	for (i = 0; i < profile_iterator->count; i++)
+		_connection_libnet_unref_profile(profile_iterator->profiles[i]);
+
+	g_free(profile_iterator->profiles);
+	g_free(profile_iterator);
+}
+
+static void __libnet_free_profile_cb(gpointer data)
+{
+	struct _profile_cb_s *cb_info = data;
+
+	net_profile_info_t profile_copy;
+
+	/* The key is a copy of the profile name */
+	_connection_libnet_read_profile_info(cb_info->profile, &profile_copy);
+	_connection_memory_add(CONNECTION_MEMORY_CALLBACK, -1,
+			-(long long)(sizeof(struct _profile_cb_s) + strlen(profile_copy.ProfileName) + 1));
+
+	_connection_libnet_unref_profile(cb_info->profile);
+	g_free(cb_info);
+}
+
+/* Must be called with the lock held */
+static struct _profile_iterator_s *__libnet_find_profile_iterator(connection_profile_iterator_h profile_iter_h)
+{
+	if (profile_iter_h == NULL || g_slist_find(profile_iterator_list, profile_iter_h) == NULL)
+		return NULL;
+
+	return profile_iter_h;
+}
+
+static bool __libnet_is_connected(net_profile_info_t *profile_info)
+{
+	return profile_info->ProfileState == NET_STATE_TYPE_ONLINE ||
+			profile_info->ProfileState == NET_STATE_TYPE_READY;
+}
+
+static int __libnet_append_profiles(struct _profile_iterator_s *profile_iterator,
+		struct _profile_list_s *profile_list, bool connected_only)
+{
+	int i;
+
+	for (i = 0; i < profile_list->count; i++) {
+		connection_profile_h profile;
+
+		if (connected_only && !__libnet_is_connected(&profile_list->profiles[i]))
+			continue;
+
+		profile = _connection_libnet_new_profile(&profile_list->profiles[i], CONNECTION_MEMORY_ITERATOR);
+		if (profile == NULL)
+			return CONNECTION_ERROR_OUT_OF_MEMORY;
+
+		profile_iterator->profiles[profile_iterator->count++] = profile;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
+
 static void __libnet_evt_cb(net_event_info_t*  event_cb, void* user_data)
 {
 	bool is_requested = false;
 
+	_connection_capture_event(event_cb);
+
 	switch (event_cb->Event) {
 	case NET_EVENT_OPEN_RSP:
 		is_requested = true;
@@ -89,8 +332,19 @@ static void __libnet_evt_cb(net_event_info_t*  event_cb, void* user_data)
 
 			net_profile_info_t *prof_info = NULL;
 
-			if (event_cb->Datalength == sizeof(net_profile_info_t))
+			if (event_cb->Datalength == sizeof(net_profile_info_t)) {
 				prof_info = (net_profile_info_t*)event_cb->Data;
+				__libnet_update_interface_name(prof_info);
+
+				/* The interface may outlive the connection: the last data restarts here */
+				if (event_cb->Error == NET_ERR_NONE) {
+					net_dev_info_t *net_info = _connection_libnet_get_net_info(prof_info);
+
+					if (net_info)
+						_connection_statistics_start_session(prof_info->profile_type,
+								net_info->DevName);
+				}
+			}
 
 			__libnet_state_changed_cb(event_cb->ProfileName, prof_info,
 					CONNECTION_PROFILE_STATE_CONNECTED, is_requested);
@@ -198,6 +452,8 @@ static void __libnet_evt_cb(net_event_info_t*  event_cb, void* user_data)
 	case NET_EVENT_WIFI_SCAN_IND:
 	case NET_EVENT_WIFI_SCAN_RSP:
 		CONNECTION_LOG(CONNECTION_ERROR, "Got wifi scan IND\n");
+		/* A scan adds and removes Wi-Fi profiles */
+		_connection_tracker_refresh();
 		break;
 	case NET_EVENT_WIFI_POWER_IND:
 	case NET_EVENT_WIFI_POWER_RSP:
@@ -217,62 +473,251 @@ int __libnet_get_connected_count(struct _profile_list_s *profile_list)
 	int i = 0;
 
 	for (;i < profile_list->count;i++) {
-		if (profile_list->profiles[i].ProfileState == NET_STATE_TYPE_ONLINE ||
-		    profile_list->profiles[i].ProfileState == NET_STATE_TYPE_READY)
+		if (__libnet_is_connected(&profile_list->profiles[i]))
 			count++;
 	}
 
 	return count;
 }
 
-void __libnet_copy_connected_profile(net_profile_info_t **dest, struct _profile_list_s *source)
+connection_profile_h _connection_libnet_new_profile(const net_profile_info_t *profile_info,
+		connection_memory_type_e memory_type)
 {
-	int i = 0;
+	struct _profile_data_s *data;
+	struct _profile_block_s *block;
+
+	data = g_try_malloc(sizeof(struct _profile_data_s));
+	if (data == NULL)
+		return NULL;
+
+	data->ref_count = 1;
+	data->memory_type = memory_type;
+
+	if (profile_info)
+		memcpy(&data->info, profile_info, sizeof(net_profile_info_t));
+	else
+		memset(&data->info, 0, sizeof(net_profile_info_t));
+
+	block = __libnet_new_profile_block(data, memory_type);
+	if (block == NULL) {
+		g_free(data);
+		return NULL;
+	}
+
+	_connection_memory_add(memory_type, 0, sizeof(struct _profile_data_s));
+
+	return block;
+}
+
+connection_profile_h _connection_libnet_clone_profile(connection_profile_h profile,
+		connection_memory_type_e memory_type)
+{
+	struct _profile_block_s *origin = profile;
+	struct _profile_block_s *block;
+	struct _profile_data_s *data;
+
+	pthread_mutex_lock(&profile_table_mutex);
+	data = origin->data;
+	g_atomic_int_inc(&data->ref_count);
+	pthread_mutex_unlock(&profile_table_mutex);
+
+	block = __libnet_new_profile_block(data, memory_type);
+	if (block == NULL)
+		__libnet_unref_profile_data(data);
+
+	return block;
+}
+
+net_profile_info_t *_connection_libnet_read_profile_info(connection_profile_h profile,
+		net_profile_info_t *profile_info)
+{
+	/* A consistent copy, though the state callback or a setter replaces the data meanwhile */
+	pthread_mutex_lock(&profile_table_mutex);
+	memcpy(profile_info, &((struct _profile_block_s *)profile)->data->info, sizeof(net_profile_info_t));
+	pthread_mutex_unlock(&profile_table_mutex);
+
+	return profile_info;
+}
 
-	for (;i < source->count;i++) {
-		if (source->profiles[i].ProfileState == NET_STATE_TYPE_ONLINE ||
-		    source->profiles[i].ProfileState == NET_STATE_TYPE_READY) {
-			memcpy(*dest, &source->profiles[i], sizeof(net_profile_info_t));
-			(*dest)++;
+int _connection_libnet_modify_profile(connection_profile_h profile,
+		const net_profile_info_t *profile_info, const void *field, size_t size)
+{
+	struct _profile_block_s *block = profile;
+	struct _profile_data_s *data = NULL;
+	struct _profile_data_s *shared = NULL;
+	size_t offset = (const char *)field - (const char *)profile_info;
+
+	/* Under the lock that clones take the reference and readers copy the data with */
+	pthread_mutex_lock(&profile_table_mutex);
+
+	/* First modification of a shared profile: copy it now */
+	if (g_atomic_int_get(&block->data->ref_count) > 1) {
+		data = g_try_malloc(sizeof(struct _profile_data_s));
+		if (data == NULL) {
+			pthread_mutex_unlock(&profile_table_mutex);
+			return CONNECTION_ERROR_OUT_OF_MEMORY;
 		}
+
+		data->ref_count = 1;
+		data->memory_type = block->memory_type;
+		memcpy(&data->info, &block->data->info, sizeof(net_profile_info_t));
+
+		shared = block->data;
+		block->data = data;
 	}
+
+	memcpy((char *)&block->data->info + offset, field, size);
+
+	pthread_mutex_unlock(&profile_table_mutex);
+
+	if (shared) {
+		_connection_memory_add(data->memory_type, 0, sizeof(struct _profile_data_s));
+		__libnet_unref_profile_data(shared);
+	}
+
+	return CONNECTION_ERROR_NONE;
 }
 
-bool _connection_libnet_init(void)
+void _connection_libnet_ref_profile(connection_profile_h profile)
 {
-	int rv;
+	g_atomic_int_inc(&((struct _profile_block_s *)profile)->ref_count);
+}
 
-	if (!registered) {
-		rv = net_register_client_ext((net_event_cb_t)__libnet_evt_cb, NET_DEVICE_DEFAULT, NULL);
-		if (rv != NET_ERR_NONE)
-			return false;
+bool _connection_libnet_retain_profile(connection_profile_h profile)
+{
+	struct _profile_block_s *block = profile;
+	bool valid;
+
+	pthread_mutex_lock(&profile_table_mutex);
+
+	valid = (profile_table && g_hash_table_lookup(profile_table, profile) != NULL);
+	if (valid) {
+		block->app_ref_count++;
+		g_atomic_int_inc(&block->ref_count);
+	}
+
+	pthread_mutex_unlock(&profile_table_mutex);
+
+	return valid;
+}
+
+bool _connection_libnet_release_profile(connection_profile_h profile)
+{
+	struct _profile_block_s *block = profile;
+	bool retained;
+
+	/* Only the references of the application: those of lists, iterators and callbacks are theirs */
+	pthread_mutex_lock(&profile_table_mutex);
+
+	retained = (profile_table && g_hash_table_lookup(profile_table, profile) != NULL &&
+			block->app_ref_count > 0);
+	if (retained)
+		block->app_ref_count--;
+
+	pthread_mutex_unlock(&profile_table_mutex);
+
+	if (retained)
+		_connection_libnet_unref_profile(profile);
+
+	return retained;
+}
+
+void _connection_libnet_unref_profile(connection_profile_h profile)
+{
+	struct _profile_block_s *block = profile;
+
+	if (!g_atomic_int_dec_and_test(&block->ref_count))
+		return;
 
-		registered = true;
+	pthread_mutex_lock(&profile_table_mutex);
+	g_hash_table_remove(profile_table, profile);
+	pthread_mutex_unlock(&profile_table_mutex);
 
+	_connection_memory_add(block->memory_type, block->memory_type == CONNECTION_MEMORY_PROFILE ? -1 : 0,
+			-(long long)sizeof(struct _profile_block_s));
+
+	__libnet_unref_profile_data(block->data);
+	g_free(block);
+}
+
+/* Must be called with the lock held */
+bool _connection_libnet_init(void)
+{
+	if (!initialized) {
 		if (profile_cb_table == NULL)
-			profile_cb_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+			profile_cb_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, __libnet_free_profile_cb);
+
+		g_atomic_int_set(&initialized, 1);
 	}
 
 	return true;
 }
 
+int _connection_libnet_register(void)
+{
+	int rv = CONNECTION_ERROR_NONE;
+
+	if (g_atomic_int_get(&registered))
+		return CONNECTION_ERROR_NONE;
+
+	pthread_mutex_lock(&register_mutex);
+
+	/* The last handle may be gone already */
+	if (!g_atomic_int_get(&initialized)) {
+		rv = CONNECTION_ERROR_INVALID_OPERATION;
+	} else if (!g_atomic_int_get(&registered)) {
+		if (net_register_client_ext((net_event_cb_t)__libnet_evt_cb, NET_DEVICE_DEFAULT, NULL) == NET_ERR_NONE) {
+			CONNECTION_LOG(CONNECTION_INFO, "Registered with the network daemon\n");
+			g_atomic_int_set(&registered, 1);
+		} else {
+			CONNECTION_LOG(CONNECTION_ERROR, "Cannot register with the network daemon\n");
+			rv = CONNECTION_ERROR_OPERATION_FAILED;
+		}
+	}
+
+	pthread_mutex_unlock(&register_mutex);
+
+	return rv;
+}
+
+/* Must be called with the lock held */
 bool _connection_libnet_deinit(void)
 {
-	if (registered) {
-		if (net_deregister_client_ext(NET_DEVICE_DEFAULT) != NET_ERR_NONE)
+	if (initialized) {
+		/* A profile refresh in flight still uses the registration */
+		_connection_warm_start_stop();
+
+		pthread_mutex_lock(&register_mutex);
+
+		if (registered && net_deregister_client_ext(NET_DEVICE_DEFAULT) != NET_ERR_NONE) {
+			pthread_mutex_unlock(&register_mutex);
 			return false;
+		}
+
+		g_atomic_int_set(&registered, 0);
+		g_atomic_int_set(&initialized, 0);
 
-		registered = false;
+		pthread_mutex_unlock(&register_mutex);
 
 		if (profile_cb_table) {
 			g_hash_table_destroy(profile_cb_table);
 			profile_cb_table = NULL;
 		}
 
-		__libnet_clear_profile_list(&profile_iterator);
+		g_slist_free_full(profile_iterator_list, __libnet_free_profile_iterator);
+		profile_iterator_list = NULL;
+		pthread_mutex_lock(&interface_mutex);
+		memset(interface_queried, 0, sizeof(interface_queried));
+		pthread_mutex_unlock(&interface_mutex);
+		_connection_tracker_clear();
+		/* No more events keep it up to date */
+		_connection_ethernet_invalidate();
 
 		if (prof_handle_list) {
-			g_slist_free_full(prof_handle_list, g_free);
+			_connection_memory_add(CONNECTION_MEMORY_PROFILE, 0,
+					-(long long)g_slist_length(prof_handle_list) * sizeof(GSList));
+
+			g_slist_free_full(prof_handle_list, _connection_libnet_unref_profile);
 			prof_handle_list = NULL;
 		}
 	}
@@ -282,219 +727,397 @@ bool _connection_libnet_deinit(void)
 
 bool _connection_libnet_check_profile_validity(connection_profile_h profile)
 {
-	GSList *list;
-	int i = 0;
-
-	for (list = prof_handle_list; list; list = list->next)
-		if (profile == list->data) return true;
-
-	for (;i < profile_iterator.count;i++)
-		if (profile == &profile_iterator.profiles[i]) return true;
+	bool valid;
 
-	struct _profile_cb_s *cb_info;
-	net_profile_info_t *profile_info = profile;
-
-	cb_info = g_hash_table_lookup(profile_cb_table, profile_info->ProfileName);
-	if (cb_info == NULL)
+	if (profile == NULL)
 		return false;
 
-	if (&cb_info->profile == profile)
-		return true;
+	/*
+	 * Every handle the library handed out, and not yet released, is a block of the table:
+	 * those of iterators and state callbacks as well as created and retained ones
+	 */
+	pthread_mutex_lock(&profile_table_mutex);
+	valid = (profile_table && g_hash_table_lookup(profile_table, profile) != NULL);
+	pthread_mutex_unlock(&profile_table_mutex);
 
-	return false;
+	return valid;
 }
 
-bool _connection_libnet_get_ethernet_state(connection_ethernet_state_e* state)
+static int __libnet_new_profile_iterator(struct _profile_list_s profile_lists[], int list_count,
+		bool connected_only, connection_profile_iterator_h* profile_iter_h)
 {
-	struct _profile_list_s ethernet_profiles = {0, 0, NULL};
-	net_get_profile_list(NET_DEVICE_ETHERNET, &ethernet_profiles.profiles, &ethernet_profiles.count);
+	struct _profile_iterator_s *profile_iterator;
+	int rv = CONNECTION_ERROR_NONE;
+	int count = 0;
+	int i;
 
-	if (ethernet_profiles.count == 0) {
-		*state = CONNECTION_ETHERNET_STATE_DEACTIVATED;
-		return true;
+	for (i = 0; i < list_count; i++) {
+		if (connected_only)
+			count += __libnet_get_connected_count(&profile_lists[i]);
+		else
+			count += profile_lists[i].count;
 	}
 
-	switch (ethernet_profiles.profiles->ProfileState) {
-	case NET_STATE_TYPE_ONLINE:
-	case NET_STATE_TYPE_READY:
-		*state = CONNECTION_ETHERNET_STATE_CONNECTED;
-		break;
-	case NET_STATE_TYPE_IDLE:
-	case NET_STATE_TYPE_FAILURE:
-	case NET_STATE_TYPE_ASSOCIATION:
-	case NET_STATE_TYPE_CONFIGURATION:
-	case NET_STATE_TYPE_DISCONNECT:
-		*state = CONNECTION_ETHERNET_STATE_DISCONNECTED;
-		break;
-	default:
-		return false;
+	CONNECTION_LOG(CONNECTION_INFO, "Total %s profile count : %d\n",
+			connected_only ? "connected" : "registered", count);
+
+	/* Every iterator holds its own references, so iterators of different threads do not interfere */
+	profile_iterator = g_try_new0(struct _profile_iterator_s, 1);
+	if (profile_iterator && count > 0) {
+		profile_iterator->profiles = g_try_new0(connection_profile_h, count);
+		if (profile_iterator->profiles == NULL)
+			rv = CONNECTION_ERROR_OUT_OF_MEMORY;
+	} else if (profile_iterator == NULL)
+		rv = CONNECTION_ERROR_OUT_OF_MEMORY;
+
+	for (i = 0; i < list_count && rv == CONNECTION_ERROR_NONE; i++)
+		rv = __libnet_append_profiles(profile_iterator, &profile_lists[i], connected_only);
+
+	if (rv != CONNECTION_ERROR_NONE) {
+		if (profile_iterator) {
+			for (i = 0; i < profile_iterator->count; i++)
+				_connection_libnet_unref_profile(profile_iterator->profiles[i]);
+
+			g_free(profile_iterator->profiles);
+			g_free(profile_iterator);
+		}
+
+		return rv;
 	}
 
-	__libnet_clear_profile_list(&ethernet_profiles);
+	CONNECTION_MUTEX_LOCK;
+	profile_iterator_list = g_slist_prepend(profile_iterator_list, profile_iterator);
+	CONNECTION_MUTEX_UNLOCK;
 
-	return true;
+	_connection_memory_add(CONNECTION_MEMORY_ITERATOR, 1, __libnet_get_iterator_size(profile_iterator));
+
+	*profile_iter_h = profile_iterator;
+
+	return CONNECTION_ERROR_NONE;
 }
 
 int _connection_libnet_get_profile_iterator(connection_iterator_type_e type, connection_profile_iterator_h* profile_iter_h)
 {
-	int count = 0;
-	int rv1, rv2, rv3;
-	net_profile_info_t *profiles = NULL;
-
-	struct _profile_list_s wifi_profiles = {0, 0, NULL};
-	struct _profile_list_s cellular_profiles = {0, 0, NULL};
-	struct _profile_list_s ethernet_profiles = {0, 0, NULL};
+	struct _profile_list_s profile_lists[3] = {{0, 0, NULL}, {0, 0, NULL}, {0, 0, NULL}};
+	net_device_t device_types[3] = {NET_DEVICE_WIFI, NET_DEVICE_CELLULAR, NET_DEVICE_ETHERNET};
+	net_profile_info_t *profiles[3];
+	net_profile_info_t *connected;
+	int connected_count;
+	int counts[3];
+	int rv;
+	int i;
+
+	/* The connected profiles may be published by another process */
+	if (type == CONNECTION_ITERATOR_TYPE_CONNECTED &&
+	    _connection_state_page_get_connected_profiles(&connected, &connected_count) == CONNECTION_ERROR_NONE) {
+		rv = _connection_libnet_new_profile_iterator(type, connected, connected_count, profile_iter_h);
+		g_free(connected);
+		return rv;
+	}
 
-	__libnet_clear_profile_list(&profile_iterator);
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
 
-	rv1 = net_get_profile_list(NET_DEVICE_WIFI, &wifi_profiles.profiles, &wifi_profiles.count);
-	if (rv1 != NET_ERR_NO_SERVICE && rv1 != NET_ERR_NONE)
-		return CONNECTION_ERROR_OPERATION_FAILED;
+	for (i = 0; i < 3; i++) {
+		rv = net_get_profile_list(device_types[i], &profile_lists[i].profiles, &profile_lists[i].count);
+		if (rv != NET_ERR_NO_SERVICE && rv != NET_ERR_NONE) {
+			while (i-- > 0)
+				__libnet_clear_profile_list(&profile_lists[i]);
+			return CONNECTION_ERROR_OPERATION_FAILED;
+		}
 
-	CONNECTION_LOG(CONNECTION_INFO, "Wifi profile count : %d\n", wifi_profiles.count);
+		CONNECTION_LOG(CONNECTION_INFO, "Profile count of device %d : %d\n",
+				device_types[i], profile_lists[i].count);
 
-	rv2 = net_get_profile_list(NET_DEVICE_CELLULAR, &cellular_profiles.profiles, &cellular_profiles.count);
-	if (rv2 != NET_ERR_NO_SERVICE && rv2 != NET_ERR_NONE) {
-		__libnet_clear_profile_list(&wifi_profiles);
-		return CONNECTION_ERROR_OPERATION_FAILED;
+		profiles[i] = profile_lists[i].profiles;
+		counts[i] = profile_lists[i].count;
 	}
-	CONNECTION_LOG(CONNECTION_INFO, "Cellular profile count : %d\n", cellular_profiles.count);
 
-	rv3 = net_get_profile_list(NET_DEVICE_ETHERNET, &ethernet_profiles.profiles, &ethernet_profiles.count);
-	if (rv3 != NET_ERR_NO_SERVICE && rv3 != NET_ERR_NONE) {
-		__libnet_clear_profile_list(&wifi_profiles);
-		__libnet_clear_profile_list(&cellular_profiles);
-		return CONNECTION_ERROR_OPERATION_FAILED;
-	}
-	CONNECTION_LOG(CONNECTION_INFO, "Ethernet profile count : %d\n", ethernet_profiles.count);
+	/* A full enumeration is what the next process start is served with */
+	_connection_warm_start_save(3, profiles, counts);
 
-	*profile_iter_h = &profile_iterator;
+	rv = __libnet_new_profile_iterator(profile_lists, 3,
+			type == CONNECTION_ITERATOR_TYPE_CONNECTED, profile_iter_h);
 
-	switch (type) {
-	case CONNECTION_ITERATOR_TYPE_REGISTERED:
-		count = wifi_profiles.count + cellular_profiles.count + ethernet_profiles.count;
-		CONNECTION_LOG(CONNECTION_INFO, "Total profile count : %d\n", count);
-		if (count == 0)
-			return CONNECTION_ERROR_NONE;
+	for (i = 0; i < 3; i++)
+		__libnet_clear_profile_list(&profile_lists[i]);
 
-		profiles = g_try_new0(net_profile_info_t, count);
-		if (profiles == NULL) {
-			__libnet_clear_profile_list(&wifi_profiles);
-			__libnet_clear_profile_list(&cellular_profiles);
-			__libnet_clear_profile_list(&ethernet_profiles);
-			return CONNECTION_ERROR_OUT_OF_MEMORY;
-		}
+	return rv;
+}
 
-		profile_iterator.profiles = profiles;
+/* Ties go to the profile listed first, so the order is stable */
+static bool __libnet_is_stronger(net_profile_info_t *profile, net_profile_info_t *other)
+{
+	if (profile->ProfileInfo.Wlan.Strength != other->ProfileInfo.Wlan.Strength)
+		return profile->ProfileInfo.Wlan.Strength > other->ProfileInfo.Wlan.Strength;
 
-		if (wifi_profiles.count > 0) {
-			memcpy(profiles, wifi_profiles.profiles,
-					sizeof(net_profile_info_t) * wifi_profiles.count);
-			profiles += wifi_profiles.count;
-		}
+	return profile < other;
+}
 
-		if (cellular_profiles.count > 0) {
-			memcpy(profiles, cellular_profiles.profiles,
-					sizeof(net_profile_info_t) * cellular_profiles.count);
-			profiles += cellular_profiles.count;
-		}
+/* Restores the heap below @a i, the weakest profile being on top */
+static void __libnet_sift_down(net_profile_info_t **heap, int size, int i)
+{
+	net_profile_info_t *swap;
+	int weakest;
 
-		if (ethernet_profiles.count > 0)
-			memcpy(profiles, ethernet_profiles.profiles,
-					sizeof(net_profile_info_t) * ethernet_profiles.count);
+	for (;;) {
+		weakest = i;
 
-		break;
-	case CONNECTION_ITERATOR_TYPE_CONNECTED:
-		count = __libnet_get_connected_count(&wifi_profiles);
-		count += __libnet_get_connected_count(&cellular_profiles);
-		count += __libnet_get_connected_count(&ethernet_profiles);
-		CONNECTION_LOG(CONNECTION_INFO, "Total connected profile count : %d\n", count);
-		if (count == 0)
-			return CONNECTION_ERROR_NONE;
-
-		profiles = g_try_new0(net_profile_info_t, count);
-		if (profiles == NULL) {
-			__libnet_clear_profile_list(&wifi_profiles);
-			__libnet_clear_profile_list(&cellular_profiles);
-			__libnet_clear_profile_list(&ethernet_profiles);
-			return CONNECTION_ERROR_OUT_OF_MEMORY;
-		}
+		if (2 * i + 1 < size && __libnet_is_stronger(heap[weakest], heap[2 * i + 1]))
+			weakest = 2 * i + 1;
+		if (2 * i + 2 < size && __libnet_is_stronger(heap[weakest], heap[2 * i + 2]))
+			weakest = 2 * i + 2;
+
+		if (weakest == i)
+			return;
+
+		swap = heap[i];
+		heap[i] = heap[weakest];
+		heap[weakest] = swap;
+		i = weakest;
+	}
+}
 
-		profile_iterator.profiles = profiles;
+/* Keeps the @a max_count strongest profiles of @a profile_list, from the strongest, in O(n log k) */
+static int __libnet_select_strongest(struct _profile_list_s *profile_list, int max_count,
+		struct _profile_list_s *selected)
+{
+	net_profile_info_t **heap;
+	int size = 0;
+	int i;
 
-		if (wifi_profiles.count > 0)
-			__libnet_copy_connected_profile(&profiles, &wifi_profiles);
+	if (max_count <= 0 || max_count > profile_list->count)
+		max_count = profile_list->count;
 
-		if (cellular_profiles.count > 0)
-			__libnet_copy_connected_profile(&profiles, &cellular_profiles);
+	selected->count = 0;
+	selected->next = 0;
+	selected->profiles = NULL;
 
-		if (ethernet_profiles.count > 0)
-			__libnet_copy_connected_profile(&profiles, &ethernet_profiles);
+	if (max_count == 0)
+		return CONNECTION_ERROR_NONE;
 
-		break;
+	heap = g_try_new(net_profile_info_t *, max_count);
+	selected->profiles = g_try_new(net_profile_info_t, max_count);
+	if (heap == NULL || selected->profiles == NULL) {
+		g_free(heap);
+		g_free(selected->profiles);
+		selected->profiles = NULL;
+		return CONNECTION_ERROR_OUT_OF_MEMORY;
 	}
 
-	__libnet_clear_profile_list(&wifi_profiles);
-	__libnet_clear_profile_list(&cellular_profiles);
-	__libnet_clear_profile_list(&ethernet_profiles);
+	for (i = 0; i < profile_list->count; i++) {
+		net_profile_info_t *profile = &profile_list->profiles[i];
+		int j;
+
+		if (size < max_count) {
+			/* Sift up */
+			for (j = size++; j > 0 && __libnet_is_stronger(heap[(j - 1) / 2], profile); j = (j - 1) / 2)
+				heap[j] = heap[(j - 1) / 2];
+			heap[j] = profile;
+		} else if (__libnet_is_stronger(profile, heap[0])) {
+			heap[0] = profile;
+			__libnet_sift_down(heap, size, 0);
+		}
+	}
 
-	profile_iterator.count = count;
+	/* Popping the weakest first fills the result from its end */
+	selected->count = size;
+	while (size > 0) {
+		memcpy(&selected->profiles[size - 1], heap[0], sizeof(net_profile_info_t));
+		heap[0] = heap[--size];
+		__libnet_sift_down(heap, size, 0);
+	}
+
+	g_free(heap);
 
 	return CONNECTION_ERROR_NONE;
 }
 
+int _connection_libnet_get_wifi_iterator_by_strength(int max_count, connection_profile_iterator_h* profile_iter_h)
+{
+	struct _profile_list_s profile_list = {0, 0, NULL};
+	struct _profile_list_s selected;
+	int rv;
+
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	rv = net_get_profile_list(NET_DEVICE_WIFI, &profile_list.profiles, &profile_list.count);
+	if (rv != NET_ERR_NO_SERVICE && rv != NET_ERR_NONE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	/* Only the selected profiles become handles */
+	rv = __libnet_select_strongest(&profile_list, max_count, &selected);
+	__libnet_clear_profile_list(&profile_list);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	rv = __libnet_new_profile_iterator(&selected, 1, false, profile_iter_h);
+	g_free(selected.profiles);
+
+	return rv;
+}
+
+int _connection_libnet_new_profile_iterator(connection_iterator_type_e type, net_profile_info_t *profiles,
+		int count, connection_profile_iterator_h* profile_iter_h)
+{
+	struct _profile_list_s profile_list = {count, 0, profiles};
+
+	return __libnet_new_profile_iterator(&profile_list, 1,
+			type == CONNECTION_ITERATOR_TYPE_CONNECTED, profile_iter_h);
+}
+
 int _connection_libnet_get_iterator_next(connection_profile_iterator_h profile_iter_h, connection_profile_h *profile)
 {
-	if (profile_iter_h != &profile_iterator)
-		return CONNECTION_ERROR_INVALID_PARAMETER;
+	struct _profile_iterator_s *profile_iterator;
+	int rv = CONNECTION_ERROR_NONE;
 
-	if (profile_iterator.count <= profile_iterator.next)
-		return CONNECTION_ERROR_ITERATOR_END;
+	CONNECTION_MUTEX_LOCK;
 
-	*profile = &profile_iterator.profiles[profile_iterator.next];
-	profile_iterator.next++;
+	profile_iterator = __libnet_find_profile_iterator(profile_iter_h);
+	if (profile_iterator == NULL)
+		rv = CONNECTION_ERROR_INVALID_PARAMETER;
+	else if (profile_iterator->count <= profile_iterator->next)
+		rv = CONNECTION_ERROR_ITERATOR_END;
+	else
+		*profile = profile_iterator->profiles[profile_iterator->next++];
 
-	return CONNECTION_ERROR_NONE;
+	CONNECTION_MUTEX_UNLOCK;
+
+	return rv;
 }
 
 bool _connection_libnet_iterator_has_next(connection_profile_iterator_h profile_iter_h)
 {
-	if (profile_iter_h != &profile_iterator)
-		return false;
+	struct _profile_iterator_s *profile_iterator;
+	bool has_next;
 
-	if (profile_iterator.count <= profile_iterator.next)
-		return false;
+	CONNECTION_MUTEX_LOCK;
 
-	return true;
+	profile_iterator = __libnet_find_profile_iterator(profile_iter_h);
+	has_next = (profile_iterator && profile_iterator->next < profile_iterator->count);
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	return has_next;
 }
 
 int _connection_libnet_destroy_iterator(connection_profile_iterator_h profile_iter_h)
 {
-	if (profile_iter_h != &profile_iterator)
+	struct _profile_iterator_s *profile_iterator;
+
+	CONNECTION_MUTEX_LOCK;
+
+	profile_iterator = __libnet_find_profile_iterator(profile_iter_h);
+	if (profile_iterator == NULL) {
+		CONNECTION_MUTEX_UNLOCK;
 		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	profile_iterator_list = g_slist_remove(profile_iterator_list, profile_iterator);
 
-	__libnet_clear_profile_list(&profile_iterator);
+	CONNECTION_MUTEX_UNLOCK;
+
+	__libnet_free_profile_iterator(profile_iterator);
 
 	return CONNECTION_ERROR_NONE;
 }
 
-int _connection_libnet_get_current_profile(connection_profile_h *profile)
+int _connection_libnet_get_active_profile_info(net_profile_info_t *profile_info)
 {
-	net_profile_info_t active_profile;
 	int rv;
 
-	rv = net_get_active_net_info(&active_profile);
+	/* Another process may publish it already */
+	rv = _connection_state_page_get_current_profile(profile_info);
+	if (rv != CONNECTION_ERROR_INVALID_OPERATION)
+		return rv;
+
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	rv = net_get_active_net_info(profile_info);
 	if (rv == NET_ERR_NO_SERVICE)
 		return CONNECTION_ERROR_NO_CONNECTION;
 	else if (rv != NET_ERR_NONE)
 		return CONNECTION_ERROR_OPERATION_FAILED;
 
-	*profile = g_try_malloc0(sizeof(net_profile_info_t));
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_libnet_get_connected_profiles(net_profile_info_t **profiles, int *count)
+{
+	net_device_t device_types[3] = {NET_DEVICE_WIFI, NET_DEVICE_CELLULAR, NET_DEVICE_ETHERNET};
+	net_profile_info_t *connected = NULL;
+	int connected_count = 0;
+	int rv;
+	int i;
+	int j;
+
+	/* Another process may publish them already */
+	if (_connection_state_page_get_connected_profiles(profiles, count) == CONNECTION_ERROR_NONE)
+		return CONNECTION_ERROR_NONE;
+
+	rv = _connection_libnet_register();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	for (i = 0; i < 3; i++) {
+		struct _profile_list_s profile_list = {0, 0, NULL};
+		net_profile_info_t *grown;
+		int added;
+
+		rv = net_get_profile_list(device_types[i], &profile_list.profiles, &profile_list.count);
+		if (rv != NET_ERR_NO_SERVICE && rv != NET_ERR_NONE) {
+			g_free(connected);
+			return CONNECTION_ERROR_OPERATION_FAILED;
+		}
+
+		added = __libnet_get_connected_count(&profile_list);
+		if (added > 0) {
+			grown = g_try_renew(net_profile_info_t, connected, connected_count + added);
+			if (grown == NULL) {
+				__libnet_clear_profile_list(&profile_list);
+				g_free(connected);
+				return CONNECTION_ERROR_OUT_OF_MEMORY;
+			}
+
+			connected = grown;
+		}
+
+		for (j = 0; j < profile_list.count; j++) {
+			if (__libnet_is_connected(&profile_list.profiles[j]))
+				memcpy(&connected[connected_count++], &profile_list.profiles[j],
+						sizeof(net_profile_info_t));
+		}
+
+		__libnet_clear_profile_list(&profile_list);
+	}
+
+	*profiles = connected;
+	*count = connected_count;
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_libnet_get_current_profile(connection_profile_h *profile)
+{
+	net_profile_info_t active_profile;
+	int rv;
+
+	rv = _connection_libnet_get_active_profile_info(&active_profile);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	__libnet_update_interface_name(&active_profile);
+
+	*profile = _connection_libnet_new_profile(&active_profile, CONNECTION_MEMORY_PROFILE);
 	if (*profile == NULL)
 		return CONNECTION_ERROR_OUT_OF_MEMORY;
 
-	memcpy(*profile, &active_profile, sizeof(net_profile_info_t));
-	prof_handle_list = g_slist_append(prof_handle_list, *profile);
+	_connection_libnet_add_to_profile_list(*profile);
 
 	return CONNECTION_ERROR_NONE;
 }
@@ -506,7 +1129,11 @@ int _connection_libnet_open_profile(connection_profile_h profile)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (net_open_connection_with_profile(profile_info->ProfileName) != NET_ERR_NONE)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -525,18 +1152,20 @@ int _connection_libnet_open_cellular_service_type(connection_cellular_service_ty
 	net_profile_info_t profile_info;
 	net_service_type_t service_type = _connection_profile_convert_to_libnet_cellular_service_type(type);
 
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
 	if (net_open_connection_with_preference_ext(service_type, &profile_name) != NET_ERR_NONE)
 		return CONNECTION_ERROR_OPERATION_FAILED;
 
 	if (net_get_profile_info(profile_name.ProfileName, &profile_info) != NET_ERR_NONE)
 		return CONNECTION_ERROR_OPERATION_FAILED;
 
-	*profile = g_try_malloc0(sizeof(net_profile_info_t));
+	*profile = _connection_libnet_new_profile(&profile_info, CONNECTION_MEMORY_PROFILE);
 	if (*profile == NULL)
 		return CONNECTION_ERROR_OUT_OF_MEMORY;
 
-	memcpy(*profile, &profile_info, sizeof(net_profile_info_t));
-	prof_handle_list = g_slist_append(prof_handle_list, *profile);
+	_connection_libnet_add_to_profile_list(*profile);
 
 	return CONNECTION_ERROR_NONE;
 }
@@ -548,7 +1177,11 @@ int _connection_libnet_close_profile(connection_profile_h profile)
 		return CONNECTION_ERROR_INVALID_PARAMETER;
 	}
 
-	net_profile_info_t *profile_info = profile;
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 
 	if (net_close_connection(profile_info->ProfileName) != NET_ERR_NONE)
 		return CONNECTION_ERROR_OPERATION_FAILED;
@@ -558,19 +1191,41 @@ int _connection_libnet_close_profile(connection_profile_h profile)
 
 void _connection_libnet_add_to_profile_list(connection_profile_h profile)
 {
-	prof_handle_list = g_slist_append(prof_handle_list, profile);
+	CONNECTION_MUTEX_LOCK;
+	prof_handle_list = g_slist_prepend(prof_handle_list, profile);
+	CONNECTION_MUTEX_UNLOCK;
+
+	_connection_memory_add(CONNECTION_MEMORY_PROFILE, 0, sizeof(GSList));
 }
 
 void _connection_libnet_remove_from_profile_list(connection_profile_h profile)
 {
-	prof_handle_list = g_slist_remove(prof_handle_list, profile);
-	g_free(profile);
+	GSList *list;
+
+	CONNECTION_MUTEX_LOCK;
+	list = g_slist_find(prof_handle_list, profile);
+	if (list)
+		prof_handle_list = g_slist_delete_link(prof_handle_list, list);
+	CONNECTION_MUTEX_UNLOCK;
+
+	/* Profiles of iterators and callbacks are released by them */
+	if (list == NULL)
+		return;
+
+	_connection_memory_add(CONNECTION_MEMORY_PROFILE, 0, -(long long)sizeof(GSList));
+
+	_connection_libnet_unref_profile(profile);
 }
 
 bool _connection_libnet_add_to_profile_cb_list(connection_profile_h profile,
 		connection_profile_state_changed_cb callback, void *user_data)
 {
-	net_profile_info_t *profile_info = profile;
+	/* State changes come as events of the daemon */
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE)
+		return false;
+
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
 	char *profile_name = g_strdup(profile_info->ProfileName);
 
 	struct _profile_cb_s *profile_cb_info = g_try_malloc0(sizeof(struct _profile_cb_s));
@@ -579,34 +1234,145 @@ bool _connection_libnet_add_to_profile_cb_list(connection_profile_h profile,
 		return false;
 	}
 
+	/* A clone shares the contents but is not affected by setters on the handle of the application */
+	profile_cb_info->profile = _connection_libnet_clone_profile(profile, CONNECTION_MEMORY_CALLBACK);
+	if (profile_cb_info->profile == NULL) {
+		g_free(profile_name);
+		g_free(profile_cb_info);
+		return false;
+	}
+
 	profile_cb_info->callback = callback;
 	profile_cb_info->user_data = user_data;
-	memcpy(&profile_cb_info->profile, profile_info, sizeof(net_profile_info_t));
+
+	CONNECTION_MUTEX_LOCK;
+
+	if (profile_cb_table == NULL) {
+		CONNECTION_MUTEX_UNLOCK;
+		_connection_libnet_unref_profile(profile_cb_info->profile);
+		g_free(profile_name);
+		g_free(profile_cb_info);
+		return false;
+	}
 
 	g_hash_table_insert(profile_cb_table, profile_name, profile_cb_info);
 
+	CONNECTION_MUTEX_UNLOCK;
+
+	_connection_memory_add(CONNECTION_MEMORY_CALLBACK, 1,
+			sizeof(struct _profile_cb_s) + strlen(profile_name) + 1);
+
 	return true;
 }
 
 void _connection_libnet_remove_from_profile_cb_list(connection_profile_h profile)
 {
-	net_profile_info_t *profile_info = profile;
-	g_hash_table_remove(profile_cb_table, profile_info->ProfileName);
+	net_profile_info_t profile_copy;
+	net_profile_info_t *profile_info = _connection_libnet_read_profile_info(profile, &profile_copy);
+
+	CONNECTION_MUTEX_LOCK;
+	if (profile_cb_table)
+		g_hash_table_remove(profile_cb_table, profile_info->ProfileName);
+	CONNECTION_MUTEX_UNLOCK;
+}
+
+void _connection_libnet_dump_handles(void)
+{
+	GSList *list;
+	GHashTableIter iter;
+	gpointer value;
+	net_profile_info_t profile_copy;
+
+	for (list = prof_handle_list; list; list = list->next) {
+		net_profile_info_t *profile_info = _connection_libnet_read_profile_info(list->data, &profile_copy);
+
+		CONNECTION_LOG(CONNECTION_INFO, "Profile handle %p : %s, type %d, state %d\n",
+				list->data, profile_info->ProfileName,
+				profile_info->profile_type, profile_info->ProfileState);
+	}
+
+	for (list = profile_iterator_list; list; list = list->next) {
+		struct _profile_iterator_s *profile_iterator = list->data;
+
+		CONNECTION_LOG(CONNECTION_INFO, "Profile iterator %p : %d profiles, at %d\n",
+				profile_iterator, profile_iterator->count, profile_iterator->next);
+	}
+
+	if (profile_cb_table == NULL)
+		return;
+
+	g_hash_table_iter_init(&iter, profile_cb_table);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		struct _profile_cb_s *cb_info = value;
+
+		_connection_libnet_read_profile_info(cb_info->profile, &profile_copy);
+		CONNECTION_LOG(CONNECTION_INFO, "Profile callback %p : %s, %d references\n",
+				cb_info->profile, profile_copy.ProfileName,
+				g_atomic_int_get(&((struct _profile_block_s *)cb_info->profile)->ref_count));
+	}
 }
 
 int _connection_libnet_set_statistics(net_device_t device_type, net_statistics_type_e statistics_type)
 {
-	if (net_set_statistics(device_type, statistics_type) != NET_ERR_NONE)
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE ||
+	    net_set_statistics(device_type, statistics_type) != NET_ERR_NONE)
 		return CONNECTION_ERROR_OPERATION_FAILED;
 
 	return CONNECTION_ERROR_NONE;
 }
 
-int _connection_libnet_get_statistics(net_statistics_type_e statistics_type, unsigned long long *size)
+int _connection_libnet_get_statistics(net_device_t device_type, net_statistics_type_e statistics_type, unsigned long long *size)
 {
-	if (net_get_statistics(NET_DEVICE_WIFI, statistics_type, size) != NET_ERR_NONE)
-			return CONNECTION_ERROR_OPERATION_FAILED;
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE ||
+	    net_get_statistics(device_type, statistics_type, size) != NET_ERR_NONE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
 
-		return CONNECTION_ERROR_NONE;
+	return CONNECTION_ERROR_NONE;
 }
 
+bool _connection_libnet_get_interface_name(net_device_t device_type, char *interface_name)
+{
+	struct _profile_list_s profiles = {0, 0, NULL};
+	bool query;
+	bool found;
+	int i = 0;
+
+	if (device_type <= NET_DEVICE_UNKNOWN || device_type >= NET_DEVICE_MAX)
+		return false;
+
+	pthread_mutex_lock(&interface_mutex);
+	query = (interface_names[device_type][0] == '\0' && !interface_queried[device_type]);
+	pthread_mutex_unlock(&interface_mutex);
+
+	/* Ask the daemon only once, open events keep the name up to date afterwards */
+	if (query && _connection_libnet_register() == CONNECTION_ERROR_NONE) {
+		pthread_mutex_lock(&interface_mutex);
+		query = !interface_queried[device_type];
+		interface_queried[device_type] = true;
+		pthread_mutex_unlock(&interface_mutex);
+	} else
+		query = false;
+
+	if (query) {
+		net_get_profile_list(device_type, &profiles.profiles, &profiles.count);
+
+		for (;i < profiles.count;i++) {
+			if (profiles.profiles[i].ProfileState == NET_STATE_TYPE_ONLINE ||
+			    profiles.profiles[i].ProfileState == NET_STATE_TYPE_READY) {
+				__libnet_update_interface_name(&profiles.profiles[i]);
+				break;
+			}
+		}
+
+		__libnet_clear_profile_list(&profiles);
+	}
+
+	/* Copied out under the lock, so an event cannot tear it */
+	pthread_mutex_lock(&interface_mutex);
+	found = (interface_names[device_type][0] != '\0');
+	if (found)
+		g_strlcpy(interface_name, interface_names[device_type], NET_MAX_DEVICE_NAME_LEN+1);
+	pthread_mutex_unlock(&interface_mutex);
+
+	return found;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+static volatile gint64 memory_count[CONNECTION_MEMORY_MAX];
+static volatile gint64 memory_bytes[CONNECTION_MEMORY_MAX];
+static volatile gint64 memory_total = 0;
+static volatile gint64 memory_peak = 0;
+
+
+static void __memory_update_peak(gint64 total)
+{
+	gint64 peak = __sync_fetch_and_add(&memory_peak, 0);
+
+	while (total > peak) {
+		if (__sync_bool_compare_and_swap(&memory_peak, peak, total))
+			break;
+
+		peak = __sync_fetch_and_add(&memory_peak, 0);
+	}
+}
+
+void _connection_memory_add(connection_memory_type_e type, int count, long long bytes)
+{
+	gint64 total;
+
+	if (type < CONNECTION_MEMORY_HANDLE || type >= CONNECTION_MEMORY_MAX)
+		return;
+
+	__sync_fetch_and_add(&memory_count[type], count);
+	__sync_fetch_and_add(&memory_bytes[type], bytes);
+	total = __sync_add_and_fetch(&memory_total, bytes);
+
+	if (bytes > 0)
+		__memory_update_peak(total);
+}
+
+void _connection_memory_get_usage(connection_memory_usage_s *usage)
+{
+	connection_memory_entry_s *entries[CONNECTION_MEMORY_MAX] = {
+		&usage->handles, &usage->profiles, &usage->iterators, &usage->callbacks,
+	};
+	int i;
+
+	for (i = 0; i < CONNECTION_MEMORY_MAX; i++) {
+		entries[i]->count = (int)__sync_fetch_and_add(&memory_count[i], 0);
+		entries[i]->bytes = __sync_fetch_and_add(&memory_bytes[i], 0);
+	}
+
+	usage->total_bytes = __sync_fetch_and_add(&memory_total, 0);
+	usage->peak_bytes = __sync_fetch_and_add(&memory_peak, 0);
+}
+
+void _connection_memory_reset_peak(void)
+{
+	__sync_lock_test_and_set(&memory_peak, __sync_fetch_and_add(&memory_total, 0));
+}
@@ -0,0 +1,651 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+#define NETLINK_BUFFER_SIZE 32768
+#define NETLINK_ADDRESS_IPV4 0
+#define NETLINK_ADDRESS_IPV6 1
+
+typedef void (*netlink_dump_handler)(struct nlmsghdr *nlh, void *user_data);
+
+struct _netlink_interface_s {
+	connection_netlink_interface_s info;
+	GSList *addresses[2];
+};
+
+struct _netlink_event_s {
+	connection_netlink_event_e event;
+	connection_netlink_interface_s info;
+};
+
+static int netlink_sequence = 0;
+
+/* The monitor state. Taken after the connection lock, never before */
+static pthread_mutex_t netlink_mutex = PTHREAD_MUTEX_INITIALIZER;
+static GSList *netlink_callbacks = NULL;
+static GHashTable *netlink_interfaces = NULL;
+static GIOChannel *netlink_channel = NULL;
+static guint netlink_watch = 0;
+
+
+static int __netlink_open(unsigned int groups)
+{
+	struct sockaddr_nl addr;
+	int fd;
+
+	fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+	if (fd < 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot open netlink socket\n");
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(struct sockaddr_nl));
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = groups;
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(struct sockaddr_nl)) < 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot bind netlink socket\n");
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static void __netlink_parse_link(struct nlmsghdr *nlh, connection_netlink_link_s *link)
+{
+	struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+	struct rtattr *rta = IFLA_RTA(ifi);
+	int length = IFLA_PAYLOAD(nlh);
+	bool has_stats64 = false;
+
+	memset(link, 0, sizeof(connection_netlink_link_s));
+	link->ifindex = ifi->ifi_index;
+	link->flags = ifi->ifi_flags;
+
+	for (; RTA_OK(rta, length); rta = RTA_NEXT(rta, length)) {
+		switch (rta->rta_type) {
+		case IFLA_IFNAME:
+			g_strlcpy(link->name, RTA_DATA(rta), NET_MAX_DEVICE_NAME_LEN+1);
+			break;
+		case IFLA_STATS64:
+			if (RTA_PAYLOAD(rta) >= sizeof(struct rtnl_link_stats64)) {
+				struct rtnl_link_stats64 stats;
+
+				/* The attribute is only 4-byte aligned */
+				memcpy(&stats, RTA_DATA(rta), sizeof(struct rtnl_link_stats64));
+				link->counters[CONNECTION_STATISTICS_DIRECTION_RX] = stats.rx_bytes;
+				link->counters[CONNECTION_STATISTICS_DIRECTION_TX] = stats.tx_bytes;
+				link->counters_32bit = false;
+				has_stats64 = true;
+			}
+			break;
+		case IFLA_STATS:
+			if (!has_stats64 && RTA_PAYLOAD(rta) >= sizeof(struct rtnl_link_stats)) {
+				struct rtnl_link_stats *stats = RTA_DATA(rta);
+
+				link->counters[CONNECTION_STATISTICS_DIRECTION_RX] = stats->rx_bytes;
+				link->counters[CONNECTION_STATISTICS_DIRECTION_TX] = stats->tx_bytes;
+				/* Old kernels only report these, which wrap around at 4 GiB */
+				link->counters_32bit = true;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/* Sends a dump request on a fresh socket and passes every reply message to the handler */
+static int __netlink_dump(int type, netlink_dump_handler handler, void *user_data)
+{
+	struct {
+		struct nlmsghdr nlh;
+		union {
+			struct ifinfomsg ifi;
+			struct ifaddrmsg ifa;
+		} body;
+	} request;
+	struct sockaddr_nl addr;
+	char *buffer;
+	bool done = false;
+	int fd;
+	int rv = CONNECTION_ERROR_NONE;
+
+	fd = __netlink_open(0);
+	if (fd < 0)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	memset(&request, 0, sizeof(request));
+	request.nlh.nlmsg_len = NLMSG_LENGTH(type == RTM_GETADDR ?
+			sizeof(struct ifaddrmsg) : sizeof(struct ifinfomsg));
+	request.nlh.nlmsg_type = type;
+	request.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	request.nlh.nlmsg_seq = g_atomic_int_add(&netlink_sequence, 1) + 1;
+	/* Both messages start with the address family */
+	request.body.ifi.ifi_family = AF_UNSPEC;
+
+	memset(&addr, 0, sizeof(struct sockaddr_nl));
+	addr.nl_family = AF_NETLINK;
+
+	if (sendto(fd, &request, request.nlh.nlmsg_len, 0,
+			(struct sockaddr *)&addr, sizeof(struct sockaddr_nl)) < 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot send netlink dump request %d\n", type);
+		close(fd);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	buffer = g_try_malloc(NETLINK_BUFFER_SIZE);
+	if (buffer == NULL) {
+		close(fd);
+		return CONNECTION_ERROR_OUT_OF_MEMORY;
+	}
+
+	while (!done && rv == CONNECTION_ERROR_NONE) {
+		struct nlmsghdr *nlh;
+		ssize_t length = recv(fd, buffer, NETLINK_BUFFER_SIZE, 0);
+
+		if (length <= 0) {
+			rv = CONNECTION_ERROR_OPERATION_FAILED;
+			break;
+		}
+
+		for (nlh = (struct nlmsghdr *)buffer; NLMSG_OK(nlh, length);
+				nlh = NLMSG_NEXT(nlh, length)) {
+			if (nlh->nlmsg_seq != request.nlh.nlmsg_seq)
+				continue;
+
+			if (nlh->nlmsg_type == NLMSG_DONE) {
+				done = true;
+				break;
+			}
+
+			if (nlh->nlmsg_type == NLMSG_ERROR) {
+				CONNECTION_LOG(CONNECTION_ERROR, "Netlink dump %d failed\n", type);
+				rv = CONNECTION_ERROR_OPERATION_FAILED;
+				break;
+			}
+
+			handler(nlh, user_data);
+		}
+	}
+
+	g_free(buffer);
+	close(fd);
+
+	return rv;
+}
+
+static void __netlink_append_link(struct nlmsghdr *nlh, void *user_data)
+{
+	connection_netlink_link_s link;
+
+	if (nlh->nlmsg_type != RTM_NEWLINK)
+		return;
+
+	__netlink_parse_link(nlh, &link);
+	g_array_append_val((GArray *)user_data, link);
+}
+
+int _connection_netlink_dump_links(connection_netlink_link_s **links, int *count)
+{
+	GArray *link_array;
+	int rv;
+
+	if (links == NULL || count == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	link_array = g_array_new(FALSE, FALSE, sizeof(connection_netlink_link_s));
+
+	rv = __netlink_dump(RTM_GETLINK, __netlink_append_link, link_array);
+	if (rv != CONNECTION_ERROR_NONE) {
+		g_array_free(link_array, TRUE);
+		return rv;
+	}
+
+	*count = link_array->len;
+	*links = (connection_netlink_link_s *)g_array_free(link_array, FALSE);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+/* Address and link monitor **********************************************************************/
+
+static void __netlink_free_interface(gpointer data)
+{
+	struct _netlink_interface_s *interface = data;
+
+	g_slist_free_full(interface->addresses[NETLINK_ADDRESS_IPV4], g_free);
+	g_slist_free_full(interface->addresses[NETLINK_ADDRESS_IPV6], g_free);
+	g_free(interface);
+}
+
+static GHashTable *__netlink_new_interface_table(void)
+{
+	return g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, __netlink_free_interface);
+}
+
+static struct _netlink_interface_s *__netlink_get_interface(GHashTable *interfaces, unsigned int ifindex)
+{
+	struct _netlink_interface_s *interface;
+
+	interface = g_hash_table_lookup(interfaces, GUINT_TO_POINTER(ifindex));
+	if (interface)
+		return interface;
+
+	interface = g_new0(struct _netlink_interface_s, 1);
+	interface->info.ifindex = ifindex;
+
+	/* Address messages may come before the link message */
+	if (if_indextoname(ifindex, interface->info.name) == NULL)
+		interface->info.name[0] = '\0';
+
+	g_hash_table_insert(interfaces, GUINT_TO_POINTER(ifindex), interface);
+
+	return interface;
+}
+
+/* The first address of each family is the one reported */
+static void __netlink_update_primary(struct _netlink_interface_s *interface)
+{
+	GSList *ipv4 = interface->addresses[NETLINK_ADDRESS_IPV4];
+	GSList *ipv6 = interface->addresses[NETLINK_ADDRESS_IPV6];
+
+	g_strlcpy(interface->info.ipv4_address, ipv4 ? ipv4->data : "", sizeof(interface->info.ipv4_address));
+	g_strlcpy(interface->info.ipv6_address, ipv6 ? ipv6->data : "", sizeof(interface->info.ipv6_address));
+}
+
+static bool __netlink_parse_address(struct nlmsghdr *nlh, unsigned int *ifindex, int *family, char *address)
+{
+	struct ifaddrmsg *ifa = NLMSG_DATA(nlh);
+	struct rtattr *rta = IFA_RTA(ifa);
+	int length = IFA_PAYLOAD(nlh);
+	void *local = NULL;
+	void *peer = NULL;
+
+	/* Link-local and host addresses do not reach other hosts */
+	if (ifa->ifa_scope >= RT_SCOPE_LINK)
+		return false;
+
+	if (ifa->ifa_family == AF_INET)
+		*family = NETLINK_ADDRESS_IPV4;
+	else if (ifa->ifa_family == AF_INET6)
+		*family = NETLINK_ADDRESS_IPV6;
+	else
+		return false;
+
+	for (; RTA_OK(rta, length); rta = RTA_NEXT(rta, length)) {
+		if (rta->rta_type == IFA_LOCAL)
+			local = RTA_DATA(rta);
+		else if (rta->rta_type == IFA_ADDRESS)
+			peer = RTA_DATA(rta);
+	}
+
+	/* On point-to-point links IFA_ADDRESS is the peer */
+	if (local == NULL)
+		local = peer;
+
+	if (local == NULL || inet_ntop(ifa->ifa_family, local, address, INET6_ADDRSTRLEN) == NULL)
+		return false;
+
+	*ifindex = ifa->ifa_index;
+
+	return true;
+}
+
+/* Applies one message to the table and tells whether the reported state changed */
+static bool __netlink_apply(GHashTable *interfaces, struct nlmsghdr *nlh, struct _netlink_event_s *event)
+{
+	struct _netlink_interface_s *interface;
+	char address[INET6_ADDRSTRLEN];
+	unsigned int ifindex;
+	int family;
+	GSList *found;
+
+	switch (nlh->nlmsg_type) {
+	case RTM_NEWLINK: {
+		connection_netlink_link_s link;
+
+		__netlink_parse_link(nlh, &link);
+		interface = __netlink_get_interface(interfaces, link.ifindex);
+
+		if (interface->info.flags == link.flags && strcmp(interface->info.name, link.name) == 0)
+			return false;
+
+		interface->info.flags = link.flags;
+		g_strlcpy(interface->info.name, link.name, NET_MAX_DEVICE_NAME_LEN+1);
+
+		event->event = CONNECTION_NETLINK_EVENT_LINK;
+		memcpy(&event->info, &interface->info, sizeof(connection_netlink_interface_s));
+		return true;
+	}
+	case RTM_DELLINK: {
+		struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+
+		interface = g_hash_table_lookup(interfaces, GUINT_TO_POINTER(ifi->ifi_index));
+		if (interface == NULL)
+			return false;
+
+		event->event = CONNECTION_NETLINK_EVENT_LINK;
+		memset(&event->info, 0, sizeof(connection_netlink_interface_s));
+		event->info.ifindex = interface->info.ifindex;
+		g_strlcpy(event->info.name, interface->info.name, NET_MAX_DEVICE_NAME_LEN+1);
+
+		g_hash_table_remove(interfaces, GUINT_TO_POINTER(ifi->ifi_index));
+		return true;
+	}
+	case RTM_NEWADDR:
+	case RTM_DELADDR:
+		if (!__netlink_parse_address(nlh, &ifindex, &family, address))
+			return false;
+
+		interface = __netlink_get_interface(interfaces, ifindex);
+		found = g_slist_find_custom(interface->addresses[family], address, (GCompareFunc)g_strcmp0);
+
+		if (nlh->nlmsg_type == RTM_NEWADDR && found == NULL) {
+			interface->addresses[family] = g_slist_append(interface->addresses[family], g_strdup(address));
+		} else if (nlh->nlmsg_type == RTM_DELADDR && found) {
+			g_free(found->data);
+			interface->addresses[family] = g_slist_delete_link(interface->addresses[family], found);
+		} else {
+			return false;
+		}
+
+		memcpy(&event->info, &interface->info, sizeof(connection_netlink_interface_s));
+		__netlink_update_primary(interface);
+
+		/* Secondary addresses come and go without changing what is reported */
+		if (strcmp(event->info.ipv4_address, interface->info.ipv4_address) == 0 &&
+		    strcmp(event->info.ipv6_address, interface->info.ipv6_address) == 0)
+			return false;
+
+		event->event = CONNECTION_NETLINK_EVENT_ADDRESS;
+		memcpy(&event->info, &interface->info, sizeof(connection_netlink_interface_s));
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void __netlink_load_message(struct nlmsghdr *nlh, void *user_data)
+{
+	struct _netlink_event_s event;
+
+	__netlink_apply(user_data, nlh, &event);
+}
+
+static GHashTable *__netlink_load_interfaces(void)
+{
+	GHashTable *interfaces = __netlink_new_interface_table();
+
+	if (__netlink_dump(RTM_GETLINK, __netlink_load_message, interfaces) != CONNECTION_ERROR_NONE ||
+	    __netlink_dump(RTM_GETADDR, __netlink_load_message, interfaces) != CONNECTION_ERROR_NONE) {
+		g_hash_table_destroy(interfaces);
+		return NULL;
+	}
+
+	return interfaces;
+}
+
+/* Must be called with the netlink lock held */
+static void __netlink_resync(GArray *events)
+{
+	GHashTable *interfaces = __netlink_load_interfaces();
+	GHashTableIter iter;
+	gpointer value;
+
+	if (interfaces == NULL)
+		return;
+
+	/* Report what changed while the messages were lost */
+	g_hash_table_iter_init(&iter, interfaces);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		struct _netlink_interface_s *interface = value;
+		struct _netlink_interface_s *previous;
+		struct _netlink_event_s event;
+
+		previous = g_hash_table_lookup(netlink_interfaces, GUINT_TO_POINTER(interface->info.ifindex));
+		memcpy(&event.info, &interface->info, sizeof(connection_netlink_interface_s));
+
+		if (previous == NULL || previous->info.flags != interface->info.flags) {
+			event.event = CONNECTION_NETLINK_EVENT_LINK;
+			g_array_append_val(events, event);
+		}
+
+		if (previous == NULL ||
+		    strcmp(previous->info.ipv4_address, interface->info.ipv4_address) != 0 ||
+		    strcmp(previous->info.ipv6_address, interface->info.ipv6_address) != 0) {
+			event.event = CONNECTION_NETLINK_EVENT_ADDRESS;
+			g_array_append_val(events, event);
+		}
+	}
+
+	g_hash_table_iter_init(&iter, netlink_interfaces);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		struct _netlink_interface_s *previous = value;
+		struct _netlink_event_s event;
+
+		if (g_hash_table_lookup(interfaces, GUINT_TO_POINTER(previous->info.ifindex)))
+			continue;
+
+		event.event = CONNECTION_NETLINK_EVENT_LINK;
+		memset(&event.info, 0, sizeof(connection_netlink_interface_s));
+		event.info.ifindex = previous->info.ifindex;
+		g_strlcpy(event.info.name, previous->info.name, NET_MAX_DEVICE_NAME_LEN+1);
+		g_array_append_val(events, event);
+	}
+
+	g_hash_table_destroy(netlink_interfaces);
+	netlink_interfaces = interfaces;
+}
+
+static gboolean __netlink_monitor_cb(GIOChannel *channel, GIOCondition condition, gpointer user_data)
+{
+	GArray *events = g_array_new(FALSE, FALSE, sizeof(struct _netlink_event_s));
+	GSList *callbacks = NULL;
+	GSList *list;
+	char *buffer;
+	int fd = g_io_channel_unix_get_fd(channel);
+	gboolean keep = TRUE;
+	guint i;
+
+	buffer = g_malloc(NETLINK_BUFFER_SIZE);
+
+	pthread_mutex_lock(&netlink_mutex);
+
+	if (netlink_interfaces == NULL) {
+		/* Stopped meanwhile */
+		pthread_mutex_unlock(&netlink_mutex);
+		g_free(buffer);
+		g_array_free(events, TRUE);
+		return FALSE;
+	}
+
+	while (true) {
+		struct nlmsghdr *nlh;
+		ssize_t length = recv(fd, buffer, NETLINK_BUFFER_SIZE, MSG_DONTWAIT);
+
+		if (length < 0 && errno == ENOBUFS) {
+			/* The kernel dropped messages: read the whole state again */
+			CONNECTION_LOG(CONNECTION_WARN, "Netlink monitor overrun, resynchronizing\n");
+			__netlink_resync(events);
+			continue;
+		}
+
+		if (length <= 0)
+			break;
+
+		for (nlh = (struct nlmsghdr *)buffer; NLMSG_OK(nlh, length);
+				nlh = NLMSG_NEXT(nlh, length)) {
+			struct _netlink_event_s event;
+
+			if (__netlink_apply(netlink_interfaces, nlh, &event))
+				g_array_append_val(events, event);
+		}
+	}
+
+	if (events->len > 0)
+		callbacks = g_slist_copy(netlink_callbacks);
+
+	/* The socket does not recover: keep the last known state, but stop watching it */
+	if (condition & (G_IO_ERR | G_IO_HUP)) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Netlink monitor socket failed, events stopped\n");
+		netlink_watch = 0;
+		keep = FALSE;
+	}
+
+	pthread_mutex_unlock(&netlink_mutex);
+
+	g_free(buffer);
+
+	/* Callbacks run without the lock, so they may stop the monitor */
+	for (i = 0; i < events->len; i++) {
+		struct _netlink_event_s *event = &g_array_index(events, struct _netlink_event_s, i);
+
+		CONNECTION_LOG(CONNECTION_INFO, "Netlink %s event on %s : flags 0x%x, IPv4 [%s], IPv6 [%s]\n",
+				event->event == CONNECTION_NETLINK_EVENT_LINK ? "link" : "address",
+				event->info.name, event->info.flags,
+				event->info.ipv4_address, event->info.ipv6_address);
+
+		for (list = callbacks; list; list = list->next)
+			((connection_netlink_monitor_cb)list->data)(event->event, &event->info);
+	}
+
+	g_slist_free(callbacks);
+	g_array_free(events, TRUE);
+
+	return keep;
+}
+
+int _connection_netlink_monitor_start(connection_netlink_monitor_cb callback)
+{
+	GHashTable *interfaces;
+	int fd;
+
+	if (callback == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	pthread_mutex_lock(&netlink_mutex);
+
+	if (g_slist_find(netlink_callbacks, callback)) {
+		pthread_mutex_unlock(&netlink_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	if (netlink_channel) {
+		netlink_callbacks = g_slist_append(netlink_callbacks, callback);
+		pthread_mutex_unlock(&netlink_mutex);
+		return CONNECTION_ERROR_NONE;
+	}
+
+	/* Subscribe before the dump, so no change falls between the two */
+	fd = __netlink_open(RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR);
+	if (fd < 0) {
+		pthread_mutex_unlock(&netlink_mutex);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	interfaces = __netlink_load_interfaces();
+	if (interfaces == NULL) {
+		close(fd);
+		pthread_mutex_unlock(&netlink_mutex);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	netlink_channel = g_io_channel_unix_new(fd);
+	g_io_channel_set_close_on_unref(netlink_channel, TRUE);
+	netlink_watch = g_io_add_watch(netlink_channel, G_IO_IN | G_IO_ERR | G_IO_HUP,
+			__netlink_monitor_cb, NULL);
+
+	netlink_interfaces = interfaces;
+	netlink_callbacks = g_slist_append(netlink_callbacks, callback);
+
+	pthread_mutex_unlock(&netlink_mutex);
+
+	CONNECTION_LOG(CONNECTION_INFO, "Netlink monitor started, %d interfaces\n",
+			g_hash_table_size(interfaces));
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_netlink_monitor_stop(connection_netlink_monitor_cb callback)
+{
+	pthread_mutex_lock(&netlink_mutex);
+
+	if (g_slist_find(netlink_callbacks, callback) == NULL) {
+		pthread_mutex_unlock(&netlink_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	netlink_callbacks = g_slist_remove(netlink_callbacks, callback);
+
+	if (netlink_callbacks == NULL) {
+		if (netlink_watch)
+			g_source_remove(netlink_watch);
+		netlink_watch = 0;
+		g_io_channel_unref(netlink_channel);
+		netlink_channel = NULL;
+		g_hash_table_destroy(netlink_interfaces);
+		netlink_interfaces = NULL;
+	}
+
+	pthread_mutex_unlock(&netlink_mutex);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+bool _connection_netlink_monitor_get_interface(const char *interface_name,
+		connection_netlink_interface_s *interface)
+{
+	GHashTableIter iter;
+	gpointer value;
+	bool found = false;
+
+	if (interface_name == NULL || interface == NULL)
+		return false;
+
+	pthread_mutex_lock(&netlink_mutex);
+
+	if (netlink_interfaces) {
+		g_hash_table_iter_init(&iter, netlink_interfaces);
+		while (g_hash_table_iter_next(&iter, NULL, &value)) {
+			struct _netlink_interface_s *entry = value;
+
+			if (strcmp(entry->info.name, interface_name) == 0) {
+				memcpy(interface, &entry->info, sizeof(connection_netlink_interface_s));
+				found = true;
+				break;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&netlink_mutex);
+
+	return found;
+}
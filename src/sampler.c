@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+#define SAMPLER_TYPE_MAX 3
+
+struct _sampler_sample_s {
+	gint64 timestamp;
+	unsigned long long rate[CONNECTION_STATISTICS_DIRECTION_MAX];
+};
+
+struct _sampler_ring_s {
+	volatile int sequence;
+	int head;
+	int count;
+	struct _sampler_sample_s samples[CONNECTION_SAMPLER_HISTORY_MAX];
+};
+
+struct _sampler_source_s {
+	net_device_t device_type;
+	bool primed;
+	gint64 timestamp;
+	connection_statistics_counter_s counter;
+	struct _sampler_ring_s ring;
+};
+
+static struct _sampler_source_s sampler_sources[SAMPLER_TYPE_MAX] = {
+	{ .device_type = NET_DEVICE_WIFI },
+	{ .device_type = NET_DEVICE_CELLULAR },
+	{ .device_type = NET_DEVICE_ETHERNET },
+};
+
+/* Serialises the ticks with start and stop. Taken without the connection lock */
+static pthread_mutex_t sampler_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* One requested interval per reference */
+static GSList *sampler_intervals = NULL;
+static int sampler_interval = 0;
+static guint sampler_timer = 0;
+static volatile int sampler_running = 0;
+
+
+static struct _sampler_source_s *__sampler_get_source(net_device_t device_type)
+{
+	int i;
+
+	for (i = 0; i < SAMPLER_TYPE_MAX; i++)
+		if (sampler_sources[i].device_type == device_type)
+			return &sampler_sources[i];
+
+	return NULL;
+}
+
+static void __sampler_push(struct _sampler_ring_s *ring, gint64 timestamp,
+		const unsigned long long rate[])
+{
+	struct _sampler_sample_s *sample;
+
+	_connection_seqlock_write_begin(&ring->sequence);
+
+	ring->head = (ring->head + 1) % CONNECTION_SAMPLER_HISTORY_MAX;
+	if (ring->count < CONNECTION_SAMPLER_HISTORY_MAX)
+		ring->count++;
+
+	sample = &ring->samples[ring->head];
+	sample->timestamp = timestamp;
+	sample->rate[CONNECTION_STATISTICS_DIRECTION_RX] = rate[CONNECTION_STATISTICS_DIRECTION_RX];
+	sample->rate[CONNECTION_STATISTICS_DIRECTION_TX] = rate[CONNECTION_STATISTICS_DIRECTION_TX];
+
+	_connection_seqlock_write_end(&ring->sequence);
+}
+
+static void __sampler_clear(void)
+{
+	int i;
+
+	for (i = 0; i < SAMPLER_TYPE_MAX; i++) {
+		struct _sampler_source_s *source = &sampler_sources[i];
+
+		_connection_seqlock_write_begin(&source->ring.sequence);
+		source->ring.head = 0;
+		source->ring.count = 0;
+		_connection_seqlock_write_end(&source->ring.sequence);
+
+		source->primed = false;
+		memset(&source->counter, 0, sizeof(connection_statistics_counter_s));
+	}
+}
+
+static void __sampler_update_source(struct _sampler_source_s *source, bool available,
+		unsigned int ifindex, const unsigned long long counters[], bool counters_32bit, gint64 now)
+{
+	unsigned long long rate[CONNECTION_STATISTICS_DIRECTION_MAX] = {0, 0};
+	unsigned long long before[CONNECTION_STATISTICS_DIRECTION_MAX];
+	gint64 elapsed = now - source->timestamp;
+	int i;
+
+	if (!available) {
+		/* No link: record an idle sample so the windows keep moving */
+		if (source->primed)
+			__sampler_push(&source->ring, now, rate);
+
+		source->primed = false;
+		source->timestamp = now;
+		return;
+	}
+
+	for (i = 0; i < CONNECTION_STATISTICS_DIRECTION_MAX; i++)
+		before[i] = source->counter.total[i];
+
+	_connection_statistics_accumulate(&source->counter, ifindex, counters, counters_32bit);
+
+	if (source->primed && elapsed > 0) {
+		for (i = 0; i < CONNECTION_STATISTICS_DIRECTION_MAX; i++)
+			rate[i] = (source->counter.total[i] - before[i]) * 8 * G_USEC_PER_SEC / elapsed;
+
+		__sampler_push(&source->ring, now, rate);
+	}
+
+	source->primed = true;
+	source->timestamp = now;
+}
+
+static gboolean __sampler_tick(gpointer user_data)
+{
+	char names[SAMPLER_TYPE_MAX][NET_MAX_DEVICE_NAME_LEN+1];
+	const char *interface_names[SAMPLER_TYPE_MAX];
+	unsigned long long counters[SAMPLER_TYPE_MAX][CONNECTION_STATISTICS_DIRECTION_MAX];
+	bool counters_32bit[SAMPLER_TYPE_MAX];
+	unsigned int ifindex[SAMPLER_TYPE_MAX];
+	connection_statistics_counter_s threshold_counters[SAMPLER_TYPE_MAX];
+	bool thresholds[SAMPLER_TYPE_MAX];
+	gint64 now;
+	int i;
+
+	/* The names are taken under the connection lock, which is never held with the sampler lock */
+	for (i = 0; i < SAMPLER_TYPE_MAX; i++) {
+		interface_names[i] = NULL;
+
+		if (_connection_libnet_get_interface_name(sampler_sources[i].device_type, names[i]))
+			interface_names[i] = names[i];
+	}
+
+	pthread_mutex_lock(&sampler_mutex);
+
+	/* A tick dispatched before the last stop */
+	if (!g_atomic_int_get(&sampler_running)) {
+		pthread_mutex_unlock(&sampler_mutex);
+		return FALSE;
+	}
+
+	now = g_get_monotonic_time();
+
+	/* One read of the kernel counters serves every connection type */
+	if (_connection_statistics_read_links(SAMPLER_TYPE_MAX, interface_names, ifindex,
+			counters, counters_32bit) < 0)
+		memset(ifindex, 0, sizeof(ifindex));
+
+	for (i = 0; i < SAMPLER_TYPE_MAX; i++)
+		__sampler_update_source(&sampler_sources[i], ifindex[i] > 0, ifindex[i],
+				counters[i], counters_32bit[i], now);
+
+	/*
+	 * Thresholds ride on the same read: the statistics engine applies it to the counters it keeps
+	 * in memory, and writes its storage only on its periodic flush
+	 */
+	for (i = 0; i < SAMPLER_TYPE_MAX; i++) {
+		thresholds[i] = false;
+
+		if (!_connection_threshold_is_set(sampler_sources[i].device_type))
+			continue;
+
+		if (_connection_statistics_feed(sampler_sources[i].device_type, interface_names[i],
+				ifindex[i], counters[i], counters_32bit[i], &threshold_counters[i]) == CONNECTION_ERROR_NONE)
+			thresholds[i] = true;
+	}
+
+	pthread_mutex_unlock(&sampler_mutex);
+
+	/* The check takes the connection lock */
+	for (i = 0; i < SAMPLER_TYPE_MAX; i++)
+		if (thresholds[i])
+			_connection_threshold_check(sampler_sources[i].device_type, &threshold_counters[i]);
+
+	return TRUE;
+}
+
+static int __sampler_get_shortest_interval(void)
+{
+	GSList *list;
+	int interval = 0;
+
+	for (list = sampler_intervals; list; list = list->next) {
+		int requested = GPOINTER_TO_INT(list->data);
+
+		if (interval == 0 || requested < interval)
+			interval = requested;
+	}
+
+	return interval;
+}
+
+static bool __sampler_arm(int interval)
+{
+	guint timer;
+
+	if (interval == sampler_interval)
+		return true;
+
+	timer = g_timeout_add(interval, __sampler_tick, NULL);
+	if (timer == 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Failed to add sampler timer\n");
+		return false;
+	}
+
+	if (sampler_timer)
+		g_source_remove(sampler_timer);
+
+	sampler_timer = timer;
+	sampler_interval = interval;
+
+	CONNECTION_LOG(CONNECTION_INFO, "Sampler interval %d ms, references %d\n",
+			sampler_interval, g_slist_length(sampler_intervals));
+
+	return true;
+}
+
+int _connection_sampler_start(int interval)
+{
+	bool first;
+
+	if (interval < CONNECTION_SAMPLER_INTERVAL_MIN)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	pthread_mutex_lock(&sampler_mutex);
+
+	first = (sampler_intervals == NULL);
+	sampler_intervals = g_slist_prepend(sampler_intervals, GINT_TO_POINTER(interval));
+
+	if (!__sampler_arm(__sampler_get_shortest_interval())) {
+		sampler_intervals = g_slist_delete_link(sampler_intervals, sampler_intervals);
+		pthread_mutex_unlock(&sampler_mutex);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	g_atomic_int_set(&sampler_running, 1);
+
+	pthread_mutex_unlock(&sampler_mutex);
+
+	/* Primes the counters, so the first timer tick already has a rate */
+	if (first)
+		__sampler_tick(NULL);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_sampler_stop(int interval)
+{
+	GSList *list;
+
+	pthread_mutex_lock(&sampler_mutex);
+
+	if (sampler_intervals == NULL) {
+		pthread_mutex_unlock(&sampler_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	list = g_slist_find(sampler_intervals, GINT_TO_POINTER(interval));
+	if (list == NULL) {
+		pthread_mutex_unlock(&sampler_mutex);
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	sampler_intervals = g_slist_delete_link(sampler_intervals, list);
+
+	if (sampler_intervals) {
+		/* The remaining users keep the timer they had if it cannot be re-armed */
+		__sampler_arm(__sampler_get_shortest_interval());
+		pthread_mutex_unlock(&sampler_mutex);
+		return CONNECTION_ERROR_NONE;
+	}
+
+	g_source_remove(sampler_timer);
+	sampler_timer = 0;
+	sampler_interval = 0;
+	g_atomic_int_set(&sampler_running, 0);
+
+	__sampler_clear();
+
+	pthread_mutex_unlock(&sampler_mutex);
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_sampler_get_rate(net_device_t device_type, int window, connection_statistics_rate_s *rate)
+{
+	struct _sampler_source_s *source = __sampler_get_source(device_type);
+	struct _sampler_ring_s *ring;
+	unsigned long long sum[CONNECTION_STATISTICS_DIRECTION_MAX];
+	unsigned long long peak[CONNECTION_STATISTICS_DIRECTION_MAX];
+	unsigned long long current[CONNECTION_STATISTICS_DIRECTION_MAX];
+	int samples;
+	int seq;
+	int i, j;
+
+	if (source == NULL || window <= 0 || rate == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	if (!g_atomic_int_get(&sampler_running))
+		return CONNECTION_ERROR_INVALID_OPERATION;
+
+	ring = &source->ring;
+
+	/* Lock-free read: retry if the sampler pushed a sample meanwhile */
+	do {
+		seq = _connection_seqlock_read_begin(&ring->sequence);
+
+		memset(sum, 0, sizeof(sum));
+		memset(peak, 0, sizeof(peak));
+		memset(current, 0, sizeof(current));
+		samples = 0;
+
+		if (ring->count > 0) {
+			struct _sampler_sample_s *latest = &ring->samples[ring->head];
+			gint64 oldest = latest->timestamp - (gint64)window * G_USEC_PER_SEC;
+
+			current[CONNECTION_STATISTICS_DIRECTION_RX] = latest->rate[CONNECTION_STATISTICS_DIRECTION_RX];
+			current[CONNECTION_STATISTICS_DIRECTION_TX] = latest->rate[CONNECTION_STATISTICS_DIRECTION_TX];
+
+			for (i = 0; i < ring->count && i < CONNECTION_SAMPLER_HISTORY_MAX; i++) {
+				int index = (ring->head - i + CONNECTION_SAMPLER_HISTORY_MAX) %
+						CONNECTION_SAMPLER_HISTORY_MAX;
+				struct _sampler_sample_s *sample = &ring->samples[index];
+
+				if (sample->timestamp <= oldest)
+					break;
+
+				for (j = 0; j < CONNECTION_STATISTICS_DIRECTION_MAX; j++) {
+					sum[j] += sample->rate[j];
+					if (sample->rate[j] > peak[j])
+						peak[j] = sample->rate[j];
+				}
+
+				samples++;
+			}
+		}
+	} while (_connection_seqlock_read_retry(&ring->sequence, seq));
+
+	rate->current_received = (long long)current[CONNECTION_STATISTICS_DIRECTION_RX];
+	rate->current_sent = (long long)current[CONNECTION_STATISTICS_DIRECTION_TX];
+	rate->peak_received = (long long)peak[CONNECTION_STATISTICS_DIRECTION_RX];
+	rate->peak_sent = (long long)peak[CONNECTION_STATISTICS_DIRECTION_TX];
+
+	if (samples > 0) {
+		rate->average_received = (long long)(sum[CONNECTION_STATISTICS_DIRECTION_RX] / samples);
+		rate->average_sent = (long long)(sum[CONNECTION_STATISTICS_DIRECTION_TX] / samples);
+	} else {
+		rate->average_received = 0;
+		rate->average_sent = 0;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+
+static bool __selection_get_score_info(net_profile_info_t *profile_info, connection_profile_score_info_s *info)
+{
+	int network_type;
+
+	memset(info, 0, sizeof(connection_profile_score_info_s));
+
+	info->profile_name = profile_info->ProfileName;
+	info->state = _connection_profile_convert_to_cp_state(profile_info->ProfileState);
+	info->cellular_network_type = CONNECTION_CELLULAR_NETWORK_TYPE_UNKNOWN;
+
+	switch (profile_info->profile_type) {
+	case NET_DEVICE_CELLULAR:
+		info->type = CONNECTION_PROFILE_TYPE_CELLULAR;
+		network_type = _connection_profile_convert_to_cp_network_type(
+				profile_info->ProfileInfo.Pdp.ProtocolType);
+		if (network_type >= 0)
+			info->cellular_network_type = network_type;
+		info->is_roaming = profile_info->ProfileInfo.Pdp.Roaming ? true : false;
+		break;
+	case NET_DEVICE_WIFI:
+		info->type = CONNECTION_PROFILE_TYPE_WIFI;
+		info->rssi = (int)profile_info->ProfileInfo.Wlan.Strength;
+		info->frequency = (int)profile_info->ProfileInfo.Wlan.frequency;
+		info->max_speed = (int)profile_info->ProfileInfo.Wlan.max_rate;
+		break;
+	case NET_DEVICE_ETHERNET:
+		info->type = CONNECTION_PROFILE_TYPE_ETHERNET;
+		break;
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+/* Ethernet, then Wi-Fi by RSSI, then cellular by network type, with roaming cellular last */
+static int __selection_default_score(const connection_profile_score_info_s *info, void *user_data)
+{
+	switch (info->type) {
+	case CONNECTION_PROFILE_TYPE_ETHERNET:
+		return 3000;
+	case CONNECTION_PROFILE_TYPE_WIFI:
+		return 2000 + info->rssi;
+	case CONNECTION_PROFILE_TYPE_CELLULAR:
+		return (info->is_roaming ? 0 : 1000) + info->cellular_network_type;
+	default:
+		return -1;
+	}
+}
+
+int _connection_selection_get_best_profile(connection_profile_score_cb score_cb, void *user_data,
+		connection_profile_h *profile)
+{
+	net_profile_info_t *profiles = NULL;
+	connection_profile_score_info_s info;
+	int best = -1;
+	int best_score = -1;
+	int count = 0;
+	int score;
+	int rv;
+	int i;
+
+	if (score_cb == NULL)
+		score_cb = __selection_default_score;
+
+	rv = _connection_libnet_get_connected_profiles(&profiles, &count);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	/* Ranked on the profile information as it came, only the winner becomes a handle */
+	for (i = 0; i < count; i++) {
+		if (!__selection_get_score_info(&profiles[i], &info))
+			continue;
+
+		score = score_cb(&info, user_data);
+		if (score > best_score) {
+			best = i;
+			best_score = score;
+		}
+	}
+
+	if (best < 0) {
+		g_free(profiles);
+		return CONNECTION_ERROR_NO_CONNECTION;
+	}
+
+	CONNECTION_LOG(CONNECTION_INFO, "Best of %d connected profiles : %s, score %d\n",
+			count, profiles[best].ProfileName, best_score);
+
+	*profile = _connection_libnet_new_profile(&profiles[best], CONNECTION_MEMORY_PROFILE);
+	g_free(profiles);
+
+	if (*profile == NULL)
+		return CONNECTION_ERROR_OUT_OF_MEMORY;
+
+	_connection_libnet_add_to_profile_list(*profile);
+
+	return CONNECTION_ERROR_NONE;
+}
@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <glib.h>
+#include <vconf/vconf.h>
+#include "net_connection_private.h"
+
+static const char *snapshot_keys[] = {
+	VCONFKEY_NETWORK_STATUS,
+	VCONFKEY_NETWORK_IP,
+	VCONFKEY_NETWORK_PROXY,
+	VCONFKEY_NETWORK_WIFI_STATE,
+	VCONFKEY_NETWORK_CELLULAR_STATE,
+};
+
+/* Taken after the connection lock and before the ethernet lock. Writers hold it, readers do not */
+static pthread_mutex_t snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile int snapshot_sequence = 0;
+/* Set once the first reader loaded the snapshot, until the last handle is destroyed */
+static volatile int snapshot_valid = 0;
+/* Set while a handle is alive, so that a destroyed handle does not load it again */
+static int snapshot_open = 0;
+static connection_snapshot_state_s snapshot;
+static guint snapshot_refresh_source = 0;
+/* The proxy method of the current profile, which gives the type of the proxy */
+static net_proxy_type_t snapshot_proxy_method = NET_PROXY_TYPE_UNKNOWN;
+static GSList *snapshot_dns_callbacks = NULL;
+
+
+/* Must be called with the snapshot lock held, within a write */
+static void __snapshot_parse_proxy(void)
+{
+	connection_proxy_endpoint_s *proxy = &snapshot.proxy;
+	const char *host = snapshot.facts.proxy_address;
+	const char *end;
+	const char *port = NULL;
+	char *port_end;
+	long number;
+
+	memset(proxy, 0, sizeof(connection_proxy_endpoint_s));
+
+	if (host[0] == '\0') {
+		proxy->type = CONNECTION_PROXY_TYPE_DIRECT;
+		return;
+	}
+
+	proxy->type = snapshot_proxy_method == NET_PROXY_TYPE_AUTO ?
+			CONNECTION_PROXY_TYPE_AUTO : CONNECTION_PROXY_TYPE_MANUAL;
+
+	/* [scheme://]host[:port][/path], where the host may be a bracketed IPv6 address */
+	if (strstr(host, "://"))
+		host = strstr(host, "://") + 3;
+
+	if (host[0] == '[') {
+		end = strchr(++host, ']');
+		if (end == NULL)
+			return;
+		if (end[1] == ':')
+			port = end + 2;
+	} else {
+		end = host + strcspn(host, ":/");
+		if (end[0] == ':')
+			port = end + 1;
+	}
+
+	g_strlcpy(proxy->host, host, MIN(end - host + 1, sizeof(proxy->host)));
+
+	if (port == NULL)
+		return;
+
+	number = strtol(port, &port_end, 10);
+	if (port_end != port && (*port_end == '\0' || *port_end == '/') && number > 0 && number <= 65535)
+		proxy->port = number;
+}
+
+/* Must be called with the snapshot lock held, within a write */
+static void __snapshot_set_profile(net_profile_info_t *profile_info)
+{
+	net_dev_info_t *net_info;
+
+	snapshot.has_profile = false;
+	snapshot.profile_name[0] = '\0';
+	snapshot.interface_name[0] = '\0';
+	memset(&snapshot.dns_servers, 0, sizeof(connection_dns_servers_s));
+	snapshot_proxy_method = NET_PROXY_TYPE_UNKNOWN;
+
+	if (profile_info == NULL)
+		return;
+
+	switch (profile_info->profile_type) {
+	case NET_DEVICE_CELLULAR:
+		snapshot.profile_type = CONNECTION_PROFILE_TYPE_CELLULAR;
+		break;
+	case NET_DEVICE_WIFI:
+		snapshot.profile_type = CONNECTION_PROFILE_TYPE_WIFI;
+		break;
+	case NET_DEVICE_ETHERNET:
+		snapshot.profile_type = CONNECTION_PROFILE_TYPE_ETHERNET;
+		break;
+	default:
+		return;
+	}
+
+	snapshot.has_profile = true;
+	snapshot.profile_state = _connection_profile_convert_to_cp_state(profile_info->ProfileState);
+	g_strlcpy(snapshot.profile_name, profile_info->ProfileName, sizeof(snapshot.profile_name));
+
+	net_info = _connection_libnet_get_net_info(profile_info);
+	if (net_info) {
+		g_strlcpy(snapshot.interface_name, net_info->DevName, sizeof(snapshot.interface_name));
+		snapshot_proxy_method = net_info->ProxyMethod;
+		_connection_profile_get_dns_servers(net_info, &snapshot.dns_servers);
+	}
+}
+
+static void __snapshot_key_changed_cb(keynode_t *node, void *user_data)
+{
+	const char *key = vconf_keynode_get_name(node);
+	char *str;
+
+	pthread_mutex_lock(&snapshot_mutex);
+
+	if (!g_atomic_int_get(&snapshot_valid)) {
+		pthread_mutex_unlock(&snapshot_mutex);
+		return;
+	}
+
+	_connection_seqlock_write_begin(&snapshot_sequence);
+
+	/* The node carries the new value: no need to read the key again */
+	if (g_strcmp0(key, VCONFKEY_NETWORK_STATUS) == 0) {
+		snapshot.facts.network_status = vconf_keynode_get_int(node);
+	} else if (g_strcmp0(key, VCONFKEY_NETWORK_WIFI_STATE) == 0) {
+		snapshot.facts.wifi_state = vconf_keynode_get_int(node);
+	} else if (g_strcmp0(key, VCONFKEY_NETWORK_CELLULAR_STATE) == 0) {
+		snapshot.facts.cellular_state = vconf_keynode_get_int(node);
+	} else if (g_strcmp0(key, VCONFKEY_NETWORK_IP) == 0) {
+		str = vconf_keynode_get_str(node);
+		g_strlcpy(snapshot.facts.ip_address, str ? str : "", sizeof(snapshot.facts.ip_address));
+	} else if (g_strcmp0(key, VCONFKEY_NETWORK_PROXY) == 0) {
+		str = vconf_keynode_get_str(node);
+		g_strlcpy(snapshot.facts.proxy_address, str ? str : "", sizeof(snapshot.facts.proxy_address));
+		__snapshot_parse_proxy();
+	}
+
+	snapshot.version++;
+	_connection_seqlock_write_end(&snapshot_sequence);
+
+	pthread_mutex_unlock(&snapshot_mutex);
+}
+
+static void __snapshot_ethernet_changed_cb(connection_ethernet_state_e state)
+{
+	pthread_mutex_lock(&snapshot_mutex);
+
+	if (g_atomic_int_get(&snapshot_valid)) {
+		_connection_seqlock_write_begin(&snapshot_sequence);
+		snapshot.ethernet_state = state;
+		snapshot.version++;
+		_connection_seqlock_write_end(&snapshot_sequence);
+	}
+
+	pthread_mutex_unlock(&snapshot_mutex);
+}
+
+static gboolean __snapshot_refresh(gpointer user_data)
+{
+	net_profile_info_t *profile_info = g_try_new0(net_profile_info_t, 1);
+	connection_dns_servers_s dns_servers;
+	GSList *callbacks = NULL;
+	GSList *list;
+	int rv;
+
+	pthread_mutex_lock(&snapshot_mutex);
+
+	snapshot_refresh_source = 0;
+
+	if (g_atomic_int_get(&snapshot_valid) && profile_info) {
+		rv = _connection_libnet_get_active_profile_info(profile_info);
+
+		/* On failure the snapshot keeps the profile, the next event retries */
+		if (rv == CONNECTION_ERROR_NONE || rv == CONNECTION_ERROR_NO_CONNECTION) {
+			memcpy(&dns_servers, &snapshot.dns_servers, sizeof(connection_dns_servers_s));
+
+			_connection_seqlock_write_begin(&snapshot_sequence);
+			__snapshot_set_profile(rv == CONNECTION_ERROR_NONE ? profile_info : NULL);
+			__snapshot_parse_proxy();
+			snapshot.version++;
+			_connection_seqlock_write_end(&snapshot_sequence);
+
+			if (memcmp(&dns_servers, &snapshot.dns_servers, sizeof(connection_dns_servers_s)) != 0) {
+				memcpy(&dns_servers, &snapshot.dns_servers, sizeof(connection_dns_servers_s));
+				callbacks = g_slist_copy(snapshot_dns_callbacks);
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&snapshot_mutex);
+
+	g_free(profile_info);
+
+	/* Callbacks run without the lock, so they may stop watching */
+	for (list = callbacks; list; list = list->next)
+		((connection_snapshot_dns_cb)list->data)(&dns_servers);
+
+	g_slist_free(callbacks);
+
+	return FALSE;
+}
+
+/* Must be called with the snapshot lock held */
+static void __snapshot_unwatch(int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		vconf_ignore_key_changed(snapshot_keys[i], __snapshot_key_changed_cb);
+}
+
+/* Must be called with the snapshot lock held */
+static int __snapshot_start(void)
+{
+	connection_state_facts_s facts;
+	connection_ethernet_state_e ethernet_state;
+	net_profile_info_t *profile_info;
+	int rv;
+	int i;
+
+	/* Watched before loading: a change in between waits for the lock, then applies */
+	for (i = 0; i < G_N_ELEMENTS(snapshot_keys); i++) {
+		if (vconf_notify_key_changed(snapshot_keys[i], __snapshot_key_changed_cb, NULL)) {
+			__snapshot_unwatch(i);
+			return CONNECTION_ERROR_OPERATION_FAILED;
+		}
+	}
+
+	if (_connection_ethernet_monitor_start(__snapshot_ethernet_changed_cb) != CONNECTION_ERROR_NONE) {
+		__snapshot_unwatch(G_N_ELEMENTS(snapshot_keys));
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	profile_info = g_try_new0(net_profile_info_t, 1);
+	if (profile_info == NULL)
+		rv = CONNECTION_ERROR_OUT_OF_MEMORY;
+	else
+		rv = _connection_libnet_get_active_profile_info(profile_info);
+
+	if (rv != CONNECTION_ERROR_NONE && rv != CONNECTION_ERROR_NO_CONNECTION) {
+		_connection_ethernet_monitor_stop(__snapshot_ethernet_changed_cb);
+		__snapshot_unwatch(G_N_ELEMENTS(snapshot_keys));
+		g_free(profile_info);
+		return rv;
+	}
+
+	if (!_connection_state_page_get_facts(&facts))
+		_connection_state_page_load_facts(&facts);
+
+	if (_connection_ethernet_get_state(&ethernet_state) != CONNECTION_ERROR_NONE)
+		ethernet_state = CONNECTION_ETHERNET_STATE_DEACTIVATED;
+
+	_connection_seqlock_write_begin(&snapshot_sequence);
+	memcpy(&snapshot.facts, &facts, sizeof(connection_state_facts_s));
+	snapshot.ethernet_state = ethernet_state;
+	__snapshot_set_profile(rv == CONNECTION_ERROR_NONE ? profile_info : NULL);
+	__snapshot_parse_proxy();
+	snapshot.version++;
+	_connection_seqlock_write_end(&snapshot_sequence);
+
+	g_free(profile_info);
+
+	g_atomic_int_set(&snapshot_valid, 1);
+
+	CONNECTION_LOG(CONNECTION_INFO, "Snapshot loaded, version %u\n", snapshot.version);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+static int __snapshot_load(void)
+{
+	int rv = CONNECTION_ERROR_NONE;
+
+	/* Only the first call loads it, with the lock and the daemon */
+	if (!g_atomic_int_get(&snapshot_valid)) {
+		pthread_mutex_lock(&snapshot_mutex);
+		if (g_atomic_int_get(&snapshot_valid))
+			rv = CONNECTION_ERROR_NONE;
+		else if (!snapshot_open)
+			rv = CONNECTION_ERROR_INVALID_PARAMETER;
+		else
+			rv = __snapshot_start();
+		pthread_mutex_unlock(&snapshot_mutex);
+	}
+
+	return rv;
+}
+
+int _connection_snapshot_get(connection_snapshot_state_s *state)
+{
+	int seq;
+	int rv;
+
+	rv = __snapshot_load();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	do {
+		seq = _connection_seqlock_read_begin(&snapshot_sequence);
+		memcpy(state, &snapshot, sizeof(connection_snapshot_state_s));
+	} while (_connection_seqlock_read_retry(&snapshot_sequence, seq));
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_snapshot_get_proxy(connection_proxy_endpoint_s *proxy)
+{
+	int seq;
+	int rv;
+
+	rv = __snapshot_load();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	do {
+		seq = _connection_seqlock_read_begin(&snapshot_sequence);
+		memcpy(proxy, &snapshot.proxy, sizeof(connection_proxy_endpoint_s));
+	} while (_connection_seqlock_read_retry(&snapshot_sequence, seq));
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_snapshot_get_dns_servers(connection_dns_servers_s *servers)
+{
+	int seq;
+	int rv;
+
+	rv = __snapshot_load();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	do {
+		seq = _connection_seqlock_read_begin(&snapshot_sequence);
+		memcpy(servers, &snapshot.dns_servers, sizeof(connection_dns_servers_s));
+	} while (_connection_seqlock_read_retry(&snapshot_sequence, seq));
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_snapshot_watch_dns(connection_snapshot_dns_cb callback)
+{
+	int rv;
+
+	if (callback == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	/* Changes are reported from a loaded snapshot on */
+	rv = __snapshot_load();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	pthread_mutex_lock(&snapshot_mutex);
+
+	if (g_slist_find(snapshot_dns_callbacks, callback)) {
+		pthread_mutex_unlock(&snapshot_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	snapshot_dns_callbacks = g_slist_append(snapshot_dns_callbacks, callback);
+
+	pthread_mutex_unlock(&snapshot_mutex);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_snapshot_unwatch_dns(connection_snapshot_dns_cb callback)
+{
+	int rv = CONNECTION_ERROR_NONE;
+
+	pthread_mutex_lock(&snapshot_mutex);
+
+	if (g_slist_find(snapshot_dns_callbacks, callback))
+		snapshot_dns_callbacks = g_slist_remove(snapshot_dns_callbacks, callback);
+	else
+		rv = CONNECTION_ERROR_INVALID_OPERATION;
+
+	pthread_mutex_unlock(&snapshot_mutex);
+
+	return rv;
+}
+
+void _connection_snapshot_update_profile(void)
+{
+	if (!g_atomic_int_get(&snapshot_valid))
+		return;
+
+	pthread_mutex_lock(&snapshot_mutex);
+
+	/* Bursts of events are applied once */
+	if (g_atomic_int_get(&snapshot_valid) && snapshot_refresh_source == 0)
+		snapshot_refresh_source = g_idle_add(__snapshot_refresh, NULL);
+
+	pthread_mutex_unlock(&snapshot_mutex);
+}
+
+/* Must be called with the lock held */
+void _connection_snapshot_open(void)
+{
+	pthread_mutex_lock(&snapshot_mutex);
+	snapshot_open = 1;
+	pthread_mutex_unlock(&snapshot_mutex);
+}
+
+/* Must be called with the lock held */
+void _connection_snapshot_clear(void)
+{
+	pthread_mutex_lock(&snapshot_mutex);
+
+	snapshot_open = 0;
+
+	if (g_atomic_int_get(&snapshot_valid)) {
+		g_atomic_int_set(&snapshot_valid, 0);
+
+		__snapshot_unwatch(G_N_ELEMENTS(snapshot_keys));
+		_connection_ethernet_monitor_stop(__snapshot_ethernet_changed_cb);
+
+		if (snapshot_refresh_source) {
+			g_source_remove(snapshot_refresh_source);
+			snapshot_refresh_source = 0;
+		}
+	}
+
+	pthread_mutex_unlock(&snapshot_mutex);
+}
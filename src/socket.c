@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+/* Linux 5.0, older headers lack it */
+#ifndef SO_BINDTOIFINDEX
+#define SO_BINDTOIFINDEX 62
+#endif
+
+/* Interface name to index. An index is dropped when the kernel no longer knows it */
+static GHashTable *socket_interfaces = NULL;
+static pthread_mutex_t socket_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Cleared once the kernel turned SO_BINDTOIFINDEX down, binding by name from then on */
+static volatile int socket_bind_by_index = 1;
+
+
+static unsigned int __socket_get_ifindex(const char *interface_name, bool refresh)
+{
+	gpointer value = NULL;
+	unsigned int ifindex;
+
+	pthread_mutex_lock(&socket_mutex);
+
+	if (socket_interfaces == NULL)
+		socket_interfaces = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	if (refresh)
+		g_hash_table_remove(socket_interfaces, interface_name);
+	else
+		value = g_hash_table_lookup(socket_interfaces, interface_name);
+
+	pthread_mutex_unlock(&socket_mutex);
+
+	if (value)
+		return GPOINTER_TO_UINT(value);
+
+	ifindex = if_nametoindex(interface_name);
+	if (ifindex == 0)
+		return 0;
+
+	pthread_mutex_lock(&socket_mutex);
+	g_hash_table_insert(socket_interfaces, g_strdup(interface_name), GUINT_TO_POINTER(ifindex));
+	pthread_mutex_unlock(&socket_mutex);
+
+	return ifindex;
+}
+
+static int __socket_bind_interface(int socket_fd, const char *interface_name)
+{
+	unsigned int ifindex;
+	int retry;
+	int error;
+
+	if (!g_atomic_int_get(&socket_bind_by_index)) {
+		if (setsockopt(socket_fd, SOL_SOCKET, SO_BINDTODEVICE,
+				interface_name, strlen(interface_name) + 1) == 0)
+			return CONNECTION_ERROR_NONE;
+
+		error = errno;
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot bind to %s : %d\n", interface_name, error);
+		return error == ENODEV ? CONNECTION_ERROR_NO_CONNECTION : CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	/* A cached index may belong to an interface which was recreated since: look it up once more */
+	error = ENODEV;
+	for (retry = 0; retry < 2; retry++) {
+		ifindex = __socket_get_ifindex(interface_name, retry > 0);
+		if (ifindex == 0)
+			return CONNECTION_ERROR_NO_CONNECTION;
+
+		if (setsockopt(socket_fd, SOL_SOCKET, SO_BINDTOIFINDEX, &ifindex, sizeof(ifindex)) == 0)
+			return CONNECTION_ERROR_NONE;
+
+		error = errno;
+		if (error == ENOPROTOOPT) {
+			CONNECTION_LOG(CONNECTION_INFO, "Binding by index is not supported, binding by name\n");
+			g_atomic_int_set(&socket_bind_by_index, 0);
+			return __socket_bind_interface(socket_fd, interface_name);
+		}
+
+		if (error != ENODEV)
+			break;
+	}
+
+	CONNECTION_LOG(CONNECTION_ERROR, "Cannot bind to %s : %d\n", interface_name, error);
+
+	return error == ENODEV ? CONNECTION_ERROR_NO_CONNECTION : CONNECTION_ERROR_OPERATION_FAILED;
+}
+
+int _connection_socket_bind(int socket_fd, int family, bool is_bound, net_dev_info_t *net_info)
+{
+	struct sockaddr_in address;
+	int error;
+	int rv;
+
+	if (net_info->DevName[0] == '\0')
+		return CONNECTION_ERROR_NO_CONNECTION;
+
+	rv = __socket_bind_interface(socket_fd, net_info->DevName);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	/* Only IPv4 addresses are known to the profiles */
+	if (is_bound || family != AF_INET || net_info->IpAddr.Type != NET_ADDR_IPV4 ||
+	    net_info->IpAddr.Data.Ipv4.s_addr == INADDR_ANY)
+		return CONNECTION_ERROR_NONE;
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr = net_info->IpAddr.Data.Ipv4;
+
+	if (bind(socket_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+		error = errno;
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot bind to the address of %s : %d\n",
+				net_info->DevName, error);
+		return error == EADDRNOTAVAIL ? CONNECTION_ERROR_NO_CONNECTION : CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
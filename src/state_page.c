@@ -0,0 +1,540 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <vconf/vconf.h>
+#include "net_connection_private.h"
+
+enum {
+	STATE_PAGE_ROLE_NONE = 0,
+	STATE_PAGE_ROLE_READER,
+	/* Holds the lock of the file, and publishes once started */
+	STATE_PAGE_ROLE_PUBLISHER,
+};
+
+static const char *state_page_keys[] = {
+	VCONFKEY_NETWORK_STATUS,
+	VCONFKEY_NETWORK_IP,
+	VCONFKEY_NETWORK_PROXY,
+	VCONFKEY_NETWORK_WIFI_STATE,
+	VCONFKEY_NETWORK_CELLULAR_STATE,
+};
+
+/* Taken after the connection lock, never before */
+static pthread_mutex_t state_page_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *state_page_path = NULL;
+static bool state_page_configured = false;
+static int state_page_fd = -1;
+static bool state_page_writable = false;
+/* Read without the lock: it only changes while no handle exists */
+static connection_state_page_s *state_page = NULL;
+static int state_page_role = STATE_PAGE_ROLE_NONE;
+static bool state_page_watching = false;
+static guint state_page_start_source = 0;
+static guint state_page_refresh_source = 0;
+static volatile gint64 state_page_checked = 0;
+
+typedef void (*state_page_reader)(const connection_state_page_s *page, void *data);
+
+struct _state_page_profiles_s {
+	int count;
+	net_profile_info_t *profiles;
+};
+
+
+/* Must be called with the state page lock held */
+static void __state_page_init(void)
+{
+	const char *path;
+
+	if (state_page_configured)
+		return;
+
+	path = getenv(CONNECTION_STATE_PAGE_ENV);
+	if (path && path[0] != '\0')
+		state_page_path = g_strdup(path);
+
+	state_page_configured = true;
+}
+
+/* Must be called with the state page lock held, as the publisher */
+static void __state_page_publish_facts(void)
+{
+	connection_state_facts_s facts;
+
+	_connection_state_page_load_facts(&facts);
+
+	_connection_seqlock_write_begin(&state_page->sequence);
+	memcpy(&state_page->facts, &facts, sizeof(connection_state_facts_s));
+	_connection_seqlock_write_end(&state_page->sequence);
+}
+
+/* Must be called with the state page lock held, as the publisher */
+static void __state_page_publish_profiles(void)
+{
+	net_device_t device_types[] = {NET_DEVICE_WIFI, NET_DEVICE_CELLULAR, NET_DEVICE_ETHERNET};
+	net_profile_info_t *current = g_new0(net_profile_info_t, 1);
+	net_profile_info_t *connected = g_new0(net_profile_info_t, CONNECTION_STATE_PAGE_PROFILE_MAX);
+	int connected_count = 0;
+	bool has_current;
+	bool fetched = true;
+	int rv;
+	int i, j;
+
+	rv = net_get_active_net_info(current);
+	has_current = (rv == NET_ERR_NONE);
+	if (rv != NET_ERR_NONE && rv != NET_ERR_NO_SERVICE)
+		fetched = false;
+
+	for (i = 0; i < G_N_ELEMENTS(device_types) && fetched; i++) {
+		net_profile_info_t *profiles = NULL;
+		int count = 0;
+
+		rv = net_get_profile_list(device_types[i], &profiles, &count);
+		if (rv != NET_ERR_NONE && rv != NET_ERR_NO_SERVICE) {
+			fetched = false;
+			break;
+		}
+
+		for (j = 0; j < count; j++) {
+			if (profiles[j].ProfileState != NET_STATE_TYPE_ONLINE &&
+			    profiles[j].ProfileState != NET_STATE_TYPE_READY)
+				continue;
+
+			if (connected_count < CONNECTION_STATE_PAGE_PROFILE_MAX)
+				memcpy(&connected[connected_count], &profiles[j], sizeof(net_profile_info_t));
+			connected_count++;
+		}
+
+		g_free(profiles);
+	}
+
+	/* On failure the page keeps the last profiles, the next event retries */
+	if (fetched) {
+		_connection_seqlock_write_begin(&state_page->sequence);
+
+		state_page->has_current_profile = has_current;
+		if (has_current)
+			memcpy(&state_page->current_profile, current, sizeof(net_profile_info_t));
+
+		/* More than the page holds: readers ask the daemon */
+		if (connected_count > CONNECTION_STATE_PAGE_PROFILE_MAX) {
+			state_page->connected_count = -1;
+		} else {
+			state_page->connected_count = connected_count;
+			memcpy(state_page->connected_profiles, connected,
+					connected_count * sizeof(net_profile_info_t));
+		}
+
+		_connection_seqlock_write_end(&state_page->sequence);
+	} else {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot fetch the profiles of the state page\n");
+	}
+
+	g_free(current);
+	g_free(connected);
+}
+
+static void __state_page_key_changed_cb(keynode_t *node, void *user_data)
+{
+	pthread_mutex_lock(&state_page_mutex);
+
+	if (state_page_role == STATE_PAGE_ROLE_PUBLISHER && state_page_start_source == 0)
+		__state_page_publish_facts();
+
+	pthread_mutex_unlock(&state_page_mutex);
+}
+
+/* Must be called with the state page lock held */
+static void __state_page_unwatch(void)
+{
+	int i;
+
+	if (!state_page_watching)
+		return;
+
+	for (i = 0; i < G_N_ELEMENTS(state_page_keys); i++)
+		vconf_ignore_key_changed(state_page_keys[i], __state_page_key_changed_cb);
+
+	state_page_watching = false;
+}
+
+/* Must be called with the state page lock held */
+static void __state_page_resign(void)
+{
+	if (state_page_start_source) {
+		g_source_remove(state_page_start_source);
+		state_page_start_source = 0;
+	}
+
+	if (state_page_refresh_source) {
+		g_source_remove(state_page_refresh_source);
+		state_page_refresh_source = 0;
+	}
+
+	__state_page_unwatch();
+
+	_connection_seqlock_write_begin(&state_page->sequence);
+	state_page->publisher = 0;
+	_connection_seqlock_write_end(&state_page->sequence);
+
+	flock(state_page_fd, LOCK_UN);
+	state_page_role = STATE_PAGE_ROLE_READER;
+}
+
+static gboolean __state_page_start(gpointer user_data)
+{
+	int i;
+
+	pthread_mutex_lock(&state_page_mutex);
+
+	state_page_start_source = 0;
+
+	if (state_page_role != STATE_PAGE_ROLE_PUBLISHER) {
+		pthread_mutex_unlock(&state_page_mutex);
+		return FALSE;
+	}
+
+	/* The events of the daemon keep the profiles up to date */
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot publish the state page\n");
+		__state_page_resign();
+		pthread_mutex_unlock(&state_page_mutex);
+		return FALSE;
+	}
+
+	for (i = 0; i < G_N_ELEMENTS(state_page_keys); i++)
+		vconf_notify_key_changed(state_page_keys[i], __state_page_key_changed_cb, NULL);
+	state_page_watching = true;
+
+	__state_page_publish_facts();
+	__state_page_publish_profiles();
+
+	_connection_seqlock_write_begin(&state_page->sequence);
+	state_page->publisher = getpid();
+	_connection_seqlock_write_end(&state_page->sequence);
+
+	CONNECTION_LOG(CONNECTION_INFO, "Publishing the state page %s\n", state_page_path);
+
+	pthread_mutex_unlock(&state_page_mutex);
+
+	return FALSE;
+}
+
+static gboolean __state_page_refresh(gpointer user_data)
+{
+	pthread_mutex_lock(&state_page_mutex);
+
+	state_page_refresh_source = 0;
+
+	if (state_page_role == STATE_PAGE_ROLE_PUBLISHER && state_page_start_source == 0)
+		__state_page_publish_profiles();
+
+	pthread_mutex_unlock(&state_page_mutex);
+
+	return FALSE;
+}
+
+/* Must be called with the state page lock held */
+static bool __state_page_try_publish(void)
+{
+	if (!state_page_writable || flock(state_page_fd, LOCK_EX | LOCK_NB) < 0)
+		return false;
+
+	/* A publisher that died in the middle of an update left the sequence odd */
+	if (g_atomic_int_get(&state_page->sequence) & 1)
+		g_atomic_int_inc(&state_page->sequence);
+
+	_connection_seqlock_write_begin(&state_page->sequence);
+	state_page->magic = CONNECTION_STATE_PAGE_MAGIC;
+	state_page->version = CONNECTION_STATE_PAGE_VERSION;
+	state_page->size = sizeof(connection_state_page_s);
+	state_page->publisher = 0;
+	_connection_seqlock_write_end(&state_page->sequence);
+
+	state_page_role = STATE_PAGE_ROLE_PUBLISHER;
+
+	/* Filling the page needs the daemon: it is done from the main loop, not from the caller */
+	state_page_start_source = g_idle_add(__state_page_start, NULL);
+
+	return true;
+}
+
+/* A publisher that left or died released its lock: one reader takes over */
+static void __state_page_check(void)
+{
+	gint64 now = g_get_monotonic_time();
+	gint64 checked = __sync_fetch_and_add(&state_page_checked, 0);
+
+	if (now - checked < CONNECTION_STATE_PAGE_CHECK_INTERVAL * 1000 ||
+	    !__sync_bool_compare_and_swap(&state_page_checked, checked, now))
+		return;
+
+	if (pthread_mutex_trylock(&state_page_mutex) != 0)
+		return;
+
+	if (state_page && state_page_role == STATE_PAGE_ROLE_READER)
+		__state_page_try_publish();
+
+	pthread_mutex_unlock(&state_page_mutex);
+}
+
+/* Lock-free: false when nobody publishes the page or a writer does not finish */
+static bool __state_page_read(state_page_reader reader, void *data)
+{
+	connection_state_page_s *page = g_atomic_pointer_get(&state_page);
+	int seq;
+	int i;
+
+	if (page == NULL)
+		return false;
+
+	__state_page_check();
+
+	for (i = 0; i < CONNECTION_STATE_PAGE_READ_RETRY; i++) {
+		if (!_connection_seqlock_try_read_begin(&page->sequence, &seq)) {
+			sched_yield();
+			continue;
+		}
+
+		if (page->magic != CONNECTION_STATE_PAGE_MAGIC ||
+		    page->version != CONNECTION_STATE_PAGE_VERSION ||
+		    page->size != sizeof(connection_state_page_s) ||
+		    page->publisher == 0)
+			return false;
+
+		reader(page, data);
+
+		if (!_connection_seqlock_read_retry(&page->sequence, seq))
+			return true;
+	}
+
+	return false;
+}
+
+static void __state_page_read_facts_cb(const connection_state_page_s *page, void *data)
+{
+	memcpy(data, &page->facts, sizeof(connection_state_facts_s));
+}
+
+static void __state_page_read_current_cb(const connection_state_page_s *page, void *data)
+{
+	struct _state_page_profiles_s *result = data;
+
+	result->count = page->has_current_profile ? 1 : 0;
+	if (result->count)
+		memcpy(result->profiles, &page->current_profile, sizeof(net_profile_info_t));
+}
+
+static void __state_page_read_connected_cb(const connection_state_page_s *page, void *data)
+{
+	struct _state_page_profiles_s *result = data;
+
+	result->count = MIN(page->connected_count, CONNECTION_STATE_PAGE_PROFILE_MAX);
+	if (result->count > 0)
+		memcpy(result->profiles, page->connected_profiles, result->count * sizeof(net_profile_info_t));
+}
+
+/* Reads the facts from vconf, as the publisher does */
+void _connection_state_page_load_facts(connection_state_facts_s *facts)
+{
+	char *str;
+
+	memset(facts, 0, sizeof(connection_state_facts_s));
+
+	vconf_get_int(VCONFKEY_NETWORK_STATUS, &facts->network_status);
+	vconf_get_int(VCONFKEY_NETWORK_WIFI_STATE, &facts->wifi_state);
+	vconf_get_int(VCONFKEY_NETWORK_CELLULAR_STATE, &facts->cellular_state);
+
+	str = vconf_get_str(VCONFKEY_NETWORK_IP);
+	if (str) {
+		g_strlcpy(facts->ip_address, str, sizeof(facts->ip_address));
+		free(str);
+	}
+
+	str = vconf_get_str(VCONFKEY_NETWORK_PROXY);
+	if (str) {
+		g_strlcpy(facts->proxy_address, str, sizeof(facts->proxy_address));
+		free(str);
+	}
+}
+
+int _connection_state_page_set_path(const char *path)
+{
+	pthread_mutex_lock(&state_page_mutex);
+
+	/* The page in use stays until the last handle is destroyed */
+	if (state_page) {
+		pthread_mutex_unlock(&state_page_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	g_free(state_page_path);
+	state_page_path = (path && path[0] != '\0') ? g_strdup(path) : NULL;
+	state_page_configured = true;
+
+	pthread_mutex_unlock(&state_page_mutex);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+/* Must be called with the lock held */
+void _connection_state_page_open(void)
+{
+	struct stat st;
+	void *map;
+	int fd;
+
+	pthread_mutex_lock(&state_page_mutex);
+
+	__state_page_init();
+
+	if (state_page_path == NULL || state_page) {
+		pthread_mutex_unlock(&state_page_mutex);
+		return;
+	}
+
+	state_page_writable = true;
+
+	fd = open(state_page_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0 && errno == EACCES) {
+		/* Still worth reading what another process publishes */
+		state_page_writable = false;
+		fd = open(state_page_path, O_RDONLY | O_CLOEXEC);
+	}
+
+	if (fd < 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot open state page %s\n", state_page_path);
+		pthread_mutex_unlock(&state_page_mutex);
+		return;
+	}
+
+	if (fstat(fd, &st) < 0 ||
+	    (st.st_size < sizeof(connection_state_page_s) &&
+	     (!state_page_writable || ftruncate(fd, sizeof(connection_state_page_s)) < 0))) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot size state page %s\n", state_page_path);
+		close(fd);
+		pthread_mutex_unlock(&state_page_mutex);
+		return;
+	}
+
+	map = mmap(NULL, sizeof(connection_state_page_s),
+			state_page_writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot map state page %s\n", state_page_path);
+		close(fd);
+		pthread_mutex_unlock(&state_page_mutex);
+		return;
+	}
+
+	state_page_fd = fd;
+	g_atomic_pointer_set(&state_page, map);
+	state_page_role = STATE_PAGE_ROLE_READER;
+
+	/* The first process to come publishes for the others */
+	__state_page_try_publish();
+	__sync_lock_test_and_set(&state_page_checked, g_get_monotonic_time());
+
+	CONNECTION_LOG(CONNECTION_INFO, "State page %s, publisher %d\n",
+			state_page_path, state_page_role == STATE_PAGE_ROLE_PUBLISHER);
+
+	pthread_mutex_unlock(&state_page_mutex);
+}
+
+/* Must be called with the lock held */
+void _connection_state_page_close(void)
+{
+	connection_state_page_s *page;
+
+	pthread_mutex_lock(&state_page_mutex);
+
+	page = state_page;
+	if (page == NULL) {
+		pthread_mutex_unlock(&state_page_mutex);
+		return;
+	}
+
+	if (state_page_role == STATE_PAGE_ROLE_PUBLISHER)
+		__state_page_resign();
+
+	g_atomic_pointer_set(&state_page, NULL);
+	munmap(page, sizeof(connection_state_page_s));
+	close(state_page_fd);
+
+	state_page_fd = -1;
+	state_page_role = STATE_PAGE_ROLE_NONE;
+
+	pthread_mutex_unlock(&state_page_mutex);
+}
+
+void _connection_state_page_update_profiles(void)
+{
+	pthread_mutex_lock(&state_page_mutex);
+
+	/* Bursts of events are published once */
+	if (state_page_role == STATE_PAGE_ROLE_PUBLISHER &&
+	    state_page_start_source == 0 && state_page_refresh_source == 0)
+		state_page_refresh_source = g_idle_add(__state_page_refresh, NULL);
+
+	pthread_mutex_unlock(&state_page_mutex);
+}
+
+bool _connection_state_page_get_facts(connection_state_facts_s *facts)
+{
+	return __state_page_read(__state_page_read_facts_cb, facts);
+}
+
+int _connection_state_page_get_current_profile(net_profile_info_t *profile_info)
+{
+	struct _state_page_profiles_s result = {0, profile_info};
+
+	if (!__state_page_read(__state_page_read_current_cb, &result))
+		return CONNECTION_ERROR_INVALID_OPERATION;
+
+	return result.count ? CONNECTION_ERROR_NONE : CONNECTION_ERROR_NO_CONNECTION;
+}
+
+int _connection_state_page_get_connected_profiles(net_profile_info_t **profiles, int *count)
+{
+	struct _state_page_profiles_s result;
+
+	result.count = 0;
+	result.profiles = g_try_new0(net_profile_info_t, CONNECTION_STATE_PAGE_PROFILE_MAX);
+	if (result.profiles == NULL)
+		return CONNECTION_ERROR_OUT_OF_MEMORY;
+
+	if (!__state_page_read(__state_page_read_connected_cb, &result) || result.count < 0) {
+		g_free(result.profiles);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	*profiles = result.profiles;
+	*count = result.count;
+
+	return CONNECTION_ERROR_NONE;
+}
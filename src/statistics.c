@@ -0,0 +1,811 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <net/if.h>
+#include <glib.h>
+#include <vconf/vconf.h>
+#include "net_connection_private.h"
+
+#define STATISTICS_STORAGE_MAGIC	0x53544154
+#define STATISTICS_STORAGE_VERSION	2
+#define STATISTICS_STORAGE_LOCK		"statistics.lock"
+#define STATISTICS_BOOT_ID_PATH		"/proc/sys/kernel/random/boot_id"
+#define STATISTICS_BOOT_ID_LEN		36
+
+struct _statistics_storage_s {
+	unsigned int magic;
+	unsigned int version;
+	char interface_name[NET_MAX_DEVICE_NAME_LEN+1];
+	connection_statistics_counter_s counter;
+	/* Version 2: the raw counters of another boot are no baseline */
+	char boot_id[STATISTICS_BOOT_ID_LEN+1];
+};
+
+/* Version 1 files end where the boot identifier starts */
+#define STATISTICS_STORAGE_V1_SIZE	offsetof(struct _statistics_storage_s, boot_id)
+
+/*
+ * The storage file is shared by every process using the library. Each process counts in memory
+ * and merges its counters into the file under a file lock, every CONNECTION_STATISTICS_SYNC_INTERVAL
+ * seconds and on each reset or new connection. The merge applies the kernel counters to the file,
+ * so no process overwrites the totals or resets of another; those reach it at its next merge.
+ */
+struct _statistics_s {
+	bool loaded;
+	/* The counters hold anything read from a backend */
+	bool known;
+	bool needs_sync;
+	time_t last_sync;
+	struct _statistics_storage_s storage;
+};
+
+static pthread_mutex_t statistics_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct _statistics_s cellular_statistics;
+static struct _statistics_s wifi_statistics;
+static struct _statistics_s ethernet_statistics;
+static char statistics_boot_id[STATISTICS_BOOT_ID_LEN+1];
+static bool statistics_boot_id_read = false;
+/* Set when the storage cannot be written, by an unprivileged application for instance */
+static bool statistics_read_only = false;
+
+
+static struct _statistics_s *__statistics_get(net_device_t device_type)
+{
+	switch (device_type) {
+	case NET_DEVICE_CELLULAR:
+		return &cellular_statistics;
+	case NET_DEVICE_WIFI:
+		return &wifi_statistics;
+	case NET_DEVICE_ETHERNET:
+		return &ethernet_statistics;
+	default:
+		return NULL;
+	}
+}
+
+static const char *__statistics_get_storage_name(net_device_t device_type)
+{
+	switch (device_type) {
+	case NET_DEVICE_CELLULAR:
+		return "cellular";
+	case NET_DEVICE_WIFI:
+		return "wifi";
+	case NET_DEVICE_ETHERNET:
+		return "ethernet";
+	default:
+		return NULL;
+	}
+}
+
+static time_t __statistics_get_uptime(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+		return 0;
+
+	return ts.tv_sec;
+}
+
+/* Must be called with the statistics mutex held */
+static const char *__statistics_get_boot_id(void)
+{
+	gchar *contents = NULL;
+
+	if (statistics_boot_id_read)
+		return statistics_boot_id;
+
+	statistics_boot_id_read = true;
+
+	if (g_file_get_contents(STATISTICS_BOOT_ID_PATH, &contents, NULL, NULL)) {
+		g_strlcpy(statistics_boot_id, g_strstrip(contents), STATISTICS_BOOT_ID_LEN+1);
+		g_free(contents);
+	} else
+		CONNECTION_LOG(CONNECTION_WARN, "Cannot read %s\n", STATISTICS_BOOT_ID_PATH);
+
+	return statistics_boot_id;
+}
+
+static unsigned long long __statistics_get_delta(unsigned long long prev, unsigned long long cur,
+		bool counters_32bit)
+{
+	if (cur >= prev)
+		return cur - prev;
+
+	/* Only a 32-bit counter wraps around, at 4 GiB */
+	if (counters_32bit && prev <= G_MAXUINT32)
+		return (G_MAXUINT32 - prev) + cur + 1;
+
+	/* Otherwise the counter was reset, by a driver reload for instance */
+	return cur;
+}
+
+static bool __statistics_seed_from_vconf(connection_statistics_counter_s *counter)
+{
+	bool seeded = false;
+	int size = 0;
+
+	if (!vconf_get_int(VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV, &size) && size > 0) {
+		counter->last[CONNECTION_STATISTICS_DIRECTION_RX] = (unsigned long long)size;
+		seeded = true;
+	}
+	if (!vconf_get_int(VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT, &size) && size > 0) {
+		counter->last[CONNECTION_STATISTICS_DIRECTION_TX] = (unsigned long long)size;
+		seeded = true;
+	}
+	if (!vconf_get_int(VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV, &size) && size > 0) {
+		counter->total[CONNECTION_STATISTICS_DIRECTION_RX] = (unsigned long long)size;
+		seeded = true;
+	}
+	if (!vconf_get_int(VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT, &size) && size > 0) {
+		counter->total[CONNECTION_STATISTICS_DIRECTION_TX] = (unsigned long long)size;
+		seeded = true;
+	}
+
+	return seeded;
+}
+
+static bool __statistics_seed_from_libnet(connection_statistics_counter_s *counter, net_device_t device_type)
+{
+	const net_statistics_type_e types[4] = {
+		NET_STATISTICS_TYPE_LAST_RECEIVED_DATA, NET_STATISTICS_TYPE_LAST_SENT_DATA,
+		NET_STATISTICS_TYPE_TOTAL_RECEIVED_DATA, NET_STATISTICS_TYPE_TOTAL_SENT_DATA};
+	unsigned long long *sizes[4] = {
+		&counter->last[CONNECTION_STATISTICS_DIRECTION_RX], &counter->last[CONNECTION_STATISTICS_DIRECTION_TX],
+		&counter->total[CONNECTION_STATISTICS_DIRECTION_RX], &counter->total[CONNECTION_STATISTICS_DIRECTION_TX]};
+	bool seeded = false;
+	int i;
+
+	for (i = 0; i < 4; i++)
+		if (_connection_libnet_get_statistics(device_type, types[i], sizes[i]) == CONNECTION_ERROR_NONE)
+			seeded = true;
+
+	return seeded;
+}
+
+/* May call the daemon: must be called without any lock held */
+static bool __statistics_seed(net_device_t device_type, connection_statistics_counter_s *counter)
+{
+	memset(counter, 0, sizeof(connection_statistics_counter_s));
+
+	switch (device_type) {
+	case NET_DEVICE_CELLULAR:
+		return __statistics_seed_from_vconf(counter);
+	case NET_DEVICE_WIFI:
+		return __statistics_seed_from_libnet(counter, device_type);
+	default:
+		return false;
+	}
+}
+
+static char *__statistics_get_path(net_device_t device_type)
+{
+	return g_strdup_printf("%s/%s", CONNECTION_STATISTICS_STORAGE_DIR,
+				__statistics_get_storage_name(device_type));
+}
+
+/* The file is replaced atomically, so it can be read without the file lock */
+static bool __statistics_read(net_device_t device_type, struct _statistics_storage_s *storage)
+{
+	char *path = __statistics_get_path(device_type);
+	gchar *contents = NULL;
+	gsize length = 0;
+	bool valid = false;
+
+	memset(storage, 0, sizeof(struct _statistics_storage_s));
+
+	if (g_file_get_contents(path, &contents, &length, NULL) &&
+	    (length == sizeof(struct _statistics_storage_s) || length == STATISTICS_STORAGE_V1_SIZE)) {
+		memcpy(storage, contents, length);
+
+		if (storage->magic == STATISTICS_STORAGE_MAGIC &&
+		    ((storage->version == 1 && length == STATISTICS_STORAGE_V1_SIZE) ||
+		     (storage->version == STATISTICS_STORAGE_VERSION && length == sizeof(struct _statistics_storage_s)))) {
+			storage->version = STATISTICS_STORAGE_VERSION;
+			storage->interface_name[NET_MAX_DEVICE_NAME_LEN] = '\0';
+			storage->boot_id[STATISTICS_BOOT_ID_LEN] = '\0';
+			valid = true;
+		} else
+			memset(storage, 0, sizeof(struct _statistics_storage_s));
+	}
+
+	g_free(contents);
+	g_free(path);
+
+	return valid;
+}
+
+static bool __statistics_write(net_device_t device_type, struct _statistics_storage_s *storage)
+{
+	char *path = __statistics_get_path(device_type);
+	bool written;
+
+	written = g_file_set_contents(path, (const gchar *)storage, sizeof(struct _statistics_storage_s), NULL);
+	g_free(path);
+
+	return written;
+}
+
+/* Serializes the read-modify-write of the storage files between processes */
+static int __statistics_lock_storage(void)
+{
+	char *path;
+	int fd;
+
+	if (g_mkdir_with_parents(CONNECTION_STATISTICS_STORAGE_DIR, 0755) != 0)
+		return -1;
+
+	path = g_strdup_printf("%s/%s", CONNECTION_STATISTICS_STORAGE_DIR, STATISTICS_STORAGE_LOCK);
+	fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	g_free(path);
+
+	if (fd < 0)
+		return -1;
+
+	while (flock(fd, LOCK_EX) < 0) {
+		if (errno != EINTR) {
+			close(fd);
+			return -1;
+		}
+	}
+
+	return fd;
+}
+
+static void __statistics_unlock_storage(int fd)
+{
+	if (fd < 0)
+		return;
+
+	flock(fd, LOCK_UN);
+	close(fd);
+}
+
+/* Must be called with the statistics mutex held */
+static void __statistics_set_read_only(void)
+{
+	if (statistics_read_only)
+		return;
+
+	/* Warned once: the counters are kept in memory from now on */
+	CONNECTION_LOG(CONNECTION_WARN, "Cannot write statistics in %s, keeping them in memory\n",
+			CONNECTION_STATISTICS_STORAGE_DIR);
+	statistics_read_only = true;
+}
+
+/* Must be called with the statistics mutex held */
+static bool __statistics_sync_due(struct _statistics_s *stat, time_t now)
+{
+	if (statistics_read_only)
+		return false;
+
+	return stat->needs_sync || now - stat->last_sync >= CONNECTION_STATISTICS_SYNC_INTERVAL;
+}
+
+/* Must be called with the statistics mutex held. Returns whether the storage was of another boot */
+static bool __statistics_check_boot(struct _statistics_storage_s *storage)
+{
+	const char *boot_id = __statistics_get_boot_id();
+
+	if (strcmp(storage->boot_id, boot_id) == 0)
+		return false;
+
+	/* The kernel counters restarted with the boot: the next read starts a new session */
+	g_strlcpy(storage->boot_id, boot_id, STATISTICS_BOOT_ID_LEN+1);
+	storage->counter.ifindex = 0;
+
+	return true;
+}
+
+/* Reads the storage file once per process, or seeds the counters if there is none. May call the daemon */
+static void __statistics_load(struct _statistics_s *stat, net_device_t device_type)
+{
+	struct _statistics_storage_s storage;
+	connection_statistics_counter_s seed;
+	bool seeded = false;
+	bool valid;
+	bool loaded;
+
+	pthread_mutex_lock(&statistics_mutex);
+	loaded = stat->loaded;
+	pthread_mutex_unlock(&statistics_mutex);
+
+	if (loaded)
+		return;
+
+	/* The file is replaced atomically: no file lock is needed to read it */
+	valid = __statistics_read(device_type, &storage);
+	if (!valid)
+		seeded = __statistics_seed(device_type, &seed);
+
+	pthread_mutex_lock(&statistics_mutex);
+
+	if (!stat->loaded) {
+		if (!valid) {
+			CONNECTION_LOG(CONNECTION_INFO, "No statistics storage for %s, seeding it\n",
+					__statistics_get_storage_name(device_type));
+
+			storage.magic = STATISTICS_STORAGE_MAGIC;
+			storage.version = STATISTICS_STORAGE_VERSION;
+			g_strlcpy(storage.boot_id, __statistics_get_boot_id(), STATISTICS_BOOT_ID_LEN+1);
+			if (seeded)
+				memcpy(&storage.counter, &seed, sizeof(connection_statistics_counter_s));
+			stat->needs_sync = true;
+		}
+
+		if (__statistics_check_boot(&storage))
+			stat->needs_sync = true;
+
+		memcpy(&stat->storage, &storage, sizeof(struct _statistics_storage_s));
+		stat->known = valid || seeded;
+		stat->last_sync = __statistics_get_uptime();
+		stat->loaded = true;
+	}
+
+	pthread_mutex_unlock(&statistics_mutex);
+}
+
+/*
+ * Merges the counters of the process into the storage file, applies a reset and writes it back.
+ * @a reset_type is a connection_statistics_type_e, or -1 for none; @a new_session restarts
+ * the last data. The kernel counters are read under the file lock, so a merge never goes back
+ * behind the one of another process. Without storage, only the counters in memory are updated.
+ */
+static void __statistics_sync(struct _statistics_s *stat, net_device_t device_type,
+		int reset_type, bool new_session)
+{
+	struct _statistics_storage_s storage;
+	unsigned long long counters[1][CONNECTION_STATISTICS_DIRECTION_MAX];
+	const char *interface_name;
+	unsigned int ifindex[1];
+	bool counters_32bit[1];
+	bool valid = false;
+	bool read_only;
+	int fd = -1;
+
+	pthread_mutex_lock(&statistics_mutex);
+	read_only = statistics_read_only;
+	pthread_mutex_unlock(&statistics_mutex);
+
+	if (!read_only) {
+		fd = __statistics_lock_storage();
+		if (fd >= 0)
+			valid = __statistics_read(device_type, &storage);
+	}
+
+	pthread_mutex_lock(&statistics_mutex);
+
+	if (fd < 0 && !read_only)
+		__statistics_set_read_only();
+
+	/* Without a file, the counters of this process start it */
+	if (!valid)
+		memcpy(&storage, &stat->storage, sizeof(struct _statistics_storage_s));
+
+	__statistics_check_boot(&storage);
+
+	/* The interface known to this process is the latest one */
+	if (stat->storage.interface_name[0] != '\0')
+		g_strlcpy(storage.interface_name, stat->storage.interface_name, NET_MAX_DEVICE_NAME_LEN+1);
+	interface_name = storage.interface_name;
+
+	if (interface_name[0] != '\0' &&
+	    _connection_statistics_read_links(1, &interface_name, ifindex, counters, counters_32bit) == 1 &&
+	    ifindex[0] > 0) {
+		_connection_statistics_accumulate(&storage.counter, ifindex[0], counters[0], counters_32bit[0]);
+		stat->known = true;
+	}
+
+	if (new_session) {
+		storage.counter.last[CONNECTION_STATISTICS_DIRECTION_RX] = 0;
+		storage.counter.last[CONNECTION_STATISTICS_DIRECTION_TX] = 0;
+	}
+
+	switch (reset_type) {
+	case CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA:
+		storage.counter.last[CONNECTION_STATISTICS_DIRECTION_RX] = 0;
+		break;
+	case CONNECTION_STATISTICS_TYPE_LAST_SENT_DATA:
+		storage.counter.last[CONNECTION_STATISTICS_DIRECTION_TX] = 0;
+		break;
+	case CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA:
+		storage.counter.total[CONNECTION_STATISTICS_DIRECTION_RX] = 0;
+		break;
+	case CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA:
+		storage.counter.total[CONNECTION_STATISTICS_DIRECTION_TX] = 0;
+		break;
+	default:
+		break;
+	}
+
+	memcpy(&stat->storage, &storage, sizeof(struct _statistics_storage_s));
+	stat->last_sync = __statistics_get_uptime();
+	stat->needs_sync = false;
+
+	pthread_mutex_unlock(&statistics_mutex);
+
+	if (fd < 0)
+		return;
+
+	if (!__statistics_write(device_type, &storage)) {
+		pthread_mutex_lock(&statistics_mutex);
+		__statistics_set_read_only();
+		pthread_mutex_unlock(&statistics_mutex);
+	}
+
+	__statistics_unlock_storage(fd);
+}
+
+/*
+ * Reads the kernel counters of the devices and applies them to the counters in memory.
+ * @a known tells which counters hold anything read from a backend, and may be NULL.
+ * The daemon and the kernel are asked without any lock held.
+ */
+static void __statistics_update_devices(int count, const net_device_t device_types[],
+		connection_statistics_counter_s results_counters[], int results[], bool known[])
+{
+	char names[NET_DEVICE_MAX][NET_MAX_DEVICE_NAME_LEN+1];
+	const char *interface_names[NET_DEVICE_MAX];
+	unsigned long long counters[NET_DEVICE_MAX][CONNECTION_STATISTICS_DIRECTION_MAX];
+	bool counters_32bit[NET_DEVICE_MAX];
+	bool has_name[NET_DEVICE_MAX];
+	bool sync[NET_DEVICE_MAX];
+	unsigned int ifindex[NET_DEVICE_MAX];
+	time_t now = __statistics_get_uptime();
+	bool read_failed;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		struct _statistics_s *stat = __statistics_get(device_types[i]);
+
+		has_name[i] = _connection_libnet_get_interface_name(device_types[i], names[i]);
+		__statistics_load(stat, device_types[i]);
+
+		pthread_mutex_lock(&statistics_mutex);
+		/* The interface is down: its last name still tells the session apart */
+		if (!has_name[i] && stat->storage.interface_name[0] != '\0') {
+			g_strlcpy(names[i], stat->storage.interface_name, NET_MAX_DEVICE_NAME_LEN+1);
+			has_name[i] = true;
+		}
+		pthread_mutex_unlock(&statistics_mutex);
+
+		interface_names[i] = has_name[i] ? names[i] : NULL;
+	}
+
+	/* One read of the kernel counters serves every device */
+	read_failed = (_connection_statistics_read_links(count, interface_names, ifindex,
+			counters, counters_32bit) < 0);
+
+	pthread_mutex_lock(&statistics_mutex);
+
+	for (i = 0; i < count; i++) {
+		struct _statistics_s *stat = __statistics_get(device_types[i]);
+
+		if (!has_name[i])
+			results[i] = CONNECTION_ERROR_NO_CONNECTION;
+		else if (read_failed)
+			results[i] = CONNECTION_ERROR_OPERATION_FAILED;
+		else
+			results[i] = CONNECTION_ERROR_NONE;
+
+		/* The interface is down: keep the counters of the last session */
+		if (results[i] == CONNECTION_ERROR_NONE && ifindex[i] > 0) {
+			g_strlcpy(stat->storage.interface_name, interface_names[i], NET_MAX_DEVICE_NAME_LEN+1);
+			_connection_statistics_accumulate(&stat->storage.counter, ifindex[i],
+					counters[i], counters_32bit[i]);
+			stat->known = true;
+		}
+
+		if (known)
+			known[i] = stat->known;
+
+		sync[i] = __statistics_sync_due(stat, now);
+
+		memcpy(&results_counters[i], &stat->storage.counter, sizeof(connection_statistics_counter_s));
+	}
+
+	pthread_mutex_unlock(&statistics_mutex);
+
+	for (i = 0; i < count; i++)
+		if (sync[i])
+			__statistics_sync(__statistics_get(device_types[i]), device_types[i], -1, false);
+}
+
+int _connection_statistics_read_interfaces(const char *path, int count, const char *interface_names[],
+		unsigned int ifindex[], unsigned long long counters[][CONNECTION_STATISTICS_DIRECTION_MAX])
+{
+	FILE *fp;
+	char line[256];
+	int found = 0;
+	int i;
+
+	for (i = 0; i < count; i++)
+		ifindex[i] = 0;
+
+	fp = fopen(path, "r");
+	if (fp == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot open %s\n", path);
+		return -1;
+	}
+
+	while (found < count && fgets(line, sizeof(line), fp)) {
+		char *name = line;
+		char *colon = strchr(line, ':');
+		if (colon == NULL)
+			continue;
+
+		*colon = '\0';
+		while (*name == ' ')
+			name++;
+
+		for (i = 0; i < count; i++) {
+			if (interface_names[i] == NULL || strcmp(name, interface_names[i]) != 0)
+				continue;
+
+			/* rx: bytes packets errs drop fifo frame compressed multicast, tx: bytes ... */
+			if (sscanf(colon + 1, "%llu %*u %*u %*u %*u %*u %*u %*u %llu",
+					&counters[i][CONNECTION_STATISTICS_DIRECTION_RX],
+					&counters[i][CONNECTION_STATISTICS_DIRECTION_TX]) != 2)
+				continue;
+
+			ifindex[i] = if_nametoindex(interface_names[i]);
+			found++;
+		}
+	}
+
+	fclose(fp);
+
+	return found;
+}
+
+int _connection_statistics_read_links(int count, const char *interface_names[], unsigned int ifindex[],
+		unsigned long long counters[][CONNECTION_STATISTICS_DIRECTION_MAX], bool counters_32bit[])
+{
+	connection_netlink_link_s *links = NULL;
+	int link_count = 0;
+	int found = 0;
+	int i, j;
+
+	/* /proc/net/dev has printed 64-bit counters since Linux 2.6.36 */
+	if (counters_32bit)
+		for (i = 0; i < count; i++)
+			counters_32bit[i] = false;
+
+	/* One RTM_GETLINK dump serves every interface, /proc is the fallback */
+	if (_connection_netlink_dump_links(&links, &link_count) != CONNECTION_ERROR_NONE)
+		return _connection_statistics_read_interfaces(CONNECTION_STATISTICS_PROC_PATH,
+				count, interface_names, ifindex, counters);
+
+	for (i = 0; i < count; i++) {
+		ifindex[i] = 0;
+
+		if (interface_names[i] == NULL)
+			continue;
+
+		for (j = 0; j < link_count; j++) {
+			if (strcmp(links[j].name, interface_names[i]) != 0)
+				continue;
+
+			ifindex[i] = links[j].ifindex;
+			counters[i][CONNECTION_STATISTICS_DIRECTION_RX] = links[j].counters[CONNECTION_STATISTICS_DIRECTION_RX];
+			counters[i][CONNECTION_STATISTICS_DIRECTION_TX] = links[j].counters[CONNECTION_STATISTICS_DIRECTION_TX];
+			if (counters_32bit)
+				counters_32bit[i] = links[j].counters_32bit;
+			found++;
+			break;
+		}
+	}
+
+	g_free(links);
+
+	return found;
+}
+
+int _connection_statistics_read_counters(const char *path, const char *interface_name,
+		unsigned long long counters[])
+{
+	unsigned long long interface_counters[1][CONNECTION_STATISTICS_DIRECTION_MAX];
+	unsigned int ifindex[1];
+
+	if (_connection_statistics_read_interfaces(path, 1, &interface_name,
+			ifindex, interface_counters) != 1)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	counters[CONNECTION_STATISTICS_DIRECTION_RX] = interface_counters[0][CONNECTION_STATISTICS_DIRECTION_RX];
+	counters[CONNECTION_STATISTICS_DIRECTION_TX] = interface_counters[0][CONNECTION_STATISTICS_DIRECTION_TX];
+
+	return CONNECTION_ERROR_NONE;
+}
+
+void _connection_statistics_accumulate(connection_statistics_counter_s *counter,
+		unsigned int ifindex, const unsigned long long counters[], bool counters_32bit)
+{
+	unsigned long long delta;
+	int i;
+
+	for (i = 0; i < CONNECTION_STATISTICS_DIRECTION_MAX; i++) {
+		if (counter->ifindex != ifindex) {
+			/* A new interface instance starts a new session from zero */
+			delta = counters[i];
+			counter->last[i] = 0;
+		} else
+			delta = __statistics_get_delta(counter->raw[i], counters[i], counters_32bit);
+
+		counter->raw[i] = counters[i];
+		counter->last[i] += delta;
+		counter->total[i] += delta;
+	}
+
+	counter->ifindex = ifindex;
+}
+
+int _connection_statistics_get(net_device_t device_type,
+		connection_statistics_type_e statistics_type, unsigned long long *size)
+{
+	connection_statistics_counter_s counter;
+	bool known;
+	int rv;
+
+	if (__statistics_get(device_type) == NULL || size == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	__statistics_update_devices(1, &device_type, &counter, &rv, &known);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	/* Neither counted nor seeded: the caller has its own fallback */
+	if (!known)
+		return CONNECTION_ERROR_NO_CONNECTION;
+
+	switch (statistics_type) {
+	case CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA:
+		*size = counter.last[CONNECTION_STATISTICS_DIRECTION_RX];
+		break;
+	case CONNECTION_STATISTICS_TYPE_LAST_SENT_DATA:
+		*size = counter.last[CONNECTION_STATISTICS_DIRECTION_TX];
+		break;
+	case CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA:
+		*size = counter.total[CONNECTION_STATISTICS_DIRECTION_RX];
+		break;
+	case CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA:
+		*size = counter.total[CONNECTION_STATISTICS_DIRECTION_TX];
+		break;
+	default:
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_statistics_feed(net_device_t device_type, const char *interface_name,
+		unsigned int ifindex, const unsigned long long counters[], bool counters_32bit,
+		connection_statistics_counter_s *counter)
+{
+	struct _statistics_s *stat = __statistics_get(device_type);
+	bool sync;
+
+	if (stat == NULL || counter == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	__statistics_load(stat, device_type);
+
+	pthread_mutex_lock(&statistics_mutex);
+
+	/* Counters read by the caller for a link that is up: no read of our own */
+	if (interface_name != NULL && ifindex > 0) {
+		g_strlcpy(stat->storage.interface_name, interface_name, NET_MAX_DEVICE_NAME_LEN+1);
+		_connection_statistics_accumulate(&stat->storage.counter, ifindex, counters, counters_32bit);
+		stat->known = true;
+	}
+
+	sync = __statistics_sync_due(stat, __statistics_get_uptime());
+
+	memcpy(counter, &stat->storage.counter, sizeof(connection_statistics_counter_s));
+
+	pthread_mutex_unlock(&statistics_mutex);
+
+	if (sync)
+		__statistics_sync(stat, device_type, -1, false);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_statistics_get_devices(int count, const net_device_t device_types[],
+		connection_statistics_counter_s counters[], int results[])
+{
+	bool known[NET_DEVICE_MAX];
+	int i;
+
+	if (count <= 0 || count > NET_DEVICE_MAX || device_types == NULL ||
+	    counters == NULL || results == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	for (i = 0; i < count; i++)
+		if (__statistics_get(device_types[i]) == NULL)
+			return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	__statistics_update_devices(count, device_types, counters, results, known);
+
+	/* Without fresh kernel counters the last known values still count */
+	for (i = 0; i < count; i++)
+		if (known[i])
+			results[i] = CONNECTION_ERROR_NONE;
+		else if (results[i] == CONNECTION_ERROR_NONE)
+			results[i] = CONNECTION_ERROR_NO_CONNECTION;
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_statistics_reset(net_device_t device_type, connection_statistics_type_e statistics_type)
+{
+	struct _statistics_s *stat = __statistics_get(device_type);
+
+	if (stat == NULL ||
+	    statistics_type < CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA ||
+	    statistics_type > CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	__statistics_load(stat, device_type);
+
+	/* The session counted so far is applied before the value is cleared */
+	__statistics_sync(stat, device_type, statistics_type, false);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+void _connection_statistics_start_session(net_device_t device_type, const char *interface_name)
+{
+	struct _statistics_s *stat = __statistics_get(device_type);
+
+	if (stat == NULL || interface_name == NULL || interface_name[0] == '\0')
+		return;
+
+	__statistics_load(stat, device_type);
+
+	pthread_mutex_lock(&statistics_mutex);
+	g_strlcpy(stat->storage.interface_name, interface_name, NET_MAX_DEVICE_NAME_LEN+1);
+	pthread_mutex_unlock(&statistics_mutex);
+
+	/* The traffic so far closes the previous connection, even if the interface stayed */
+	__statistics_sync(stat, device_type, -1, true);
+}
+
+int _connection_statistics_get_interface(const char *interface_name,
+		connection_statistics_direction_e direction, unsigned long long *size)
+{
+	unsigned long long counters[1][CONNECTION_STATISTICS_DIRECTION_MAX];
+	unsigned int ifindex[1];
+
+	if (interface_name == NULL || size == NULL ||
+	    direction >= CONNECTION_STATISTICS_DIRECTION_MAX)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	if (_connection_statistics_read_links(1, &interface_name, ifindex, counters, NULL) != 1)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	*size = counters[0][direction];
+
+	return CONNECTION_ERROR_NONE;
+}
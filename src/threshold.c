@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+struct _threshold_s {
+	int id;
+	connection_type_e connection_type;
+	net_device_t device_type;
+	connection_statistics_type_e statistics_type;
+	unsigned long long threshold;
+	bool armed;
+	connection_statistics_threshold_cb callback;
+	void *user_data;
+};
+
+struct _threshold_event_s {
+	connection_type_e connection_type;
+	connection_statistics_type_e statistics_type;
+	unsigned long long size;
+	connection_statistics_threshold_cb callback;
+	void *user_data;
+};
+
+static GSList *threshold_list = NULL;
+static int threshold_last_id = 0;
+/* Per device type, read by the sampler without the lock */
+static volatile int threshold_counts[NET_DEVICE_MAX];
+
+
+static unsigned long long __threshold_get_size(const connection_statistics_counter_s *counter,
+		connection_statistics_type_e statistics_type)
+{
+	switch (statistics_type) {
+	case CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA:
+		return counter->last[CONNECTION_STATISTICS_DIRECTION_RX];
+	case CONNECTION_STATISTICS_TYPE_LAST_SENT_DATA:
+		return counter->last[CONNECTION_STATISTICS_DIRECTION_TX];
+	case CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA:
+		return counter->total[CONNECTION_STATISTICS_DIRECTION_RX];
+	case CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA:
+		return counter->total[CONNECTION_STATISTICS_DIRECTION_TX];
+	default:
+		return 0;
+	}
+}
+
+int _connection_threshold_add(connection_type_e connection_type, net_device_t device_type,
+		connection_statistics_type_e statistics_type, unsigned long long threshold,
+		connection_statistics_threshold_cb callback, void *user_data, int *threshold_id)
+{
+	struct _threshold_s *entry;
+	unsigned long long size;
+	int rv;
+
+	if (callback == NULL || threshold_id == NULL || threshold == 0 ||
+	    statistics_type < CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA ||
+	    statistics_type > CONNECTION_STATISTICS_TYPE_TOTAL_SENT_DATA)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	entry = g_try_malloc0(sizeof(struct _threshold_s));
+	if (entry == NULL)
+		return CONNECTION_ERROR_OUT_OF_MEMORY;
+
+	entry->connection_type = connection_type;
+	entry->device_type = device_type;
+	entry->statistics_type = statistics_type;
+	entry->threshold = threshold;
+	entry->callback = callback;
+	entry->user_data = user_data;
+
+	/* A threshold already crossed fires only after the counter is reset. The counters are in memory */
+	if (_connection_statistics_get(device_type, statistics_type, &size) == CONNECTION_ERROR_NONE)
+		entry->armed = (size < threshold);
+	else
+		entry->armed = true;
+
+	CONNECTION_MUTEX_LOCK;
+	entry->id = ++threshold_last_id;
+	threshold_list = g_slist_append(threshold_list, entry);
+	g_atomic_int_inc(&threshold_counts[device_type]);
+	CONNECTION_MUTEX_UNLOCK;
+
+	/* Every threshold holds a reference to the sampler, which checks them all on each tick */
+	rv = _connection_sampler_start(CONNECTION_THRESHOLD_SAMPLING_INTERVAL);
+	if (rv != CONNECTION_ERROR_NONE) {
+		CONNECTION_MUTEX_LOCK;
+		threshold_list = g_slist_remove(threshold_list, entry);
+		g_atomic_int_dec_and_test(&threshold_counts[device_type]);
+		CONNECTION_MUTEX_UNLOCK;
+
+		g_free(entry);
+		return rv;
+	}
+
+	*threshold_id = entry->id;
+
+	CONNECTION_LOG(CONNECTION_INFO, "Threshold %d: %llu bytes, armed %d\n",
+			entry->id, threshold, entry->armed);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+int _connection_threshold_remove(int threshold_id)
+{
+	struct _threshold_s *entry = NULL;
+	GSList *list;
+
+	CONNECTION_MUTEX_LOCK;
+
+	for (list = threshold_list; list; list = list->next) {
+		if (((struct _threshold_s *)list->data)->id == threshold_id) {
+			entry = list->data;
+			break;
+		}
+	}
+
+	if (entry == NULL) {
+		CONNECTION_MUTEX_UNLOCK;
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+	}
+
+	threshold_list = g_slist_remove(threshold_list, entry);
+	g_atomic_int_dec_and_test(&threshold_counts[entry->device_type]);
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	g_free(entry);
+	_connection_sampler_stop(CONNECTION_THRESHOLD_SAMPLING_INTERVAL);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+bool _connection_threshold_is_set(net_device_t device_type)
+{
+	if (device_type <= NET_DEVICE_UNKNOWN || device_type >= NET_DEVICE_MAX)
+		return false;
+
+	return g_atomic_int_get(&threshold_counts[device_type]) > 0;
+}
+
+void _connection_threshold_check(net_device_t device_type, const connection_statistics_counter_s *counter)
+{
+	struct _threshold_event_s *events = NULL;
+	int event_count = 0;
+	GSList *list;
+	int i;
+
+	CONNECTION_MUTEX_LOCK;
+
+	for (list = threshold_list; list; list = list->next) {
+		struct _threshold_s *entry = list->data;
+		unsigned long long size;
+
+		if (entry->device_type != device_type)
+			continue;
+
+		size = __threshold_get_size(counter, entry->statistics_type);
+
+		if (size < entry->threshold) {
+			/* The counter was reset below the threshold */
+			entry->armed = true;
+			continue;
+		}
+
+		if (!entry->armed)
+			continue;
+
+		entry->armed = false;
+
+		events = g_renew(struct _threshold_event_s, events, event_count + 1);
+		events[event_count].connection_type = entry->connection_type;
+		events[event_count].statistics_type = entry->statistics_type;
+		events[event_count].size = size;
+		events[event_count].callback = entry->callback;
+		events[event_count].user_data = entry->user_data;
+		event_count++;
+	}
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	/* Callbacks run without the lock, so they may remove their threshold */
+	for (i = 0; i < event_count; i++) {
+		CONNECTION_LOG(CONNECTION_INFO, "Threshold crossed: %llu bytes\n", events[i].size);
+		events[i].callback(events[i].connection_type, events[i].statistics_type,
+				(long long)events[i].size, events[i].user_data);
+	}
+
+	g_free(events);
+}
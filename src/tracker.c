@@ -0,0 +1,635 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+#define TRACKER_FIELD_MAX 9
+
+struct _tracker_entry_s {
+	net_profile_info_t info;
+	unsigned long long added;
+	unsigned long long changed;
+	unsigned long long removed;
+	unsigned long long field_generation[TRACKER_FIELD_MAX];
+};
+
+static GHashTable *tracker_table = NULL;
+/* ESSID to the list of the Wi-Fi entries using it */
+static GHashTable *tracker_essid_index = NULL;
+/* Lower case BSSID to the Wi-Fi entry */
+static GHashTable *tracker_bssid_index = NULL;
+static bool tracker_primed = false;
+static int tracker_removed_count = 0;
+static unsigned long long tracker_generation = 0;
+/* Changes before this generation may have been forgotten */
+static unsigned long long tracker_horizon = 0;
+
+
+static net_dev_info_t *__tracker_get_net_info(net_profile_info_t *profile_info)
+{
+	switch (profile_info->profile_type) {
+	case NET_DEVICE_CELLULAR:
+		return &profile_info->ProfileInfo.Pdp.net_info;
+	case NET_DEVICE_WIFI:
+		return &profile_info->ProfileInfo.Wlan.net_info;
+	case NET_DEVICE_ETHERNET:
+		return &profile_info->ProfileInfo.Ethernet.net_info;
+	default:
+		return NULL;
+	}
+}
+
+/* Must be called with the lock held */
+static void __tracker_index(struct _tracker_entry_s *entry)
+{
+	net_wifi_profile_info_t *wlan = &entry->info.ProfileInfo.Wlan;
+	GSList *entries;
+
+	if (entry->info.profile_type != NET_DEVICE_WIFI)
+		return;
+
+	if (wlan->essid[0] != '\0') {
+		entries = g_hash_table_lookup(tracker_essid_index, wlan->essid);
+		entries = g_slist_prepend(entries, entry);
+		g_hash_table_insert(tracker_essid_index, g_strdup(wlan->essid), entries);
+	}
+
+	if (wlan->bssid[0] != '\0')
+		g_hash_table_insert(tracker_bssid_index, g_ascii_strdown(wlan->bssid, -1), entry);
+}
+
+/* Must be called with the lock held */
+static void __tracker_unindex(struct _tracker_entry_s *entry)
+{
+	net_wifi_profile_info_t *wlan = &entry->info.ProfileInfo.Wlan;
+	GSList *entries;
+	gchar *bssid;
+
+	if (entry->info.profile_type != NET_DEVICE_WIFI)
+		return;
+
+	if (wlan->essid[0] != '\0') {
+		entries = g_hash_table_lookup(tracker_essid_index, wlan->essid);
+		entries = g_slist_remove(entries, entry);
+		if (entries)
+			g_hash_table_insert(tracker_essid_index, g_strdup(wlan->essid), entries);
+		else
+			g_hash_table_remove(tracker_essid_index, wlan->essid);
+	}
+
+	if (wlan->bssid[0] != '\0') {
+		/* Another profile may have taken the BSSID over */
+		bssid = g_ascii_strdown(wlan->bssid, -1);
+		if (g_hash_table_lookup(tracker_bssid_index, bssid) == entry)
+			g_hash_table_remove(tracker_bssid_index, bssid);
+		g_free(bssid);
+	}
+}
+
+#define TRACKER_DIFFERS(a, b, member) \
+	(memcmp(&(a)->member, &(b)->member, sizeof((a)->member)) != 0)
+
+static unsigned int __tracker_compare(net_profile_info_t *before, net_profile_info_t *after)
+{
+	net_dev_info_t *net_before = __tracker_get_net_info(before);
+	net_dev_info_t *net_after = __tracker_get_net_info(after);
+	unsigned int fields = 0;
+
+	if (memcmp(before, after, sizeof(net_profile_info_t)) == 0)
+		return 0;
+
+	if (before->ProfileState != after->ProfileState)
+		fields |= CONNECTION_PROFILE_FIELD_STATE;
+
+	if (before->profile_type != after->profile_type || net_before == NULL || net_after == NULL)
+		return fields | CONNECTION_PROFILE_FIELD_OTHER;
+
+	if (TRACKER_DIFFERS(net_before, net_after, DevName))
+		fields |= CONNECTION_PROFILE_FIELD_INTERFACE;
+
+	if (net_before->IpConfigType != net_after->IpConfigType ||
+	    TRACKER_DIFFERS(net_before, net_after, IpAddr) ||
+	    net_before->BNetmask != net_after->BNetmask ||
+	    TRACKER_DIFFERS(net_before, net_after, SubnetMask) ||
+	    net_before->BDefGateway != net_after->BDefGateway ||
+	    TRACKER_DIFFERS(net_before, net_after, GatewayAddr))
+		fields |= CONNECTION_PROFILE_FIELD_IP_ADDRESS;
+
+	if (net_before->DnsCount != net_after->DnsCount ||
+	    TRACKER_DIFFERS(net_before, net_after, DnsAddr))
+		fields |= CONNECTION_PROFILE_FIELD_DNS;
+
+	if (net_before->ProxyMethod != net_after->ProxyMethod ||
+	    TRACKER_DIFFERS(net_before, net_after, ProxyAddr))
+		fields |= CONNECTION_PROFILE_FIELD_PROXY;
+
+	if (before->profile_type == NET_DEVICE_WIFI) {
+		net_wifi_profile_info_t *wlan_before = &before->ProfileInfo.Wlan;
+		net_wifi_profile_info_t *wlan_after = &after->ProfileInfo.Wlan;
+
+		if (wlan_before->Strength != wlan_after->Strength ||
+		    wlan_before->frequency != wlan_after->frequency ||
+		    wlan_before->max_rate != wlan_after->max_rate)
+			fields |= CONNECTION_PROFILE_FIELD_WIFI_SIGNAL;
+
+		if (wlan_before->PassphraseRequired != wlan_after->PassphraseRequired ||
+		    TRACKER_DIFFERS(wlan_before, wlan_after, security_info))
+			fields |= CONNECTION_PROFILE_FIELD_WIFI_SECURITY;
+	} else if (before->profile_type == NET_DEVICE_CELLULAR) {
+		net_pdp_profile_info_t *pdp_before = &before->ProfileInfo.Pdp;
+		net_pdp_profile_info_t *pdp_after = &after->ProfileInfo.Pdp;
+
+		if (pdp_before->ServiceType != pdp_after->ServiceType ||
+		    pdp_before->Roaming != pdp_after->Roaming ||
+		    TRACKER_DIFFERS(pdp_before, pdp_after, Apn) ||
+		    TRACKER_DIFFERS(pdp_before, pdp_after, AuthInfo) ||
+		    TRACKER_DIFFERS(pdp_before, pdp_after, HomeURL))
+			fields |= CONNECTION_PROFILE_FIELD_CELLULAR;
+	}
+
+	/* Something else changed, such as the MAC address or the favourite flag */
+	if (fields == 0)
+		fields = CONNECTION_PROFILE_FIELD_OTHER;
+
+	return fields;
+}
+
+static void __tracker_set_fields(struct _tracker_entry_s *entry, unsigned int fields,
+		unsigned long long generation)
+{
+	int i;
+
+	for (i = 0; i < TRACKER_FIELD_MAX; i++)
+		if (fields & (1 << i))
+			entry->field_generation[i] = generation;
+
+	entry->changed = generation;
+}
+
+/* Must be called with the lock held */
+static bool __tracker_store(net_profile_info_t *profile_info, unsigned long long generation)
+{
+	struct _tracker_entry_s *entry;
+	unsigned int fields;
+
+	entry = g_hash_table_lookup(tracker_table, profile_info->ProfileName);
+	if (entry == NULL) {
+		entry = g_try_malloc0(sizeof(struct _tracker_entry_s));
+		if (entry == NULL)
+			return false;
+
+		memcpy(&entry->info, profile_info, sizeof(net_profile_info_t));
+		entry->added = generation;
+		entry->changed = generation;
+		g_hash_table_insert(tracker_table, entry->info.ProfileName, entry);
+		__tracker_index(entry);
+		return true;
+	}
+
+	if (entry->removed) {
+		/* The profile came back: it is new to whoever saw it go */
+		memcpy(&entry->info, profile_info, sizeof(net_profile_info_t));
+		memset(entry->field_generation, 0, sizeof(entry->field_generation));
+		entry->added = generation;
+		entry->changed = generation;
+		entry->removed = 0;
+		tracker_removed_count--;
+		__tracker_index(entry);
+		return true;
+	}
+
+	fields = __tracker_compare(&entry->info, profile_info);
+	if (fields == 0)
+		return false;
+
+	__tracker_unindex(entry);
+	memcpy(&entry->info, profile_info, sizeof(net_profile_info_t));
+	__tracker_index(entry);
+	__tracker_set_fields(entry, fields, generation);
+
+	return true;
+}
+
+/* Must be called with the lock held */
+static void __tracker_prune(void)
+{
+	struct _tracker_entry_s *oldest;
+	GHashTableIter iter;
+	gpointer value;
+
+	while (tracker_removed_count > CONNECTION_TRACKER_REMOVED_MAX) {
+		oldest = NULL;
+
+		g_hash_table_iter_init(&iter, tracker_table);
+		while (g_hash_table_iter_next(&iter, NULL, &value)) {
+			struct _tracker_entry_s *entry = value;
+
+			if (entry->removed && (oldest == NULL || entry->removed < oldest->removed))
+				oldest = entry;
+		}
+
+		if (tracker_horizon < oldest->removed)
+			tracker_horizon = oldest->removed;
+
+		g_hash_table_remove(tracker_table, oldest->info.ProfileName);
+		tracker_removed_count--;
+	}
+}
+
+/* Must be called with the lock held */
+static void __tracker_sync(net_profile_info_t *profiles, int count)
+{
+	unsigned long long generation = tracker_generation + 1;
+	bool changed = false;
+	GHashTable *present;
+	GHashTableIter iter;
+	gpointer value;
+	int i;
+
+	present = g_hash_table_new(g_str_hash, g_str_equal);
+
+	for (i = 0; i < count; i++) {
+		if (__tracker_store(&profiles[i], generation))
+			changed = true;
+
+		g_hash_table_insert(present, profiles[i].ProfileName, &profiles[i]);
+	}
+
+	g_hash_table_iter_init(&iter, tracker_table);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		struct _tracker_entry_s *entry = value;
+
+		if (entry->removed || g_hash_table_lookup(present, entry->info.ProfileName))
+			continue;
+
+		__tracker_unindex(entry);
+		entry->removed = generation;
+		tracker_removed_count++;
+		changed = true;
+	}
+
+	g_hash_table_destroy(present);
+
+	if (changed) {
+		tracker_generation = generation;
+		__tracker_prune();
+	}
+}
+
+static int __tracker_load(net_profile_info_t **profiles, int *count)
+{
+	net_device_t device_types[] = {NET_DEVICE_WIFI, NET_DEVICE_CELLULAR, NET_DEVICE_ETHERNET};
+	GArray *profile_array;
+	guint i;
+
+	/* Changes are only seen through the events of the daemon */
+	if (_connection_libnet_register() != CONNECTION_ERROR_NONE)
+		return CONNECTION_ERROR_OPERATION_FAILED;
+
+	profile_array = g_array_new(FALSE, FALSE, sizeof(net_profile_info_t));
+
+	for (i = 0; i < G_N_ELEMENTS(device_types); i++) {
+		net_profile_info_t *device_profiles = NULL;
+		int device_count = 0;
+		int rv;
+
+		rv = net_get_profile_list(device_types[i], &device_profiles, &device_count);
+		if (rv != NET_ERR_NO_SERVICE && rv != NET_ERR_NONE) {
+			g_array_free(profile_array, TRUE);
+			return CONNECTION_ERROR_OPERATION_FAILED;
+		}
+
+		if (device_count > 0) {
+			g_array_append_vals(profile_array, device_profiles, device_count);
+			g_free(device_profiles);
+		}
+	}
+
+	*count = profile_array->len;
+	*profiles = (net_profile_info_t *)g_array_free(profile_array, FALSE);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+/* The first query reads the whole list, the events keep it up to date afterwards */
+static int __tracker_prime(void)
+{
+	net_profile_info_t *profiles = NULL;
+	int count = 0;
+	bool primed;
+	int rv;
+
+	CONNECTION_MUTEX_LOCK;
+	primed = tracker_primed;
+	CONNECTION_MUTEX_UNLOCK;
+
+	if (primed)
+		return CONNECTION_ERROR_NONE;
+
+	rv = __tracker_load(&profiles, &count);
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	CONNECTION_MUTEX_LOCK;
+
+	if (!tracker_primed) {
+		if (tracker_table == NULL) {
+			tracker_table = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+			tracker_essid_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+			tracker_bssid_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+		}
+
+		__tracker_sync(profiles, count);
+		tracker_horizon = tracker_generation;
+		tracker_primed = true;
+	}
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	g_free(profiles);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+static bool __tracker_get_change(struct _tracker_entry_s *entry, unsigned long long generation,
+		connection_profile_change_type_e *type, unsigned int *fields)
+{
+	int i;
+
+	*fields = 0;
+
+	if (entry->removed) {
+		if (generation == 0 || entry->added > generation || entry->removed <= generation)
+			return false;
+
+		*type = CONNECTION_PROFILE_CHANGE_REMOVED;
+		return true;
+	}
+
+	if (generation == 0 || entry->added > generation) {
+		*type = CONNECTION_PROFILE_CHANGE_ADDED;
+		*fields = CONNECTION_PROFILE_FIELD_ALL;
+		return true;
+	}
+
+	if (entry->changed <= generation)
+		return false;
+
+	for (i = 0; i < TRACKER_FIELD_MAX; i++)
+		if (entry->field_generation[i] > generation)
+			*fields |= (1 << i);
+
+	*type = CONNECTION_PROFILE_CHANGE_CHANGED;
+	return true;
+}
+
+int _connection_tracker_get_changes(unsigned long long since_generation, unsigned long long *generation,
+		connection_profile_change_s **changes, int *count)
+{
+	GArray *change_array;
+	GHashTableIter iter;
+	gpointer value;
+	int rv = CONNECTION_ERROR_NONE;
+
+	rv = __tracker_prime();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	change_array = g_array_new(FALSE, FALSE, sizeof(connection_profile_change_s));
+
+	CONNECTION_MUTEX_LOCK;
+
+	if (since_generation > tracker_generation) {
+		rv = CONNECTION_ERROR_INVALID_PARAMETER;
+	} else if (since_generation > 0 && since_generation < tracker_horizon) {
+		CONNECTION_LOG(CONNECTION_WARN, "Generation %llu is too old, the oldest is %llu\n",
+				since_generation, tracker_horizon);
+		rv = CONNECTION_ERROR_INVALID_OPERATION;
+	} else {
+		g_hash_table_iter_init(&iter, tracker_table);
+		while (g_hash_table_iter_next(&iter, NULL, &value)) {
+			struct _tracker_entry_s *entry = value;
+			connection_profile_change_s change;
+
+			if (!__tracker_get_change(entry, since_generation, &change.type, &change.changed_fields))
+				continue;
+
+			change.profile_name = g_strdup(entry->info.ProfileName);
+			change.profile = NULL;
+
+			if (change.type != CONNECTION_PROFILE_CHANGE_REMOVED) {
+				change.profile = _connection_libnet_new_profile(&entry->info, CONNECTION_MEMORY_PROFILE);
+				if (change.profile == NULL) {
+					g_free(change.profile_name);
+					rv = CONNECTION_ERROR_OUT_OF_MEMORY;
+					break;
+				}
+			}
+
+			g_array_append_val(change_array, change);
+		}
+
+		*generation = tracker_generation;
+	}
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	if (rv != CONNECTION_ERROR_NONE) {
+		int change_count = change_array->len;
+
+		_connection_tracker_free_changes((connection_profile_change_s *)g_array_free(change_array, FALSE),
+				change_count);
+		return rv;
+	}
+
+	*count = change_array->len;
+	*changes = (connection_profile_change_s *)g_array_free(change_array, FALSE);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+void _connection_tracker_free_changes(connection_profile_change_s *changes, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		g_free(changes[i].profile_name);
+		if (changes[i].profile)
+			_connection_libnet_unref_profile(changes[i].profile);
+	}
+
+	g_free(changes);
+}
+
+static bool __tracker_is_connected(net_profile_info_t *profile_info)
+{
+	return profile_info->ProfileState == NET_STATE_TYPE_ONLINE ||
+			profile_info->ProfileState == NET_STATE_TYPE_READY;
+}
+
+/* Must be called with the lock held */
+static struct _tracker_entry_s *__tracker_find_essid(const char *essid)
+{
+	struct _tracker_entry_s *best = NULL;
+	GSList *list;
+
+	/* Several profiles may share an ESSID: prefer the connected one, then the strongest */
+	for (list = g_hash_table_lookup(tracker_essid_index, essid); list; list = list->next) {
+		struct _tracker_entry_s *entry = list->data;
+
+		if (best == NULL) {
+			best = entry;
+			continue;
+		}
+
+		if (__tracker_is_connected(&entry->info) != __tracker_is_connected(&best->info)) {
+			if (__tracker_is_connected(&entry->info))
+				best = entry;
+			continue;
+		}
+
+		if (entry->info.ProfileInfo.Wlan.Strength > best->info.ProfileInfo.Wlan.Strength)
+			best = entry;
+	}
+
+	return best;
+}
+
+int _connection_tracker_find_profile(connection_tracker_key_e key_type, const char *key,
+		connection_profile_h *profile)
+{
+	struct _tracker_entry_s *entry = NULL;
+	gchar *bssid;
+	int rv;
+
+	rv = __tracker_prime();
+	if (rv != CONNECTION_ERROR_NONE)
+		return rv;
+
+	CONNECTION_MUTEX_LOCK;
+
+	switch (key_type) {
+	case CONNECTION_TRACKER_KEY_NAME:
+		entry = g_hash_table_lookup(tracker_table, key);
+		break;
+	case CONNECTION_TRACKER_KEY_ESSID:
+		entry = __tracker_find_essid(key);
+		break;
+	case CONNECTION_TRACKER_KEY_BSSID:
+		bssid = g_ascii_strdown(key, -1);
+		entry = g_hash_table_lookup(tracker_bssid_index, bssid);
+		g_free(bssid);
+		break;
+	}
+
+	if (entry == NULL || entry->removed) {
+		CONNECTION_MUTEX_UNLOCK;
+		return CONNECTION_ERROR_NO_CONNECTION;
+	}
+
+	*profile = _connection_libnet_new_profile(&entry->info, CONNECTION_MEMORY_PROFILE);
+
+	CONNECTION_MUTEX_UNLOCK;
+
+	if (*profile == NULL)
+		return CONNECTION_ERROR_OUT_OF_MEMORY;
+
+	_connection_libnet_add_to_profile_list(*profile);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+void _connection_tracker_update(const char *profile_name, net_profile_info_t *profile_info,
+		connection_profile_state_e state)
+{
+	struct _tracker_entry_s *entry;
+	net_profile_info_t updated;
+
+	CONNECTION_MUTEX_LOCK;
+
+	if (!tracker_primed) {
+		CONNECTION_MUTEX_UNLOCK;
+		return;
+	}
+
+	if (profile_info) {
+		if (__tracker_store(profile_info, tracker_generation + 1))
+			tracker_generation++;
+
+		CONNECTION_MUTEX_UNLOCK;
+		return;
+	}
+
+	/* Only the state is known: profiles the tracker has not seen wait for the next refresh */
+	entry = g_hash_table_lookup(tracker_table, profile_name);
+	if (entry && !entry->removed && (int)state >= 0) {
+		memcpy(&updated, &entry->info, sizeof(net_profile_info_t));
+		updated.ProfileState = _connection_profile_convert_to_net_state(state);
+
+		if (__tracker_store(&updated, tracker_generation + 1))
+			tracker_generation++;
+	}
+
+	CONNECTION_MUTEX_UNLOCK;
+}
+
+void _connection_tracker_refresh(void)
+{
+	net_profile_info_t *profiles = NULL;
+	int count = 0;
+	bool primed;
+
+	CONNECTION_MUTEX_LOCK;
+	primed = tracker_primed;
+	CONNECTION_MUTEX_UNLOCK;
+
+	if (!primed)
+		return;
+
+	if (__tracker_load(&profiles, &count) != CONNECTION_ERROR_NONE)
+		return;
+
+	CONNECTION_MUTEX_LOCK;
+	if (tracker_primed)
+		__tracker_sync(profiles, count);
+	CONNECTION_MUTEX_UNLOCK;
+
+	g_free(profiles);
+}
+
+/* Must be called with the lock held */
+void _connection_tracker_clear(void)
+{
+	GHashTableIter iter;
+	gpointer value;
+
+	if (tracker_table) {
+		g_hash_table_iter_init(&iter, tracker_essid_index);
+		while (g_hash_table_iter_next(&iter, NULL, &value))
+			g_slist_free(value);
+
+		g_hash_table_remove_all(tracker_essid_index);
+		g_hash_table_remove_all(tracker_bssid_index);
+		g_hash_table_remove_all(tracker_table);
+	}
+
+	tracker_primed = false;
+	tracker_removed_count = 0;
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+enum {
+	WARM_START_STATE_UNKNOWN = 0,
+	WARM_START_STATE_OFF,
+	/* The file is served until the first refresh completes */
+	WARM_START_STATE_ARMED,
+	WARM_START_STATE_REFRESHING,
+	WARM_START_STATE_LIVE,
+};
+
+/* Taken after the connection lock, never before */
+static pthread_mutex_t warm_start_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *warm_start_path = NULL;
+static int warm_start_state = WARM_START_STATE_UNKNOWN;
+static void *warm_start_map = NULL;
+static size_t warm_start_map_size = 0;
+/* Iterators being built from the map, which stays until they are done */
+static int warm_start_readers = 0;
+static unsigned int warm_start_saved_hash = 0;
+static GSList *warm_start_callbacks = NULL;
+/* The last refresh, joined before the next one and at the libnet deinit */
+static pthread_t warm_start_thread;
+static bool warm_start_thread_joinable = false;
+static guint warm_start_idle = 0;
+
+
+static unsigned int __warm_start_hash(unsigned int hash, const void *data, size_t length)
+{
+	const unsigned char *bytes = data;
+	size_t i;
+
+	/* FNV-1a */
+	for (i = 0; i < length; i++)
+		hash = (hash ^ bytes[i]) * 16777619U;
+
+	return hash;
+}
+
+/* Must be called with the warm start lock held */
+static void __warm_start_unmap(void)
+{
+	if (warm_start_map && warm_start_readers == 0) {
+		munmap(warm_start_map, warm_start_map_size);
+		warm_start_map = NULL;
+		warm_start_map_size = 0;
+	}
+}
+
+/* Must be called with the warm start lock held */
+static void __warm_start_set_path(const char *path)
+{
+	__warm_start_unmap();
+	g_free(warm_start_path);
+
+	if (path && path[0] != '\0') {
+		warm_start_path = g_strdup(path);
+		warm_start_state = WARM_START_STATE_ARMED;
+	} else {
+		warm_start_path = NULL;
+		warm_start_state = WARM_START_STATE_OFF;
+	}
+
+	warm_start_saved_hash = 0;
+}
+
+/* Must be called with the warm start lock held */
+static void __warm_start_init(void)
+{
+	if (warm_start_state == WARM_START_STATE_UNKNOWN)
+		__warm_start_set_path(getenv(CONNECTION_WARM_START_ENV));
+}
+
+/* Must be called with the warm start lock held */
+static connection_warm_start_header_s *__warm_start_map(void)
+{
+	connection_warm_start_header_s *header;
+	struct stat st;
+	int fd;
+
+	if (warm_start_map)
+		return warm_start_map;
+
+	fd = open(warm_start_path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) < 0 || st.st_size < sizeof(connection_warm_start_header_s)) {
+		close(fd);
+		return NULL;
+	}
+
+	header = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (header == MAP_FAILED)
+		return NULL;
+
+	/* A file of another build or a torn write is ignored */
+	if (header->magic != CONNECTION_WARM_START_MAGIC ||
+	    header->version != CONNECTION_WARM_START_VERSION ||
+	    header->record_size != sizeof(net_profile_info_t) ||
+	    st.st_size != sizeof(connection_warm_start_header_s) +
+			(off_t)header->count * sizeof(net_profile_info_t)) {
+		CONNECTION_LOG(CONNECTION_WARN, "Ignoring warm start file %s\n", warm_start_path);
+		munmap(header, st.st_size);
+		return NULL;
+	}
+
+	warm_start_map = header;
+	warm_start_map_size = st.st_size;
+
+	return header;
+}
+
+static int __warm_start_write(const char *path, int list_count, net_profile_info_t *profiles[], int counts[])
+{
+	connection_warm_start_header_s header;
+	char *temporary;
+	FILE *fp;
+	bool written = true;
+	int i;
+
+	memset(&header, 0, sizeof(header));
+	header.magic = CONNECTION_WARM_START_MAGIC;
+	header.version = CONNECTION_WARM_START_VERSION;
+	header.record_size = sizeof(net_profile_info_t);
+	header.saved_time = (long long)time(NULL);
+
+	for (i = 0; i < list_count; i++)
+		header.count += counts[i];
+
+	/* Readers map the file: replace it, never rewrite it in place */
+	temporary = g_strdup_printf("%s.tmp", path);
+
+	fp = fopen(temporary, "wb");
+	if (fp == NULL) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot open warm start file %s\n", temporary);
+		g_free(temporary);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	written = (fwrite(&header, sizeof(header), 1, fp) == 1);
+
+	for (i = 0; i < list_count && written; i++)
+		if (counts[i] > 0)
+			written = (fwrite(profiles[i], sizeof(net_profile_info_t), counts[i], fp) == counts[i]);
+
+	if (fclose(fp) != 0)
+		written = false;
+
+	if (!written || rename(temporary, path) < 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot write warm start file %s\n", path);
+		unlink(temporary);
+		g_free(temporary);
+		return CONNECTION_ERROR_OPERATION_FAILED;
+	}
+
+	g_free(temporary);
+
+	CONNECTION_LOG(CONNECTION_INFO, "Saved %d profiles to %s\n", header.count, path);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+static gboolean __warm_start_refreshed(gpointer user_data)
+{
+	GSList *callbacks;
+	GSList *list;
+
+	pthread_mutex_lock(&warm_start_mutex);
+	warm_start_idle = 0;
+	callbacks = g_slist_copy(warm_start_callbacks);
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	/* Callbacks run without the lock, so they may unwatch */
+	for (list = callbacks; list; list = list->next)
+		((connection_warm_start_cb)list->data)();
+
+	g_slist_free(callbacks);
+
+	return FALSE;
+}
+
+static void *__warm_start_refresh_thread(void *user_data)
+{
+	net_device_t device_types[3] = {NET_DEVICE_WIFI, NET_DEVICE_CELLULAR, NET_DEVICE_ETHERNET};
+	net_profile_info_t *profiles[3] = {NULL, NULL, NULL};
+	int counts[3] = {0, 0, 0};
+	bool fetched;
+	int i;
+
+	fetched = (_connection_libnet_register() == CONNECTION_ERROR_NONE);
+
+	for (i = 0; i < 3 && fetched; i++) {
+		int rv = net_get_profile_list(device_types[i], &profiles[i], &counts[i]);
+
+		fetched = (rv == NET_ERR_NONE || rv == NET_ERR_NO_SERVICE);
+	}
+
+	if (fetched)
+		_connection_warm_start_save(3, profiles, counts);
+
+	for (i = 0; i < 3; i++)
+		g_free(profiles[i]);
+
+	pthread_mutex_lock(&warm_start_mutex);
+
+	if (warm_start_state == WARM_START_STATE_REFRESHING) {
+		/* On failure the file keeps being served, and the next query retries */
+		warm_start_state = fetched ? WARM_START_STATE_LIVE : WARM_START_STATE_ARMED;
+
+		if (fetched)
+			__warm_start_unmap();
+	}
+
+	/* Under the lock, so the deinit sees the source it has to drop */
+	if (fetched && warm_start_idle == 0)
+		warm_start_idle = g_idle_add(__warm_start_refreshed, NULL);
+
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	return NULL;
+}
+
+/* Must be called with the warm start lock held */
+static void __warm_start_refresh(void)
+{
+	/* Not refreshing: the last thread is past its last use of the lock */
+	if (warm_start_thread_joinable) {
+		pthread_join(warm_start_thread, NULL);
+		warm_start_thread_joinable = false;
+	}
+
+	warm_start_state = WARM_START_STATE_REFRESHING;
+
+	if (pthread_create(&warm_start_thread, NULL, __warm_start_refresh_thread, NULL) != 0) {
+		CONNECTION_LOG(CONNECTION_ERROR, "Cannot start the profile refresh\n");
+		warm_start_state = WARM_START_STATE_ARMED;
+		return;
+	}
+
+	warm_start_thread_joinable = true;
+}
+
+/* Called by the libnet deinit, before it deregisters from the daemon */
+void _connection_warm_start_stop(void)
+{
+	bool joinable;
+
+	pthread_mutex_lock(&warm_start_mutex);
+	joinable = warm_start_thread_joinable;
+	warm_start_thread_joinable = false;
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	/* The refresh takes the warm start lock, never the connection lock */
+	if (joinable)
+		pthread_join(warm_start_thread, NULL);
+
+	pthread_mutex_lock(&warm_start_mutex);
+
+	if (warm_start_idle) {
+		g_source_remove(warm_start_idle);
+		warm_start_idle = 0;
+	}
+
+	pthread_mutex_unlock(&warm_start_mutex);
+}
+
+int _connection_warm_start_set_path(const char *path)
+{
+	pthread_mutex_lock(&warm_start_mutex);
+
+	if (warm_start_state == WARM_START_STATE_REFRESHING || warm_start_readers > 0) {
+		pthread_mutex_unlock(&warm_start_mutex);
+		return CONNECTION_ERROR_INVALID_OPERATION;
+	}
+
+	__warm_start_set_path(path);
+
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	return CONNECTION_ERROR_NONE;
+}
+
+void _connection_warm_start_save(int list_count, net_profile_info_t *profiles[], int counts[])
+{
+	unsigned int hash = 2166136261U;
+	int i;
+
+	pthread_mutex_lock(&warm_start_mutex);
+
+	__warm_start_init();
+
+	if (warm_start_path == NULL) {
+		pthread_mutex_unlock(&warm_start_mutex);
+		return;
+	}
+
+	/* Enumerations mostly repeat themselves: write only what changed */
+	for (i = 0; i < list_count; i++) {
+		hash = __warm_start_hash(hash, &counts[i], sizeof(int));
+		if (counts[i] > 0)
+			hash = __warm_start_hash(hash, profiles[i], counts[i] * sizeof(net_profile_info_t));
+	}
+
+	if (hash != warm_start_saved_hash &&
+	    __warm_start_write(warm_start_path, list_count, profiles, counts) == CONNECTION_ERROR_NONE)
+		warm_start_saved_hash = hash;
+
+	pthread_mutex_unlock(&warm_start_mutex);
+}
+
+int _connection_warm_start_get_iterator(connection_iterator_type_e type,
+		connection_profile_iterator_h *profile_iterator, bool *is_stale)
+{
+	connection_warm_start_header_s *header;
+	int rv;
+
+	if (profile_iterator == NULL || is_stale == NULL)
+		return CONNECTION_ERROR_INVALID_PARAMETER;
+
+	pthread_mutex_lock(&warm_start_mutex);
+
+	__warm_start_init();
+
+	if (warm_start_state != WARM_START_STATE_ARMED && warm_start_state != WARM_START_STATE_REFRESHING) {
+		pthread_mutex_unlock(&warm_start_mutex);
+
+		*is_stale = false;
+		return _connection_libnet_get_profile_iterator(type, profile_iterator);
+	}
+
+	header = __warm_start_map();
+	if (header == NULL) {
+		/* Nothing saved yet: this enumeration will be */
+		warm_start_state = WARM_START_STATE_LIVE;
+		pthread_mutex_unlock(&warm_start_mutex);
+
+		*is_stale = false;
+		return _connection_libnet_get_profile_iterator(type, profile_iterator);
+	}
+
+	if (warm_start_state == WARM_START_STATE_ARMED)
+		__warm_start_refresh();
+
+	warm_start_readers++;
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	/* Building the iterator takes the connection lock */
+	rv = _connection_libnet_new_profile_iterator(type, (net_profile_info_t *)(header + 1),
+			header->count, profile_iterator);
+
+	CONNECTION_LOG(CONNECTION_INFO, "Served %d profiles saved at %lld\n", header->count, header->saved_time);
+
+	pthread_mutex_lock(&warm_start_mutex);
+	warm_start_readers--;
+	if (warm_start_state == WARM_START_STATE_LIVE)
+		__warm_start_unmap();
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	*is_stale = true;
+	return rv;
+}
+
+int _connection_warm_start_watch(connection_warm_start_cb callback)
+{
+	int rv = CONNECTION_ERROR_NONE;
+
+	pthread_mutex_lock(&warm_start_mutex);
+
+	if (g_slist_find(warm_start_callbacks, callback))
+		rv = CONNECTION_ERROR_INVALID_OPERATION;
+	else
+		warm_start_callbacks = g_slist_append(warm_start_callbacks, callback);
+
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	return rv;
+}
+
+int _connection_warm_start_unwatch(connection_warm_start_cb callback)
+{
+	int rv = CONNECTION_ERROR_NONE;
+
+	pthread_mutex_lock(&warm_start_mutex);
+
+	if (g_slist_find(warm_start_callbacks, callback) == NULL)
+		rv = CONNECTION_ERROR_INVALID_OPERATION;
+	else
+		warm_start_callbacks = g_slist_remove(warm_start_callbacks, callback);
+
+	pthread_mutex_unlock(&warm_start_mutex);
+
+	return rv;
+}
@@ -63,6 +63,18 @@ static void test_proxy_changed_callback(const char* ipv4_address, const char* ip
 			ipv4_address, (ipv6_address ? ipv6_address : "NULL"));
 }
 
+static void test_interface_address_changed_callback(const char* interface_name,
+		const char* ipv4_address, const char* ipv6_address, void* user_data)
+{
+	printf("Interface %s address changed callback, IPv4 address : %s, IPv6 address : %s\n",
+			interface_name, ipv4_address, ipv6_address);
+}
+
+static void test_ethernet_state_changed_callback(connection_ethernet_state_e state, void* user_data)
+{
+	printf("Ethernet state changed callback, state : %d\n", state);
+}
+
 static void test_profile_state_callback(connection_profile_h profile, bool is_requested, void* user_data)
 {
 	connection_profile_state_e state;
@@ -170,6 +182,10 @@ int test_register_client(void)
 		connection_set_type_changed_cb(connection, test_state_changed_callback, NULL);
 		connection_set_ip_address_changed_cb(connection, test_ip_changed_callback, NULL);
 		connection_set_proxy_address_changed_cb(connection, test_proxy_changed_callback, NULL);
+		connection_set_interface_address_changed_cb(connection,
+				test_interface_address_changed_callback, NULL);
+		connection_set_ethernet_state_changed_cb(connection,
+				test_ethernet_state_changed_callback, NULL);
 	} else {
 		printf("Client registration failed %d\n", err);
 		return -1;
@@ -0,0 +1,1389 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <glib.h>
+#include "net_connection.h"
+#include "connection_mock.h"
+
+static int failures = 0;
+
+#define TEST_CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			printf("[FAIL] %s:%d: %s\n", __FILE__, __LINE__, #expr); \
+			failures++; \
+		} \
+	} while (0)
+
+static const char *test_profiles[] = {
+	"reset",
+	"profile wifi /wifi/home wlan0 online HomeAP 192.168.0.10 80",
+	"profile wifi /wifi/office wlan0 idle OfficeAP",
+	"profile cellular /context/internet pdp0 idle internet.apn internet",
+	"profile cellular /context/mms pdp1 idle mms.apn mms",
+	"profile ethernet /ethernet/eth0 eth0 idle",
+	"vconf int " VCONFKEY_NETWORK_STATUS " 2",
+	"vconf str " VCONFKEY_NETWORK_IP " 192.168.0.10",
+	NULL,
+};
+
+static connection_type_e changed_type = CONNECTION_TYPE_DISCONNECTED;
+static int changed_count = 0;
+static connection_profile_state_e profile_state = CONNECTION_PROFILE_STATE_DISCONNECTED;
+static int profile_state_count = 0;
+static connection_profile_h profile_state_handle = NULL;
+static connection_ethernet_state_e ethernet_state = CONNECTION_ETHERNET_STATE_DEACTIVATED;
+static int ethernet_state_count = 0;
+static int refreshed_count = 0;
+static int dns_servers_count = 0;
+static int threshold_crossed_count = 0;
+static long long threshold_crossed_size = 0;
+
+static void test_setup(void)
+{
+	int i;
+
+	for (i = 0; test_profiles[i]; i++)
+		TEST_CHECK(connection_mock_run_command(test_profiles[i]) == NET_ERR_NONE);
+
+	connection_mock_dispatch_events();
+}
+
+static void test_type_changed_cb(connection_type_e type, void *user_data)
+{
+	changed_type = type;
+	changed_count++;
+}
+
+static void test_profile_state_changed_cb(connection_profile_h profile, bool is_requested, void *user_data)
+{
+	connection_profile_get_state(profile, &profile_state);
+	profile_state_handle = profile;
+	profile_state_count++;
+}
+
+static void test_ethernet_state_changed_cb(connection_ethernet_state_e state, void *user_data)
+{
+	ethernet_state = state;
+	ethernet_state_count++;
+}
+
+static void test_profile_list_refreshed_cb(void *user_data)
+{
+	refreshed_count++;
+}
+
+static int test_count_profiles(connection_h connection, connection_iterator_type_e type)
+{
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile;
+	int count = 0;
+
+	if (connection_get_profile_iterator(connection, type, &iterator) != CONNECTION_ERROR_NONE)
+		return -1;
+
+	while (connection_profile_iterator_has_next(iterator)) {
+		if (connection_profile_iterator_next(iterator, &profile) != CONNECTION_ERROR_NONE)
+			break;
+		count++;
+	}
+
+	connection_destroy_profile_iterator(iterator);
+
+	return count;
+}
+
+static void test_create_destroy(void)
+{
+	connection_h connection = NULL;
+
+	test_setup();
+
+	/* A handle that never needs the daemon never registers */
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_mock_get_call_count("net_register_client_ext") == 0);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_mock_get_call_count("net_deregister_client_ext") == 0);
+
+	/* The first request registers, once */
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_REGISTERED) > 0);
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_REGISTERED) > 0);
+	TEST_CHECK(connection_mock_get_call_count("net_register_client_ext") == 1);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_mock_get_call_count("net_deregister_client_ext") == 1);
+
+	/* A failed registration fails the request, not the handle, and is retried */
+	connection_mock_set_error("net_register_client_ext", NET_ERR_UNKNOWN);
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_REGISTERED) < 0);
+	connection_mock_set_error("net_register_client_ext", NET_ERR_NONE);
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_REGISTERED) > 0);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_type(void)
+{
+	connection_h connection = NULL;
+	connection_type_e type;
+	char *ip_address = NULL;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_type(connection, &type) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(type == CONNECTION_TYPE_WIFI);
+
+	TEST_CHECK(connection_get_ip_address(connection, CONNECTION_ADDRESS_FAMILY_IPV4, &ip_address) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(ip_address && strcmp(ip_address, "192.168.0.10") == 0);
+	free(ip_address);
+
+	TEST_CHECK(connection_set_type_changed_cb(connection, test_type_changed_cb, NULL) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_mock_run_command("vconf int " VCONFKEY_NETWORK_STATUS " 1") == NET_ERR_NONE);
+
+	/* Notifications are asynchronous, like vconf */
+	TEST_CHECK(changed_count == 0);
+	connection_mock_dispatch_events();
+	TEST_CHECK(changed_count == 1);
+	TEST_CHECK(changed_type == CONNECTION_TYPE_CELLULAR);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_iterator(void)
+{
+	connection_h connection = NULL;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_REGISTERED) == 5);
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_CONNECTED) == 1);
+
+	connection_mock_set_error("net_get_profile_list", NET_ERR_UNKNOWN);
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_REGISTERED) == -1);
+	connection_mock_set_error("net_get_profile_list", NET_ERR_NONE);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_profile_ref(void)
+{
+	connection_h connection = NULL;
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile = NULL;
+	char *name = NULL;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_profile_ref(NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_get_profile_iterator(connection, CONNECTION_ITERATOR_TYPE_REGISTERED,
+			&iterator) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_iterator_next(iterator, &profile) == CONNECTION_ERROR_NONE);
+
+	/* The reference of the iterator is not the application's to release */
+	TEST_CHECK(connection_profile_unref(profile) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+	g_free(name);
+
+	TEST_CHECK(connection_profile_ref(profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_destroy_profile_iterator(iterator) == CONNECTION_ERROR_NONE);
+
+	/* The retained profile outlives its iterator */
+	TEST_CHECK(connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(name != NULL && name[0] != '\0');
+	g_free(name);
+
+	TEST_CHECK(connection_profile_unref(profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_get_name(profile, &name) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_profile_unref(profile) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_profile_clone(void)
+{
+	connection_profile_h profile = NULL;
+	connection_profile_h cloned = NULL;
+	connection_memory_usage_s before;
+	connection_memory_usage_s usage;
+	char *address = NULL;
+
+	TEST_CHECK(connection_profile_create(CONNECTION_PROFILE_TYPE_WIFI, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_set_ip_address(profile, CONNECTION_ADDRESS_FAMILY_IPV4,
+			"192.168.0.10") == CONNECTION_ERROR_NONE);
+
+	/* A clone shares the contents until one side is modified */
+	connection_get_memory_usage(&before);
+	TEST_CHECK(connection_profile_clone(&cloned, profile) == CONNECTION_ERROR_NONE);
+	connection_get_memory_usage(&usage);
+	TEST_CHECK(usage.profiles.count == before.profiles.count + 1);
+	TEST_CHECK(usage.profiles.bytes - before.profiles.bytes < sizeof(net_profile_info_t));
+
+	/* A setter of another profile type fails before copying anything */
+	TEST_CHECK(connection_profile_set_cellular_apn(cloned, "internet") == CONNECTION_ERROR_INVALID_PARAMETER);
+	connection_get_memory_usage(&usage);
+	TEST_CHECK(usage.profiles.bytes - before.profiles.bytes < sizeof(net_profile_info_t));
+
+	TEST_CHECK(connection_profile_get_ip_address(cloned, CONNECTION_ADDRESS_FAMILY_IPV4,
+			&address) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(address != NULL && strcmp(address, "192.168.0.10") == 0);
+	g_free(address);
+
+	TEST_CHECK(connection_profile_set_ip_address(cloned, CONNECTION_ADDRESS_FAMILY_IPV4,
+			"192.168.0.20") == CONNECTION_ERROR_NONE);
+	connection_get_memory_usage(&usage);
+	TEST_CHECK(usage.profiles.bytes - before.profiles.bytes > sizeof(net_profile_info_t));
+
+	TEST_CHECK(connection_profile_get_ip_address(profile, CONNECTION_ADDRESS_FAMILY_IPV4,
+			&address) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(address != NULL && strcmp(address, "192.168.0.10") == 0);
+	g_free(address);
+
+	TEST_CHECK(connection_profile_get_ip_address(cloned, CONNECTION_ADDRESS_FAMILY_IPV4,
+			&address) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(address != NULL && strcmp(address, "192.168.0.20") == 0);
+	g_free(address);
+
+	/* The origin may go first */
+	TEST_CHECK(connection_profile_destroy(profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_destroy(cloned) == CONNECTION_ERROR_NONE);
+}
+
+static connection_profile_change_s *test_find_change(connection_profile_change_s *changes, int count,
+		const char *profile_name)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		if (strcmp(changes[i].profile_name, profile_name) == 0)
+			return &changes[i];
+
+	return NULL;
+}
+
+static void test_profile_changes(void)
+{
+	connection_h connection = NULL;
+	connection_profile_change_s *changes = NULL;
+	connection_profile_change_s *change;
+	connection_profile_h profile = NULL;
+	unsigned long long generation = 0;
+	unsigned long long previous;
+	int count = 0;
+	int i;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_profile_changes(connection, 0, &generation, &changes, &count) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(count == 5);
+	for (i = 0; i < count; i++)
+		TEST_CHECK(changes[i].type == CONNECTION_PROFILE_CHANGE_ADDED && changes[i].profile != NULL);
+	connection_free_profile_changes(changes, count);
+
+	TEST_CHECK(connection_get_profile_changes(connection, generation + 1, &generation,
+			&changes, &count) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	previous = generation;
+	TEST_CHECK(connection_get_profile_changes(connection, previous, &generation, &changes, &count) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(count == 0 && generation == previous);
+	connection_free_profile_changes(changes, count);
+
+	/* A state event changes one field of one profile */
+	connection_mock_run_command("event 0 state_ind /wifi/office association");
+	connection_mock_dispatch_events();
+
+	previous = generation;
+	TEST_CHECK(connection_get_profile_changes(connection, previous, &generation, &changes, &count) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(count == 1 && generation > previous);
+	if (count == 1) {
+		TEST_CHECK(strcmp(changes[0].profile_name, "/wifi/office") == 0);
+		TEST_CHECK(changes[0].type == CONNECTION_PROFILE_CHANGE_CHANGED);
+		TEST_CHECK(changes[0].changed_fields == CONNECTION_PROFILE_FIELD_STATE);
+	}
+	connection_free_profile_changes(changes, count);
+
+	/* A scan brings in new access points */
+	connection_mock_run_command("profile wifi /wifi/cafe wlan0 idle CafeAP");
+	connection_mock_run_command("event 0 scan_ind -");
+	connection_mock_dispatch_events();
+
+	previous = generation;
+	TEST_CHECK(connection_get_profile_changes(connection, previous, &generation, &changes, &count) == CONNECTION_ERROR_NONE);
+	change = test_find_change(changes, count, "/wifi/cafe");
+	TEST_CHECK(count == 1 && change && change->type == CONNECTION_PROFILE_CHANGE_ADDED);
+	connection_free_profile_changes(changes, count);
+
+	/* Profiles added and removed through the library */
+	previous = generation;
+	TEST_CHECK(connection_profile_create(CONNECTION_PROFILE_TYPE_CELLULAR, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_add_profile(connection, profile) == CONNECTION_ERROR_NONE);
+	connection_profile_destroy(profile);
+
+	TEST_CHECK(connection_get_profile_changes(connection, previous, &generation, &changes, &count) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(count == 1 && changes[0].type == CONNECTION_PROFILE_CHANGE_ADDED);
+	if (count == 1) {
+		TEST_CHECK(connection_remove_profile(connection, changes[0].profile) == CONNECTION_ERROR_NONE);
+		connection_free_profile_changes(changes, count);
+	}
+
+	/* The removal is reported against a generation that had the profile */
+	TEST_CHECK(connection_get_profile_changes(connection, generation, &generation, &changes, &count) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(count == 1 && changes[0].type == CONNECTION_PROFILE_CHANGE_REMOVED && changes[0].profile == NULL);
+	connection_free_profile_changes(changes, count);
+
+	TEST_CHECK(connection_get_profile_changes(connection, previous, &generation, &changes, &count) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(count == 0);
+	connection_free_profile_changes(changes, count);
+
+	TEST_CHECK(connection_free_profile_changes(NULL, 1) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_open_close(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	connection_profile_h handle;
+	char *interface_name = NULL;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_open_cellular_service_type(connection,
+			CONNECTION_CELLULAR_SERVICE_TYPE_MMS, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(profile != NULL);
+	if (profile == NULL)
+		return;
+
+	TEST_CHECK(connection_profile_set_state_changed_cb(profile,
+			test_profile_state_changed_cb, NULL) == CONNECTION_ERROR_NONE);
+
+	connection_mock_dispatch_events();
+	TEST_CHECK(profile_state_count == 1);
+	TEST_CHECK(profile_state == CONNECTION_PROFILE_STATE_CONNECTED);
+	handle = profile_state_handle;
+
+	TEST_CHECK(connection_profile_get_network_interface_name(profile, &interface_name) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(interface_name && strcmp(interface_name, "pdp1") == 0);
+	g_free(interface_name);
+
+	TEST_CHECK(connection_close_profile(connection, profile) == CONNECTION_ERROR_NONE);
+	connection_mock_dispatch_events();
+	TEST_CHECK(profile_state_count == 2);
+	TEST_CHECK(profile_state == CONNECTION_PROFILE_STATE_DISCONNECTED);
+	/* The callback is passed the same handle on every change */
+	TEST_CHECK(profile_state_handle == handle);
+
+	/* A scripted failure reaches the callback as a disconnection */
+	connection_mock_run_command("event 0 open_ind /context/mms -999");
+	connection_mock_dispatch_events();
+	TEST_CHECK(profile_state_count == 3);
+	TEST_CHECK(profile_state == CONNECTION_PROFILE_STATE_DISCONNECTED);
+
+	connection_mock_set_error("net_close_connection", NET_ERR_UNKNOWN);
+	TEST_CHECK(connection_close_profile(connection, profile) == CONNECTION_ERROR_OPERATION_FAILED);
+	connection_mock_set_error("net_close_connection", NET_ERR_NONE);
+
+	connection_profile_unset_state_changed_cb(profile);
+	connection_profile_destroy(profile);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_ethernet_state(void)
+{
+	connection_h connection = NULL;
+	connection_ethernet_state_e state;
+	int calls;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_ethernet_state(connection, &state) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(state == CONNECTION_ETHERNET_STATE_DISCONNECTED);
+
+	/* Later reads come from the cache */
+	calls = connection_mock_get_call_count("net_get_profile_list");
+	TEST_CHECK(connection_get_ethernet_state(connection, &state) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_mock_get_call_count("net_get_profile_list") == calls);
+
+	TEST_CHECK(connection_set_ethernet_state_changed_cb(connection, NULL, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_set_ethernet_state_changed_cb(connection,
+			test_ethernet_state_changed_cb, NULL) == CONNECTION_ERROR_NONE);
+
+	connection_mock_run_command("event 0 open_ind /ethernet/eth0");
+	connection_mock_dispatch_events();
+	TEST_CHECK(ethernet_state_count == 1);
+	TEST_CHECK(ethernet_state == CONNECTION_ETHERNET_STATE_CONNECTED);
+	TEST_CHECK(connection_get_ethernet_state(connection, &state) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(state == CONNECTION_ETHERNET_STATE_CONNECTED);
+
+	/* Other profiles leave it alone */
+	connection_mock_run_command("event 0 close_ind /wifi/home");
+	connection_mock_dispatch_events();
+	TEST_CHECK(ethernet_state_count == 1);
+
+	connection_mock_run_command("event 0 close_ind /ethernet/eth0");
+	connection_mock_dispatch_events();
+	TEST_CHECK(ethernet_state_count == 2);
+	TEST_CHECK(ethernet_state == CONNECTION_ETHERNET_STATE_DISCONNECTED);
+	TEST_CHECK(connection_mock_get_call_count("net_get_profile_list") == calls);
+
+	TEST_CHECK(connection_unset_ethernet_state_changed_cb(connection) == CONNECTION_ERROR_NONE);
+	connection_mock_run_command("event 0 open_ind /ethernet/eth0");
+	connection_mock_dispatch_events();
+	TEST_CHECK(ethernet_state_count == 2);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static int test_count_cached_profiles(connection_h connection, bool *is_stale)
+{
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile;
+	int count = 0;
+
+	if (connection_get_cached_profile_iterator(connection, CONNECTION_ITERATOR_TYPE_REGISTERED,
+			&iterator, is_stale) != CONNECTION_ERROR_NONE)
+		return -1;
+
+	while (connection_profile_iterator_next(iterator, &profile) == CONNECTION_ERROR_NONE)
+		count++;
+
+	connection_destroy_profile_iterator(iterator);
+
+	return count;
+}
+
+static void test_warm_start(void)
+{
+	connection_h connection = NULL;
+	char path[] = "/tmp/mock_test_warm_XXXXXX";
+	bool is_stale = true;
+	gint64 deadline;
+	int fd;
+
+	fd = mkstemp(path);
+	TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+	close(fd);
+	unlink(path);
+
+	test_setup();
+	TEST_CHECK(connection_set_warm_start_path(path) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	/* Nothing saved yet: the live list is fetched and saved */
+	TEST_CHECK(test_count_cached_profiles(connection, &is_stale) == 5);
+	TEST_CHECK(!is_stale);
+	TEST_CHECK(access(path, R_OK) == 0);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+
+	/* Next start: the daemon now knows a single profile */
+	TEST_CHECK(connection_mock_run_command("reset") == NET_ERR_NONE);
+	TEST_CHECK(connection_mock_run_command("profile wifi /wifi/home wlan0 online HomeAP") == NET_ERR_NONE);
+	TEST_CHECK(connection_set_warm_start_path(path) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_set_profile_list_refreshed_cb(connection,
+			test_profile_list_refreshed_cb, NULL) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(test_count_cached_profiles(connection, &is_stale) == 5);
+	TEST_CHECK(is_stale);
+
+	deadline = g_get_monotonic_time() + 2 * G_USEC_PER_SEC;
+	while (refreshed_count == 0 && g_get_monotonic_time() < deadline)
+		if (!g_main_context_iteration(NULL, FALSE))
+			usleep(1000);
+
+	TEST_CHECK(refreshed_count == 1);
+	TEST_CHECK(test_count_cached_profiles(connection, &is_stale) == 1);
+	TEST_CHECK(!is_stale);
+
+	/* The refresh saved the live list for the start after */
+	TEST_CHECK(connection_set_warm_start_path(path) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(test_count_cached_profiles(connection, &is_stale) == 1);
+	TEST_CHECK(is_stale);
+
+	deadline = g_get_monotonic_time() + 2 * G_USEC_PER_SEC;
+	while (refreshed_count == 1 && g_get_monotonic_time() < deadline)
+		if (!g_main_context_iteration(NULL, FALSE))
+			usleep(1000);
+
+	TEST_CHECK(connection_unset_profile_list_refreshed_cb(connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+
+	/* The last destroy waits for a refresh in flight, and drops its notification */
+	TEST_CHECK(connection_set_warm_start_path(path) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_set_profile_list_refreshed_cb(connection,
+			test_profile_list_refreshed_cb, NULL) == CONNECTION_ERROR_NONE);
+	connection_mock_set_latency(100000);
+	refreshed_count = 0;
+
+	TEST_CHECK(test_count_cached_profiles(connection, &is_stale) == 1);
+	TEST_CHECK(is_stale);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+	connection_mock_set_latency(0);
+
+	deadline = g_get_monotonic_time() + G_USEC_PER_SEC / 2;
+	while (g_get_monotonic_time() < deadline)
+		if (!g_main_context_iteration(NULL, FALSE))
+			usleep(1000);
+
+	TEST_CHECK(refreshed_count == 0);
+	TEST_CHECK(connection_set_warm_start_path(NULL) == CONNECTION_ERROR_NONE);
+
+	unlink(path);
+}
+
+static void test_main_loop(void)
+{
+	connection_mock_dispatch_events();
+
+	while (g_main_context_iteration(NULL, FALSE))
+		connection_mock_dispatch_events();
+}
+
+/* Runs the main loop until @a count reaches @a expected, or for @a timeout_ms if @a count is NULL */
+static bool test_run_main_loop(int timeout_ms, const int *count, int expected)
+{
+	gint64 deadline = g_get_monotonic_time() + (gint64)timeout_ms * 1000;
+
+	while (g_get_monotonic_time() < deadline) {
+		if (count && *count >= expected)
+			return true;
+
+		connection_mock_dispatch_events();
+		if (!g_main_context_iteration(NULL, FALSE))
+			usleep(10000);
+	}
+
+	return count == NULL || *count >= expected;
+}
+
+/* Sends @a count datagrams of 1 KiB to ourselves over the loopback interface */
+static void test_send_loopback(int count)
+{
+	struct sockaddr_in address;
+	socklen_t length = sizeof(address);
+	char buffer[1024];
+	int fd;
+	int i;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	TEST_CHECK(bind(fd, (struct sockaddr *)&address, sizeof(address)) == 0);
+	TEST_CHECK(getsockname(fd, (struct sockaddr *)&address, &length) == 0);
+
+	memset(buffer, 0, sizeof(buffer));
+	for (i = 0; i < count; i++) {
+		TEST_CHECK(sendto(fd, buffer, sizeof(buffer), 0,
+				(struct sockaddr *)&address, sizeof(address)) == sizeof(buffer));
+		TEST_CHECK(recv(fd, buffer, sizeof(buffer), 0) == sizeof(buffer));
+	}
+
+	close(fd);
+}
+
+/* Publishes the state of test_profiles until the other process is done reading it */
+static int test_state_page_publisher(const char *path, int ready, int proceed)
+{
+	connection_h connection = NULL;
+	char byte;
+
+	connection_mock_reset();
+	test_setup();
+
+	if (connection_set_state_page_path(path) != CONNECTION_ERROR_NONE ||
+	    connection_create(&connection) != CONNECTION_ERROR_NONE)
+		return 1;
+
+	test_main_loop();
+	if (write(ready, "p", 1) != 1 || read(proceed, &byte, 1) != 1)
+		return 1;
+
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_IP " 10.9.8.7");
+	test_main_loop();
+	if (write(ready, "c", 1) != 1 || read(proceed, &byte, 1) != 1)
+		return 1;
+
+	connection_destroy(connection);
+	return 0;
+}
+
+static void test_state_page(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	connection_type_e type;
+	char path[] = "/tmp/mock_test_page_XXXXXX";
+	char *ip_address = NULL;
+	int ready[2], proceed[2];
+	gint64 deadline;
+	pid_t publisher;
+	char byte;
+	int status = -1;
+	int fd;
+
+	fd = mkstemp(path);
+	TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+	close(fd);
+	unlink(path);
+
+	TEST_CHECK(pipe(ready) == 0 && pipe(proceed) == 0);
+
+	publisher = fork();
+	if (publisher == 0)
+		_exit(test_state_page_publisher(path, ready[1], proceed[0]));
+
+	/* This process knows nothing: what it reads comes from the page */
+	TEST_CHECK(connection_mock_run_command("reset") == NET_ERR_NONE);
+	TEST_CHECK(read(ready[0], &byte, 1) == 1);
+
+	TEST_CHECK(connection_set_state_page_path(path) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_set_state_page_path(NULL) == CONNECTION_ERROR_INVALID_OPERATION);
+
+	TEST_CHECK(connection_get_type(connection, &type) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(type == CONNECTION_TYPE_WIFI);
+	TEST_CHECK(connection_get_ip_address(connection, CONNECTION_ADDRESS_FAMILY_IPV4,
+			&ip_address) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(g_strcmp0(ip_address, "192.168.0.10") == 0);
+	free(ip_address);
+
+	TEST_CHECK(connection_get_current_profile(connection, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_destroy(profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(test_count_profiles(connection, CONNECTION_ITERATOR_TYPE_CONNECTED) == 1);
+	TEST_CHECK(connection_mock_get_call_count("vconf_get_int") == 0);
+	TEST_CHECK(connection_mock_get_call_count("net_get_active_net_info") == 0);
+	TEST_CHECK(connection_mock_get_call_count("net_register_client_ext") == 0);
+
+	/* The publisher follows vconf */
+	TEST_CHECK(write(proceed[1], "n", 1) == 1);
+	TEST_CHECK(read(ready[0], &byte, 1) == 1);
+	TEST_CHECK(connection_get_ip_address(connection, CONNECTION_ADDRESS_FAMILY_IPV4,
+			&ip_address) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(g_strcmp0(ip_address, "10.9.8.7") == 0);
+	free(ip_address);
+
+	/* Once it left, this process reads its own state, then takes over */
+	TEST_CHECK(write(proceed[1], "n", 1) == 1);
+	TEST_CHECK(waitpid(publisher, &status, 0) == publisher);
+	TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	TEST_CHECK(connection_get_type(connection, &type) == CONNECTION_ERROR_OPERATION_FAILED);
+
+	deadline = g_get_monotonic_time() + 3 * G_USEC_PER_SEC;
+	while (connection_mock_get_call_count("net_register_client_ext") == 0 &&
+	       g_get_monotonic_time() < deadline) {
+		connection_get_type(connection, &type);
+		test_main_loop();
+		usleep(10000);
+	}
+
+	TEST_CHECK(connection_mock_get_call_count("net_register_client_ext") == 1);
+	TEST_CHECK(connection_get_type(connection, &type) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(type == CONNECTION_TYPE_DISCONNECTED);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_set_state_page_path(NULL) == CONNECTION_ERROR_NONE);
+
+	close(ready[0]);
+	close(ready[1]);
+	close(proceed[0]);
+	close(proceed[1]);
+	unlink(path);
+}
+
+static void test_snapshot(void)
+{
+	connection_h connection = NULL;
+	connection_snapshot_s snapshot;
+	unsigned int version;
+	int vconf_calls;
+	int daemon_calls;
+	int i;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_snapshot(connection, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_get_snapshot(connection, &snapshot) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(snapshot.type == CONNECTION_TYPE_WIFI);
+	TEST_CHECK(strcmp(snapshot.ip_address, "192.168.0.10") == 0);
+	TEST_CHECK(snapshot.has_profile);
+	TEST_CHECK(snapshot.profile_type == CONNECTION_PROFILE_TYPE_WIFI);
+	TEST_CHECK(snapshot.profile_state == CONNECTION_PROFILE_STATE_CONNECTED);
+	TEST_CHECK(strcmp(snapshot.profile_name, "/wifi/home") == 0);
+	TEST_CHECK(strcmp(snapshot.interface_name, "wlan0") == 0);
+	TEST_CHECK(snapshot.ethernet_state == CONNECTION_ETHERNET_STATE_DISCONNECTED);
+
+	/* Later reads ask nobody */
+	version = snapshot.version;
+	vconf_calls = connection_mock_get_call_count("vconf_get_int");
+	daemon_calls = connection_mock_get_call_count("net_get_active_net_info");
+
+	for (i = 0; i < 1000; i++)
+		TEST_CHECK(connection_get_snapshot(connection, &snapshot) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(snapshot.version == version);
+	TEST_CHECK(connection_mock_get_call_count("vconf_get_int") == vconf_calls);
+	TEST_CHECK(connection_mock_get_call_count("net_get_active_net_info") == daemon_calls);
+
+	/* The event handlers keep it up to date */
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_IP " 10.1.1.1");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_STATUS " 0");
+	test_main_loop();
+	TEST_CHECK(connection_get_snapshot(connection, &snapshot) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(snapshot.version != version);
+	TEST_CHECK(snapshot.type == CONNECTION_TYPE_DISCONNECTED);
+	TEST_CHECK(strcmp(snapshot.ip_address, "10.1.1.1") == 0);
+	TEST_CHECK(connection_mock_get_call_count("vconf_get_int") == vconf_calls);
+
+	connection_mock_run_command("event 0 close_ind /wifi/home");
+	connection_mock_run_command("event 0 open_ind /ethernet/eth0");
+	test_main_loop();
+	TEST_CHECK(connection_get_snapshot(connection, &snapshot) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(snapshot.ethernet_state == CONNECTION_ETHERNET_STATE_CONNECTED);
+	TEST_CHECK(snapshot.has_profile);
+	TEST_CHECK(snapshot.profile_type == CONNECTION_PROFILE_TYPE_ETHERNET);
+	TEST_CHECK(strcmp(snapshot.interface_name, "eth0") == 0);
+
+	connection_mock_run_command("event 0 close_ind /ethernet/eth0");
+	test_main_loop();
+	TEST_CHECK(connection_get_snapshot(connection, &snapshot) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(!snapshot.has_profile);
+	TEST_CHECK(snapshot.ethernet_state == CONNECTION_ETHERNET_STATE_DISCONNECTED);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+
+	/* Once the last handle is gone, a stale one does not load the state again */
+	TEST_CHECK(connection_get_snapshot(connection, &snapshot) == CONNECTION_ERROR_INVALID_PARAMETER);
+}
+
+static void test_proxy_endpoint(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	connection_proxy_endpoint_s endpoint;
+	int vconf_calls;
+
+	test_setup();
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_proxy_endpoint(connection, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_get_proxy_endpoint(connection, &endpoint) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(endpoint.type == CONNECTION_PROXY_TYPE_DIRECT);
+	TEST_CHECK(endpoint.host[0] == '\0' && endpoint.port == 0);
+
+	/* Parsed when the key changes, not when read */
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_PROXY " http://10.0.0.1:3128/");
+	test_main_loop();
+	vconf_calls = connection_mock_get_call_count("vconf_get_str");
+	TEST_CHECK(connection_get_proxy_endpoint(connection, &endpoint) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(endpoint.type == CONNECTION_PROXY_TYPE_MANUAL);
+	TEST_CHECK(strcmp(endpoint.host, "10.0.0.1") == 0);
+	TEST_CHECK(endpoint.port == 3128);
+	TEST_CHECK(connection_mock_get_call_count("vconf_get_str") == vconf_calls);
+
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_PROXY " [fe80::1]:8080");
+	test_main_loop();
+	TEST_CHECK(connection_get_proxy_endpoint(connection, &endpoint) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(strcmp(endpoint.host, "fe80::1") == 0);
+	TEST_CHECK(endpoint.port == 8080);
+
+	connection_mock_run_command("vconf str " VCONFKEY_NETWORK_PROXY " proxy.example.com:http");
+	test_main_loop();
+	TEST_CHECK(connection_get_proxy_endpoint(connection, &endpoint) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(strcmp(endpoint.host, "proxy.example.com") == 0);
+	TEST_CHECK(endpoint.port == 0);
+
+	/* The type follows the current profile */
+	TEST_CHECK(connection_get_current_profile(connection, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_set_proxy_type(profile, CONNECTION_PROXY_TYPE_AUTO) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_update_profile(connection, profile) == CONNECTION_ERROR_NONE);
+	connection_profile_destroy(profile);
+	connection_mock_run_command("event 0 open_ind /wifi/home");
+	test_main_loop();
+	TEST_CHECK(connection_get_proxy_endpoint(connection, &endpoint) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(endpoint.type == CONNECTION_PROXY_TYPE_AUTO);
+	TEST_CHECK(strcmp(endpoint.host, "proxy.example.com") == 0);
+
+	TEST_CHECK(vconf_set_str(VCONFKEY_NETWORK_PROXY, "") == 0);
+	test_main_loop();
+	TEST_CHECK(connection_get_proxy_endpoint(connection, &endpoint) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(endpoint.type == CONNECTION_PROXY_TYPE_DIRECT);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_dns_servers_changed_cb(const connection_dns_servers_s *servers, void *user_data)
+{
+	memcpy(user_data, servers, sizeof(connection_dns_servers_s));
+	dns_servers_count++;
+}
+
+static void test_dns_servers(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	connection_dns_servers_s servers;
+	connection_dns_servers_s changed;
+	int daemon_calls;
+
+	test_setup();
+	dns_servers_count = 0;
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_dns_servers(connection, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_get_dns_servers(connection, &servers) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(servers.count == 0);
+	TEST_CHECK(connection_set_dns_servers_changed_cb(connection, NULL, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_set_dns_servers_changed_cb(connection, test_dns_servers_changed_cb,
+			&changed) == CONNECTION_ERROR_NONE);
+
+	/* Every entry at once, the empty one left out */
+	TEST_CHECK(connection_get_current_profile(connection, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_set_dns_address(profile, 2, CONNECTION_ADDRESS_FAMILY_IPV4,
+			"8.8.4.4") == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_profile_get_dns_servers(profile, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_profile_get_dns_servers(profile, &servers) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(servers.count == 1);
+	TEST_CHECK(servers.servers[0].address_family == CONNECTION_ADDRESS_FAMILY_IPV4);
+	TEST_CHECK(memcmp(servers.servers[0].address, "\x08\x08\x04\x04", 4) == 0);
+
+	TEST_CHECK(connection_profile_set_dns_address(profile, 1, CONNECTION_ADDRESS_FAMILY_IPV4,
+			"8.8.8.8") == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_update_profile(connection, profile) == CONNECTION_ERROR_NONE);
+	connection_profile_destroy(profile);
+	TEST_CHECK(dns_servers_count == 0);
+
+	/* The active set is compared when the current profile changes */
+	connection_mock_run_command("event 0 open_ind /wifi/home");
+	test_main_loop();
+	TEST_CHECK(dns_servers_count == 1);
+	TEST_CHECK(changed.count == 2);
+	TEST_CHECK(memcmp(changed.servers[0].address, "\x08\x08\x08\x08", 4) == 0);
+	TEST_CHECK(memcmp(changed.servers[1].address, "\x08\x08\x04\x04", 4) == 0);
+
+	daemon_calls = connection_mock_get_call_count("net_get_active_net_info");
+	TEST_CHECK(connection_get_dns_servers(connection, &servers) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(memcmp(&servers, &changed, sizeof(servers)) == 0);
+	TEST_CHECK(connection_mock_get_call_count("net_get_active_net_info") == daemon_calls);
+
+	/* The same set again is no change */
+	connection_mock_run_command("event 0 open_ind /wifi/home");
+	test_main_loop();
+	TEST_CHECK(dns_servers_count == 1);
+
+	connection_mock_run_command("event 0 close_ind /wifi/home");
+	test_main_loop();
+	TEST_CHECK(dns_servers_count == 2);
+	TEST_CHECK(changed.count == 0);
+
+	TEST_CHECK(connection_unset_dns_servers_changed_cb(connection) == CONNECTION_ERROR_NONE);
+	connection_mock_run_command("event 0 open_ind /wifi/home");
+	test_main_loop();
+	TEST_CHECK(dns_servers_count == 2);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static int test_prefer_cellular_score(const connection_profile_score_info_s *info, void *user_data)
+{
+	(*(int *)user_data)++;
+
+	return info->type == CONNECTION_PROFILE_TYPE_CELLULAR ? 1 : 0;
+}
+
+static int test_no_score(const connection_profile_score_info_s *info, void *user_data)
+{
+	return -1;
+}
+
+static void test_best_profile(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	connection_memory_usage_s before;
+	connection_memory_usage_s usage;
+	char *name = NULL;
+	int scored = 0;
+
+	test_setup();
+	connection_mock_run_command("profile wifi /wifi/cafe wlan1 online CafeAP 10.0.0.5 90");
+	connection_mock_run_command("profile cellular /context/internet pdp0 online internet.apn internet");
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_best_profile(connection, NULL, NULL, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	/* Wi-Fi by RSSI, and only the winner becomes a handle */
+	connection_get_memory_usage(&before);
+	TEST_CHECK(connection_get_best_profile(connection, NULL, NULL, &profile) == CONNECTION_ERROR_NONE);
+	connection_get_memory_usage(&usage);
+	TEST_CHECK(usage.profiles.count == before.profiles.count + 1);
+	TEST_CHECK(profile && connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(g_strcmp0(name, "/wifi/cafe") == 0);
+	g_free(name);
+	connection_profile_destroy(profile);
+
+	/* Every connected profile goes through the scoring function */
+	TEST_CHECK(connection_get_best_profile(connection, test_prefer_cellular_score, &scored,
+			&profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(scored == 3);
+	TEST_CHECK(profile && connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(g_strcmp0(name, "/context/internet") == 0);
+	g_free(name);
+	connection_profile_destroy(profile);
+
+	TEST_CHECK(connection_get_best_profile(connection, test_no_score, NULL,
+			&profile) == CONNECTION_ERROR_NO_CONNECTION);
+
+	connection_mock_run_command("profile ethernet /ethernet/eth0 eth0 online");
+	TEST_CHECK(connection_get_best_profile(connection, NULL, NULL, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(profile && connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(g_strcmp0(name, "/ethernet/eth0") == 0);
+	g_free(name);
+	connection_profile_destroy(profile);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_profile_name_is(connection_profile_h profile, const char *expected)
+{
+	char *name = NULL;
+
+	TEST_CHECK(profile && connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(g_strcmp0(name, expected) == 0);
+	g_free(name);
+	connection_profile_destroy(profile);
+}
+
+static void test_profile_lookup(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	int calls;
+
+	test_setup();
+	connection_mock_run_command("profile wifi /wifi/home5g wlan0 idle HomeAP 192.168.0.11 95 AA:BB:CC:DD:EE:FF");
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_profile_by_name(connection, NULL, &profile) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_get_wifi_profile_by_essid(connection, "HomeAP", NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	TEST_CHECK(connection_get_profile_by_name(connection, "/wifi/office", &profile) == CONNECTION_ERROR_NONE);
+	test_profile_name_is(profile, "/wifi/office");
+
+	/* Only the first lookup reads the list */
+	calls = connection_mock_get_call_count("net_get_profile_list");
+	TEST_CHECK(connection_get_profile_by_name(connection, "/context/mms", &profile) == CONNECTION_ERROR_NONE);
+	test_profile_name_is(profile, "/context/mms");
+	TEST_CHECK(connection_get_profile_by_name(connection, "/wifi/nowhere", &profile) == CONNECTION_ERROR_NO_CONNECTION);
+	TEST_CHECK(connection_get_wifi_profile_by_bssid(connection, "aa:bb:cc:dd:ee:ff", &profile) == CONNECTION_ERROR_NONE);
+	test_profile_name_is(profile, "/wifi/home5g");
+	TEST_CHECK(connection_mock_get_call_count("net_get_profile_list") == calls);
+
+	/* The connected profile wins over the stronger one, then the stronger one */
+	TEST_CHECK(connection_get_wifi_profile_by_essid(connection, "HomeAP", &profile) == CONNECTION_ERROR_NONE);
+	test_profile_name_is(profile, "/wifi/home");
+
+	connection_mock_run_command("event 0 close_ind /wifi/home");
+	connection_mock_dispatch_events();
+	TEST_CHECK(connection_get_wifi_profile_by_essid(connection, "HomeAP", &profile) == CONNECTION_ERROR_NONE);
+	test_profile_name_is(profile, "/wifi/home5g");
+
+	/* Scans keep the indexes current */
+	connection_mock_run_command("profile wifi /wifi/office wlan0 idle OfficeGuest");
+	connection_mock_run_command("profile wifi /wifi/cafe wlan0 idle CafeAP");
+	connection_mock_run_command("event 0 scan_ind -");
+	connection_mock_dispatch_events();
+
+	TEST_CHECK(connection_get_wifi_profile_by_essid(connection, "OfficeAP", &profile) == CONNECTION_ERROR_NO_CONNECTION);
+	TEST_CHECK(connection_get_wifi_profile_by_essid(connection, "OfficeGuest", &profile) == CONNECTION_ERROR_NONE);
+	test_profile_name_is(profile, "/wifi/office");
+	TEST_CHECK(connection_get_wifi_profile_by_essid(connection, "CafeAP", &profile) == CONNECTION_ERROR_NONE);
+	test_profile_name_is(profile, "/wifi/cafe");
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_wifi_by_strength(void)
+{
+	const char *expected[] = {"/wifi/cafe", "/wifi/home", "/wifi/airport", "/wifi/office"};
+	connection_h connection = NULL;
+	connection_profile_iterator_h iterator = NULL;
+	connection_profile_h profile = NULL;
+	char *name = NULL;
+	int count;
+
+	test_setup();
+	connection_mock_run_command("profile wifi /wifi/cafe wlan0 idle CafeAP 10.0.0.5 90");
+	connection_mock_run_command("profile wifi /wifi/airport wlan0 idle AirportAP 10.0.0.6 40");
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_wifi_profile_iterator_by_strength(connection, -1,
+			&iterator) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	/* Every Wi-Fi profile, from the strongest */
+	TEST_CHECK(connection_get_wifi_profile_iterator_by_strength(connection, 0, &iterator) == CONNECTION_ERROR_NONE);
+	for (count = 0; connection_profile_iterator_next(iterator, &profile) == CONNECTION_ERROR_NONE; count++) {
+		TEST_CHECK(connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+		TEST_CHECK(count < 4 && g_strcmp0(name, expected[count]) == 0);
+		g_free(name);
+	}
+	TEST_CHECK(count == 4);
+	connection_destroy_profile_iterator(iterator);
+
+	/* Only the strongest two */
+	TEST_CHECK(connection_get_wifi_profile_iterator_by_strength(connection, 2, &iterator) == CONNECTION_ERROR_NONE);
+	for (count = 0; connection_profile_iterator_next(iterator, &profile) == CONNECTION_ERROR_NONE; count++) {
+		TEST_CHECK(connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+		TEST_CHECK(count < 2 && g_strcmp0(name, expected[count]) == 0);
+		g_free(name);
+	}
+	TEST_CHECK(count == 2);
+	connection_destroy_profile_iterator(iterator);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_threshold_cb(connection_type_e type, connection_statistics_type_e statistics_type,
+		long long size, void *user_data)
+{
+	threshold_crossed_size = size;
+	threshold_crossed_count++;
+}
+
+static void test_statistics_threshold(void)
+{
+	connection_h connection = NULL;
+	connection_ethernet_state_e state;
+	long long total = 0;
+	int crossed_id = 0;
+	int removed_id = 0;
+
+	test_setup();
+	/* The loopback interface stands in for the ethernet one */
+	connection_mock_run_command("profile ethernet /ethernet/lo lo idle");
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	/* Registered with the daemon, whose open event then names the interface */
+	TEST_CHECK(connection_get_ethernet_state(connection, &state) == CONNECTION_ERROR_NONE);
+	connection_mock_run_command("event 0 open_ind /ethernet/lo");
+	test_main_loop();
+
+	TEST_CHECK(connection_get_statistics(CONNECTION_TYPE_ETHERNET,
+			CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA, &total) == CONNECTION_ERROR_NONE);
+
+	threshold_crossed_count = 0;
+	TEST_CHECK(connection_add_statistics_threshold(CONNECTION_TYPE_ETHERNET,
+			CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA, total + 32 * 1024,
+			test_threshold_cb, NULL, &crossed_id) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_add_statistics_threshold(CONNECTION_TYPE_ETHERNET,
+			CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA, total + 16 * 1024,
+			test_threshold_cb, NULL, &removed_id) == CONNECTION_ERROR_NONE);
+
+	/* A removed threshold does not fire, though it is crossed first */
+	TEST_CHECK(connection_remove_statistics_threshold(removed_id) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_remove_statistics_threshold(removed_id) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	test_send_loopback(64);
+	TEST_CHECK(test_run_main_loop(3000, &threshold_crossed_count, 1));
+	TEST_CHECK(threshold_crossed_size >= total + 32 * 1024);
+
+	/* Crossed once: it stays quiet while the counter stays above it */
+	test_send_loopback(64);
+	test_run_main_loop(1500, NULL, 0);
+	TEST_CHECK(threshold_crossed_count == 1);
+
+	TEST_CHECK(connection_remove_statistics_threshold(crossed_id) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_rate_sampling(void)
+{
+	connection_h connection = NULL;
+	connection_ethernet_state_e state;
+	connection_statistics_rate_s rate;
+	connection_statistics_rate_s recent;
+
+	test_setup();
+	/* The loopback interface stands in for the ethernet one */
+	connection_mock_run_command("profile ethernet /ethernet/lo lo idle");
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_get_ethernet_state(connection, &state) == CONNECTION_ERROR_NONE);
+	connection_mock_run_command("event 0 open_ind /ethernet/lo");
+	test_main_loop();
+
+	TEST_CHECK(connection_get_statistics_rate(CONNECTION_TYPE_ETHERNET, 10, &rate) ==
+			CONNECTION_ERROR_INVALID_OPERATION);
+	TEST_CHECK(connection_start_rate_sampling(50) ==
+			CONNECTION_ERROR_INVALID_PARAMETER);
+
+	/* Two references: the shorter interval is used while both are held */
+	TEST_CHECK(connection_start_rate_sampling(1000) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_start_rate_sampling(200) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_get_statistics_rate(CONNECTION_TYPE_ETHERNET, 0, &rate) ==
+			CONNECTION_ERROR_INVALID_PARAMETER);
+
+	/* A burst of 64 KiB within one interval of at most a second */
+	test_send_loopback(64);
+	test_run_main_loop(500, NULL, 0);
+	TEST_CHECK(connection_get_statistics_rate(CONNECTION_TYPE_ETHERNET, 10, &rate) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(rate.peak_received >= 64 * 1024 * 8);
+	TEST_CHECK(rate.peak_received >= rate.average_received);
+	TEST_CHECK(rate.peak_received >= rate.current_received);
+
+	/* The burst leaves a short window, but not a long one */
+	test_run_main_loop(1500, NULL, 0);
+	TEST_CHECK(connection_get_statistics_rate(CONNECTION_TYPE_ETHERNET, 1, &recent) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_get_statistics_rate(CONNECTION_TYPE_ETHERNET, 10, &rate) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(recent.peak_received < 64 * 1024 * 8);
+	TEST_CHECK(rate.peak_received >= 64 * 1024 * 8);
+	TEST_CHECK(rate.average_received < rate.peak_received);
+
+	/* Each reference is released with its own interval */
+	TEST_CHECK(connection_stop_rate_sampling(200) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_stop_rate_sampling(200) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_get_statistics_rate(CONNECTION_TYPE_ETHERNET, 10, &rate) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_stop_rate_sampling(1000) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_stop_rate_sampling(1000) == CONNECTION_ERROR_INVALID_OPERATION);
+	TEST_CHECK(connection_get_statistics_rate(CONNECTION_TYPE_ETHERNET, 10, &rate) ==
+			CONNECTION_ERROR_INVALID_OPERATION);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_all_statistics(void)
+{
+	connection_h connection = NULL;
+	connection_statistics_info_s statistics;
+
+	test_setup();
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV " 1");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT " 2");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV " 3");
+	connection_mock_run_command("vconf int " VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT " 4");
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_get_all_statistics(NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	/* No cellular interface is up: the values come from vconf, as for connection_get_statistics() */
+	TEST_CHECK(connection_get_all_statistics(&statistics) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(statistics.cellular.is_valid);
+	TEST_CHECK(statistics.cellular.last_received == 1 && statistics.cellular.last_sent == 2);
+	TEST_CHECK(statistics.cellular.total_received == 3 && statistics.cellular.total_sent == 4);
+	TEST_CHECK(statistics.wifi.is_valid);
+
+	/* Nothing to fall back to: the type is reported, but not valid */
+	connection_mock_set_error("vconf_get_int", -1);
+	TEST_CHECK(connection_get_all_statistics(&statistics) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(!statistics.cellular.is_valid);
+	TEST_CHECK(statistics.cellular.total_received == 0);
+	TEST_CHECK(statistics.wifi.is_valid);
+	connection_mock_set_error("vconf_get_int", 0);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_socket(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	struct sockaddr_in address;
+	socklen_t length;
+	char interface_name[IF_NAMESIZE];
+	int socket_fd = -1;
+	int i;
+
+	/* The loopback interface stands in for the interface of the profile */
+	TEST_CHECK(connection_mock_run_command("reset") == NET_ERR_NONE);
+	TEST_CHECK(connection_mock_run_command("profile ethernet /ethernet/lo lo online 127.0.0.1") == NET_ERR_NONE);
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_get_current_profile(connection, &profile) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_profile_create_socket(profile, CONNECTION_ADDRESS_FAMILY_IPV4,
+			SOCK_DGRAM, 0, NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_profile_bind_socket(profile, -1) == CONNECTION_ERROR_INVALID_PARAMETER);
+
+	for (i = 0; i < 2; i++) {
+		TEST_CHECK(connection_profile_create_socket(profile, CONNECTION_ADDRESS_FAMILY_IPV4,
+				SOCK_DGRAM, 0, &socket_fd) == CONNECTION_ERROR_NONE);
+
+		length = sizeof(address);
+		TEST_CHECK(getsockname(socket_fd, (struct sockaddr *)&address, &length) == 0);
+		TEST_CHECK(address.sin_addr.s_addr == htonl(INADDR_LOOPBACK));
+
+		length = sizeof(interface_name);
+		TEST_CHECK(getsockopt(socket_fd, SOL_SOCKET, SO_BINDTODEVICE, interface_name, &length) == 0);
+		TEST_CHECK(strcmp(interface_name, "lo") == 0);
+		close(socket_fd);
+	}
+
+	/* A socket of the application keeps its own address */
+	socket_fd = socket(AF_INET6, SOCK_STREAM, 0);
+	TEST_CHECK(connection_profile_bind_socket(profile, socket_fd) == CONNECTION_ERROR_NONE);
+	length = sizeof(interface_name);
+	TEST_CHECK(getsockopt(socket_fd, SOL_SOCKET, SO_BINDTODEVICE, interface_name, &length) == 0);
+	TEST_CHECK(strcmp(interface_name, "lo") == 0);
+	close(socket_fd);
+
+	connection_profile_destroy(profile);
+
+	/* The interface of a profile may be gone */
+	TEST_CHECK(connection_mock_run_command("profile ethernet /ethernet/lo nosuch0 online 10.0.0.2") == NET_ERR_NONE);
+	TEST_CHECK(connection_get_current_profile(connection, &profile) == CONNECTION_ERROR_NONE);
+	socket_fd = 0;
+	TEST_CHECK(connection_profile_create_socket(profile, CONNECTION_ADDRESS_FAMILY_IPV4,
+			SOCK_DGRAM, 0, &socket_fd) == CONNECTION_ERROR_NO_CONNECTION);
+	TEST_CHECK(socket_fd == -1);
+	connection_profile_destroy(profile);
+
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+}
+
+static void test_script(void)
+{
+	char path[] = "/tmp/mock_test_XXXXXX";
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	char *name = NULL;
+	FILE *fp;
+	int fd;
+
+	fd = mkstemp(path);
+	TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+
+	fp = fdopen(fd, "w");
+	fprintf(fp, "# Ethernet only\n");
+	fprintf(fp, "reset\n");
+	fprintf(fp, "latency 1000\n");
+	fprintf(fp, "profile ethernet   /ethernet/eth0  eth0 online 10.0.0.2\n");
+	fclose(fp);
+
+	TEST_CHECK(connection_mock_load_script(path) == NET_ERR_NONE);
+	unlink(path);
+
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_get_current_profile(connection, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(profile && connection_profile_get_name(profile, &name) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(name && strcmp(name, "/ethernet/eth0") == 0);
+	g_free(name);
+	connection_profile_destroy(profile);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_mock_run_command("profile wifi missing_arguments") != NET_ERR_NONE);
+	TEST_CHECK(connection_mock_run_command("unknown command") != NET_ERR_NONE);
+}
+
+static void test_memory_usage(void)
+{
+	connection_h connection = NULL;
+	connection_profile_h profile = NULL;
+	connection_profile_iterator_h iterator = NULL;
+	connection_memory_usage_s before;
+	connection_memory_usage_s usage;
+
+	test_setup();
+
+	TEST_CHECK(connection_get_memory_usage(NULL) == CONNECTION_ERROR_INVALID_PARAMETER);
+	TEST_CHECK(connection_get_memory_usage(&before) == CONNECTION_ERROR_NONE);
+
+	TEST_CHECK(connection_create(&connection) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_get_current_profile(connection, &profile) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(connection_get_profile_iterator(connection, CONNECTION_ITERATOR_TYPE_REGISTERED,
+			&iterator) == CONNECTION_ERROR_NONE);
+
+	connection_get_memory_usage(&usage);
+	TEST_CHECK(usage.handles.count == before.handles.count + 1);
+	TEST_CHECK(usage.profiles.count == before.profiles.count + 1);
+	TEST_CHECK(usage.iterators.count == before.iterators.count + 1);
+	TEST_CHECK(usage.iterators.bytes - before.iterators.bytes > 5 * sizeof(net_profile_info_t));
+	TEST_CHECK(usage.total_bytes > before.total_bytes);
+	TEST_CHECK(usage.peak_bytes >= usage.total_bytes);
+	TEST_CHECK(connection_dump_live_handles() == CONNECTION_ERROR_NONE);
+
+	connection_destroy_profile_iterator(iterator);
+	connection_profile_destroy(profile);
+	TEST_CHECK(connection_destroy(connection) == CONNECTION_ERROR_NONE);
+
+	connection_get_memory_usage(&usage);
+	TEST_CHECK(usage.handles.count == before.handles.count);
+	TEST_CHECK(usage.profiles.count == before.profiles.count);
+	TEST_CHECK(usage.iterators.count == before.iterators.count);
+	TEST_CHECK(usage.total_bytes == before.total_bytes);
+	TEST_CHECK(usage.peak_bytes > usage.total_bytes);
+
+	TEST_CHECK(connection_reset_memory_peak() == CONNECTION_ERROR_NONE);
+	connection_get_memory_usage(&usage);
+	TEST_CHECK(usage.peak_bytes == usage.total_bytes);
+}
+
+int main(int argc, char **argv)
+{
+	test_create_destroy();
+	test_type();
+	test_iterator();
+	test_profile_ref();
+	test_profile_clone();
+	test_profile_changes();
+	test_open_close();
+	test_ethernet_state();
+	test_warm_start();
+	test_state_page();
+	test_snapshot();
+	test_proxy_endpoint();
+	test_dns_servers();
+	test_best_profile();
+	test_profile_lookup();
+	test_wifi_by_strength();
+	test_statistics_threshold();
+	test_rate_sampling();
+	test_all_statistics();
+	test_socket();
+	test_script();
+	test_memory_usage();
+
+	if (failures) {
+		printf("mock_test: %d check(s) failed\n", failures);
+		return 1;
+	}
+
+	printf("mock_test: all checks passed\n");
+	return 0;
+}
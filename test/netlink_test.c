@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <glib.h>
+#include "net_connection_private.h"
+
+#define TEST_TIMEOUT_MS 2000
+
+static int failures = 0;
+static int event_count = 0;
+static connection_netlink_interface_s last_interface;
+
+#define TEST_CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			printf("[FAIL] %s:%d: %s\n", __FILE__, __LINE__, #expr); \
+			failures++; \
+		} \
+	} while (0)
+
+/* Sends one request and waits for the kernel acknowledgement */
+static int test_rtnl_request(struct nlmsghdr *nlh)
+{
+	struct sockaddr_nl addr;
+	char buffer[4096];
+	struct nlmsghdr *reply = (struct nlmsghdr *)buffer;
+	int fd;
+	int rv = -1;
+
+	fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+	if (fd < 0)
+		return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.nl_family = AF_NETLINK;
+
+	nlh->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+
+	if (sendto(fd, nlh, nlh->nlmsg_len, 0, (struct sockaddr *)&addr, sizeof(addr)) > 0 &&
+	    recv(fd, buffer, sizeof(buffer), 0) > 0 && reply->nlmsg_type == NLMSG_ERROR)
+		rv = ((struct nlmsgerr *)NLMSG_DATA(reply))->error;
+
+	close(fd);
+	return rv;
+}
+
+static int test_set_link_up(const char *name)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct ifinfomsg ifi;
+	} request;
+
+	memset(&request, 0, sizeof(request));
+	request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+	request.nlh.nlmsg_type = RTM_NEWLINK;
+	request.ifi.ifi_family = AF_UNSPEC;
+	request.ifi.ifi_index = if_nametoindex(name);
+	request.ifi.ifi_flags = IFF_UP;
+	request.ifi.ifi_change = IFF_UP;
+
+	return test_rtnl_request(&request.nlh);
+}
+
+static int test_set_address(int type, const char *name, int family, const char *address, int prefix)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct ifaddrmsg ifa;
+		char attributes[64];
+	} request;
+	struct rtattr *rta;
+	int length = family == AF_INET ? 4 : 16;
+
+	memset(&request, 0, sizeof(request));
+	request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifaddrmsg));
+	request.nlh.nlmsg_type = type;
+	request.nlh.nlmsg_flags = type == RTM_NEWADDR ? NLM_F_CREATE | NLM_F_EXCL : 0;
+	request.ifa.ifa_family = family;
+	request.ifa.ifa_prefixlen = prefix;
+	request.ifa.ifa_scope = RT_SCOPE_UNIVERSE;
+	request.ifa.ifa_index = if_nametoindex(name);
+
+	rta = (struct rtattr *)((char *)&request + NLMSG_ALIGN(request.nlh.nlmsg_len));
+	rta->rta_type = IFA_LOCAL;
+	rta->rta_len = RTA_LENGTH(length);
+	inet_pton(family, address, RTA_DATA(rta));
+	request.nlh.nlmsg_len = NLMSG_ALIGN(request.nlh.nlmsg_len) + rta->rta_len;
+
+	return test_rtnl_request(&request.nlh);
+}
+
+static void test_monitor_cb(connection_netlink_event_e event, const connection_netlink_interface_s *interface)
+{
+	if (strcmp(interface->name, "lo") != 0)
+		return;
+
+	memcpy(&last_interface, interface, sizeof(connection_netlink_interface_s));
+	event_count++;
+}
+
+/* Runs the main loop until the interface reports the expected addresses */
+static bool test_wait_for(const char *ipv4_address, const char *ipv6_address)
+{
+	gint64 deadline = g_get_monotonic_time() + TEST_TIMEOUT_MS * 1000;
+
+	while (g_get_monotonic_time() < deadline) {
+		if (event_count > 0 &&
+		    strcmp(last_interface.ipv4_address, ipv4_address) == 0 &&
+		    strcmp(last_interface.ipv6_address, ipv6_address) == 0)
+			return true;
+
+		if (!g_main_context_iteration(NULL, FALSE))
+			usleep(1000);
+	}
+
+	return false;
+}
+
+static void test_dispatch_pending(void)
+{
+	while (g_main_context_iteration(NULL, FALSE))
+		;
+}
+
+static void test_address_events(void)
+{
+	connection_netlink_interface_s interface;
+
+	TEST_CHECK(_connection_netlink_monitor_start(test_monitor_cb) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(_connection_netlink_monitor_start(test_monitor_cb) == CONNECTION_ERROR_INVALID_OPERATION);
+
+	/* The loopback addresses are host scoped and never reported */
+	TEST_CHECK(_connection_netlink_monitor_get_interface("lo", &interface));
+	TEST_CHECK(interface.flags & IFF_UP);
+	TEST_CHECK(interface.ipv4_address[0] == '\0');
+
+	TEST_CHECK(test_set_address(RTM_NEWADDR, "lo", AF_INET, "10.1.2.3", 8) == 0);
+	TEST_CHECK(test_wait_for("10.1.2.3", ""));
+
+	TEST_CHECK(test_set_address(RTM_NEWADDR, "lo", AF_INET6, "2001:db8::1", 128) == 0);
+	TEST_CHECK(test_wait_for("10.1.2.3", "2001:db8::1"));
+
+	/* Another address does not change the reported one until the first goes away */
+	TEST_CHECK(test_set_address(RTM_NEWADDR, "lo", AF_INET, "192.168.7.1", 24) == 0);
+	test_dispatch_pending();
+	TEST_CHECK(_connection_netlink_monitor_get_interface("lo", &interface));
+	TEST_CHECK(strcmp(interface.ipv4_address, "10.1.2.3") == 0);
+
+	TEST_CHECK(test_set_address(RTM_DELADDR, "lo", AF_INET, "10.1.2.3", 8) == 0);
+	TEST_CHECK(test_wait_for("192.168.7.1", "2001:db8::1"));
+
+	TEST_CHECK(test_set_address(RTM_DELADDR, "lo", AF_INET6, "2001:db8::1", 128) == 0);
+	TEST_CHECK(test_wait_for("192.168.7.1", ""));
+
+	TEST_CHECK(_connection_netlink_monitor_get_interface("lo", &interface));
+	TEST_CHECK(strcmp(interface.ipv4_address, "192.168.7.1") == 0);
+	TEST_CHECK(interface.ipv6_address[0] == '\0');
+
+	TEST_CHECK(_connection_netlink_monitor_stop(test_monitor_cb) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(_connection_netlink_monitor_stop(test_monitor_cb) == CONNECTION_ERROR_INVALID_OPERATION);
+	TEST_CHECK(!_connection_netlink_monitor_get_interface("lo", &interface));
+}
+
+int main(int argc, char **argv)
+{
+	/* A private network namespace keeps the test away from the host interfaces */
+	if (unshare(CLONE_NEWNET) < 0) {
+		printf("netlink_test: skipped, cannot create a network namespace\n");
+		return 0;
+	}
+
+	if (test_set_link_up("lo") != 0) {
+		printf("netlink_test: skipped, cannot configure the loopback interface\n");
+		return 0;
+	}
+
+	test_address_events();
+
+	if (failures) {
+		printf("netlink_test: %d check(s) failed\n", failures);
+		return 1;
+	}
+
+	printf("netlink_test: all checks passed\n");
+	return 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "net_connection_private.h"
+
+#define RX CONNECTION_STATISTICS_DIRECTION_RX
+#define TX CONNECTION_STATISTICS_DIRECTION_TX
+
+static int failures = 0;
+
+#define TEST_CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			printf("[FAIL] %s:%d: %s\n", __FILE__, __LINE__, #expr); \
+			failures++; \
+		} \
+	} while (0)
+
+static void test_accumulate(connection_statistics_counter_s *counter, unsigned int ifindex,
+		unsigned long long rx, unsigned long long tx, bool counters_32bit)
+{
+	unsigned long long counters[CONNECTION_STATISTICS_DIRECTION_MAX];
+
+	counters[RX] = rx;
+	counters[TX] = tx;
+
+	_connection_statistics_accumulate(counter, ifindex, counters, counters_32bit);
+}
+
+static void test_monotonic_counters(void)
+{
+	connection_statistics_counter_s counter;
+	memset(&counter, 0, sizeof(counter));
+
+	test_accumulate(&counter, 5, 1000, 100, false);
+	TEST_CHECK(counter.last[RX] == 1000 && counter.last[TX] == 100);
+	TEST_CHECK(counter.total[RX] == 1000 && counter.total[TX] == 100);
+
+	test_accumulate(&counter, 5, 3000, 250, false);
+	TEST_CHECK(counter.last[RX] == 3000 && counter.last[TX] == 250);
+	TEST_CHECK(counter.total[RX] == 3000 && counter.total[TX] == 250);
+}
+
+static void test_32bit_wraparound(void)
+{
+	connection_statistics_counter_s counter;
+	unsigned long long expected = 0xFFFFFF00ULL;
+	int i;
+
+	memset(&counter, 0, sizeof(counter));
+
+	test_accumulate(&counter, 7, 0xFFFFFF00ULL, 0, true);
+
+	/* 0xFFFFFF00 -> 0x100 is 0x200 bytes across the 4 GiB boundary */
+	test_accumulate(&counter, 7, 0x100ULL, 0, true);
+	expected += 0x200;
+	TEST_CHECK(counter.last[RX] == expected);
+	TEST_CHECK(counter.total[RX] == expected);
+
+	/* Keep wrapping: the totals must grow past several GiB without overflow */
+	for (i = 0; i < 4; i++) {
+		test_accumulate(&counter, 7, 0x80000100ULL, 0, true);
+		test_accumulate(&counter, 7, 0x100ULL, 0, true);
+		expected += 0x100000000ULL;
+	}
+
+	TEST_CHECK(counter.last[RX] == expected);
+	TEST_CHECK(counter.total[RX] == expected);
+	TEST_CHECK(counter.total[RX] > 0x400000000ULL);
+	TEST_CHECK(counter.total[TX] == 0);
+}
+
+static void test_64bit_reset(void)
+{
+	connection_statistics_counter_s counter;
+	memset(&counter, 0, sizeof(counter));
+
+	test_accumulate(&counter, 9, 0x200000000ULL, 10, false);
+
+	/* A 64-bit counter going backwards was reset, not wrapped */
+	test_accumulate(&counter, 9, 0x10ULL, 20, false);
+	TEST_CHECK(counter.total[RX] == 0x200000010ULL);
+	TEST_CHECK(counter.total[TX] == 20);
+}
+
+static void test_64bit_reset_below_4gib(void)
+{
+	connection_statistics_counter_s counter;
+	memset(&counter, 0, sizeof(counter));
+
+	test_accumulate(&counter, 9, 3000000, 40000, false);
+
+	/* A reset while the counter is low must not be taken for a 32-bit wrap */
+	test_accumulate(&counter, 9, 500, 60, false);
+	TEST_CHECK(counter.last[RX] == 3000500 && counter.last[TX] == 40060);
+	TEST_CHECK(counter.total[RX] == 3000500 && counter.total[TX] == 40060);
+}
+
+static void test_new_session(void)
+{
+	connection_statistics_counter_s counter;
+	memset(&counter, 0, sizeof(counter));
+
+	test_accumulate(&counter, 3, 5000, 500, false);
+
+	/* The interface came back with a new index: last restarts, total keeps growing */
+	test_accumulate(&counter, 4, 700, 70, false);
+	TEST_CHECK(counter.last[RX] == 700 && counter.last[TX] == 70);
+	TEST_CHECK(counter.total[RX] == 5700 && counter.total[TX] == 570);
+}
+
+/* Sends @a count datagrams of 1 KiB to ourselves over the loopback interface */
+static void test_send_loopback(int count)
+{
+	struct sockaddr_in address;
+	socklen_t length = sizeof(address);
+	char buffer[1024];
+	int fd;
+	int i;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	TEST_CHECK(bind(fd, (struct sockaddr *)&address, sizeof(address)) == 0);
+	TEST_CHECK(getsockname(fd, (struct sockaddr *)&address, &length) == 0);
+
+	memset(buffer, 0, sizeof(buffer));
+	for (i = 0; i < count; i++) {
+		TEST_CHECK(sendto(fd, buffer, sizeof(buffer), 0,
+				(struct sockaddr *)&address, sizeof(address)) == sizeof(buffer));
+		TEST_CHECK(recv(fd, buffer, sizeof(buffer), 0) == sizeof(buffer));
+	}
+
+	close(fd);
+}
+
+static void test_new_connection_same_interface(void)
+{
+	unsigned long long last = 0;
+	unsigned long long total = 0;
+	unsigned long long size = 0;
+
+	/* The loopback interface stands in for a modem interface kept across connections */
+	_connection_statistics_start_session(NET_DEVICE_ETHERNET, "lo");
+	test_send_loopback(64);
+
+	TEST_CHECK(_connection_statistics_get(NET_DEVICE_ETHERNET,
+			CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA, &last) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(_connection_statistics_get(NET_DEVICE_ETHERNET,
+			CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA, &total) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(last >= 64 * 1024);
+	TEST_CHECK(total >= last);
+
+	/* The next connection restarts the last data, the total goes on */
+	_connection_statistics_start_session(NET_DEVICE_ETHERNET, "lo");
+
+	TEST_CHECK(_connection_statistics_get(NET_DEVICE_ETHERNET,
+			CONNECTION_STATISTICS_TYPE_LAST_RECEIVED_DATA, &size) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(size < 64 * 1024);
+	TEST_CHECK(_connection_statistics_get(NET_DEVICE_ETHERNET,
+			CONNECTION_STATISTICS_TYPE_TOTAL_RECEIVED_DATA, &size) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(size >= total);
+}
+
+static void test_read_counters(void)
+{
+	unsigned long long counters[CONNECTION_STATISTICS_DIRECTION_MAX] = {0, 0};
+	char path[] = "/tmp/statistics_test_XXXXXX";
+	FILE *fp;
+	int fd;
+
+	fd = mkstemp(path);
+	TEST_CHECK(fd >= 0);
+	if (fd < 0)
+		return;
+
+	fp = fdopen(fd, "w");
+	fprintf(fp, "Inter-|   Receive                                                |  Transmit\n");
+	fprintf(fp, " face |bytes    packets errs drop fifo frame compressed multicast|"
+			"bytes    packets errs drop fifo colls carrier compressed\n");
+	fprintf(fp, "    lo:    1234      10    0    0    0     0          0         0"
+			"     1234      10    0    0    0     0       0          0\n");
+	fprintf(fp, "  pdp0:8589934592 6000000    0    0    0     0          0         0"
+			" 4294967296 3000000    0    0    0     0       0          0\n");
+	fclose(fp);
+
+	TEST_CHECK(_connection_statistics_read_counters(path, "pdp0", counters) == CONNECTION_ERROR_NONE);
+	TEST_CHECK(counters[RX] == 8589934592ULL);
+	TEST_CHECK(counters[TX] == 4294967296ULL);
+
+	TEST_CHECK(_connection_statistics_read_counters(path, "wlan0", counters) != CONNECTION_ERROR_NONE);
+
+	unlink(path);
+}
+
+static void test_read_links(void)
+{
+	const char *interface_names[2] = {"lo", "statistics_none0"};
+	unsigned long long counters[2][CONNECTION_STATISTICS_DIRECTION_MAX];
+	unsigned int ifindex[2];
+	bool counters_32bit[2];
+
+	/* The loopback interface exists on every host */
+	TEST_CHECK(_connection_statistics_read_links(2, interface_names, ifindex, counters, counters_32bit) == 1);
+	TEST_CHECK(ifindex[0] > 0);
+	TEST_CHECK(ifindex[1] == 0);
+}
+
+int main(int argc, char **argv)
+{
+	test_monotonic_counters();
+	test_32bit_wraparound();
+	test_64bit_reset();
+	test_64bit_reset_below_4gib();
+	test_new_session();
+	test_read_counters();
+	test_read_links();
+	test_new_connection_same_interface();
+
+	if (failures) {
+		printf("statistics_test: %d check(s) failed\n", failures);
+		return 1;
+	}
+
+	printf("statistics_test: all checks passed\n");
+	return 0;
+}